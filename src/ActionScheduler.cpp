@@ -0,0 +1,284 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "ActionScheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "Instrumentation.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+using Action = ActionScheduler::Action;
+using Event = ActionScheduler::Event;
+using Outcome = ActionScheduler::Outcome;
+
+enum class ActionState {
+  Pending,
+  Running,
+  // Timed out or cancelled, and reported as such, but still running; it
+  // keeps its resources, and its dependents wait, until it returns
+  Abandoned,
+  // Including timed out or cancelled
+  Finished,
+};
+
+struct RunState {
+  RunState(std::vector<Action> actions, ActionScheduler::Callback callback)
+    : mActions(std::move(actions)),
+      mCallback(std::move(callback)),
+      mStates(mActions.size(), ActionState::Pending),
+      mDeadlines(mActions.size()),
+      mStopSources(mActions.size()),
+      mResults(mActions.size()) {}
+
+  const std::vector<Action> mActions;
+  const ActionScheduler::Callback mCallback;
+
+  // Callbacks are invoked with this held, so that events for an action are
+  // always delivered in order
+  std::mutex mMutex;
+  std::condition_variable_any mChanged;
+  // Incremented whenever an action finishes, or releases its resources
+  std::uint64_t mGeneration {};
+
+  std::vector<ActionState> mStates;
+  // Only set while running with a timeout
+  std::vector<std::optional<Clock::time_point>> mDeadlines;
+  std::vector<std::stop_source> mStopSources;
+  std::vector<ActionScheduler::Result> mResults;
+  // Actions with a result, including abandoned ones
+  std::size_t mFinishedCount {};
+  ActionScheduler::ResourceSet mResourcesInUse;
+
+  // Caller must hold `mMutex` for all of these
+
+  std::optional<std::size_t> FindReady() const {
+    for (std::size_t i = 0; i < mActions.size(); ++i) {
+      if (mStates[i] != ActionState::Pending) {
+        continue;
+      }
+      const auto& action = mActions[i];
+      if ((action.mResources & mResourcesInUse).any()) {
+        continue;
+      }
+      if (std::ranges::all_of(action.mDependencies, [&](const auto dep) {
+            return mStates[dep] == ActionState::Finished;
+          })) {
+        return i;
+      }
+    }
+    return std::nullopt;
+  }
+
+  void Report(const std::size_t index, const Event event) const {
+    if (mCallback) {
+      mCallback(index, event);
+    }
+  }
+
+  void Start(const std::size_t index) {
+    const auto& action = mActions[index];
+    mStates[index] = ActionState::Running;
+    mResourcesInUse |= action.mResources;
+    if (action.mTimeout > std::chrono::milliseconds::zero()) {
+      mDeadlines[index] = Clock::now() + action.mTimeout;
+    }
+    Report(index, Event::Started);
+  }
+
+  void Release(const std::size_t index) {
+    mResourcesInUse &= ~mActions[index].mResources;
+    ++mGeneration;
+    mChanged.notify_all();
+  }
+
+  // Records the result; `Run()` is done once every action has one
+  void Finish(
+    const std::size_t index,
+    const ActionState state,
+    ActionScheduler::Result result) {
+    mStates[index] = state;
+    mDeadlines[index].reset();
+    mResults[index] = std::move(result);
+    ++mFinishedCount;
+    ++mGeneration;
+    mChanged.notify_all();
+  }
+
+  // Stop an action that's pending or running, without waiting for it
+  void Abandon(const std::size_t index, const Outcome outcome) {
+    if (mStates[index] == ActionState::Running) {
+      mStopSources[index].request_stop();
+      Finish(index, ActionState::Abandoned, {.mOutcome = outcome});
+    } else {
+      Finish(index, ActionState::Finished, {.mOutcome = outcome});
+    }
+    Report(
+      index, outcome == Outcome::TimedOut ? Event::TimedOut : Event::Cancelled);
+  }
+
+  // Called without the lock held, on whichever thread finished the action
+  void Complete(const std::size_t index, const std::exception_ptr error) {
+    std::unique_lock lock(mMutex);
+    // Already reported as timed out or cancelled
+    if (mStates[index] == ActionState::Abandoned) {
+      mStates[index] = ActionState::Finished;
+      Release(index);
+      return;
+    }
+    if (mStates[index] != ActionState::Running) {
+      return;
+    }
+    if (error) {
+      Finish(
+        index,
+        ActionState::Finished,
+        {.mOutcome = Outcome::Failed, .mError = error});
+    } else {
+      Finish(index, ActionState::Finished, {.mOutcome = Outcome::Succeeded});
+    }
+    Release(index);
+    Report(index, Event::Finished);
+  }
+};
+
+bool HasCycle(const std::vector<ActionScheduler::Action>& actions) {
+  // Kahn's algorithm: if we can't order every action, there's a cycle
+  std::vector<std::size_t> unfinishedDependencies(actions.size());
+  std::vector<std::vector<std::size_t>> dependents(actions.size());
+  for (std::size_t i = 0; i < actions.size(); ++i) {
+    unfinishedDependencies[i] = actions[i].mDependencies.size();
+    for (auto&& dependency: actions[i].mDependencies) {
+      dependents[dependency].push_back(i);
+    }
+  }
+
+  std::vector<std::size_t> ready;
+  for (std::size_t i = 0; i < actions.size(); ++i) {
+    if (unfinishedDependencies[i] == 0) {
+      ready.push_back(i);
+    }
+  }
+  std::size_t ordered = 0;
+  while (!ready.empty()) {
+    const auto it = ready.back();
+    ready.pop_back();
+    ++ordered;
+    for (auto&& dependent: dependents[it]) {
+      if (--unfinishedDependencies[dependent] == 0) {
+        ready.push_back(dependent);
+      }
+    }
+  }
+  return ordered != actions.size();
+}
+}// namespace
+
+ActionScheduler::ActionScheduler(std::vector<Action> actions)
+  : mActions(std::move(actions)) {
+  for (std::size_t i = 0; i < mActions.size(); ++i) {
+    for (auto&& dependency: mActions[i].mDependencies) {
+      if (dependency >= mActions.size() || dependency == i) {
+        throw std::invalid_argument("Invalid action dependency");
+      }
+    }
+  }
+  if (HasCycle(mActions)) {
+    throw std::invalid_argument("Action dependencies contain a cycle");
+  }
+}
+
+ActionScheduler::ResourceSet ActionScheduler::MakeResourceSet(
+  std::span<const ExecutionResource> resources) {
+  ResourceSet ret;
+  for (auto&& it: resources) {
+    ret.set(std::to_underlying(it));
+  }
+  return ret;
+}
+
+std::vector<ActionScheduler::Result> ActionScheduler::Run(
+  const Callback& callback,
+  std::stop_token stopToken) {
+  const Instrumentation::ScopedTimer timer {"Actions", "ActionScheduler"};
+
+  // Shared with the actions, as they may finish after this returns if they
+  // timed out or were cancelled
+  const auto state = std::make_shared<RunState>(mActions, callback);
+
+  bool cancelled = false;
+  std::unique_lock lock(state->mMutex);
+  while (true) {
+    if (stopToken.stop_requested() && !cancelled) {
+      cancelled = true;
+      for (std::size_t i = 0; i < mActions.size(); ++i) {
+        const auto actionState = state->mStates[i];
+        if (
+          actionState == ActionState::Pending
+          || actionState == ActionState::Running) {
+          state->Abandon(i, Outcome::Cancelled);
+        }
+      }
+    }
+
+    const auto now = Clock::now();
+    std::optional<Clock::time_point> nextDeadline;
+    for (std::size_t i = 0; i < mActions.size(); ++i) {
+      const auto deadline = state->mDeadlines[i];
+      if (!deadline) {
+        continue;
+      }
+      if (*deadline <= now) {
+        state->Abandon(i, Outcome::TimedOut);
+        continue;
+      }
+      if (!nextDeadline || *deadline < *nextDeadline) {
+        nextDeadline = deadline;
+      }
+    }
+
+    if (const auto next = state->FindReady()) {
+      const auto index = *next;
+      state->Start(index);
+      const auto token = state->mStopSources[index].get_token();
+      // Actions may finish synchronously, which takes the lock
+      lock.unlock();
+      try {
+        // Via `state`, which outlives abandoned actions
+        StartTask(
+          state->mActions[index].mRun(token),
+          [state, index](const std::exception_ptr error) {
+            state->Complete(index, error);
+          });
+      } catch (...) {
+        state->Complete(index, std::current_exception());
+      }
+      lock.lock();
+      continue;
+    }
+
+    if (state->mFinishedCount == mActions.size()) {
+      break;
+    }
+
+    const auto generation = state->mGeneration;
+    const auto isChanged = [&] { return state->mGeneration != generation; };
+    if (cancelled) {
+      state->mChanged.wait(lock, isChanged);
+    } else if (nextDeadline) {
+      state->mChanged.wait_until(lock, stopToken, *nextDeadline, isChanged);
+    } else {
+      state->mChanged.wait(lock, stopToken, isChanged);
+    }
+  }
+  return state->mResults;
+}
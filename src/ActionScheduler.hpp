@@ -0,0 +1,100 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <bitset>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <span>
+#include <stop_token>
+#include <string_view>
+#include <vector>
+
+#include "Task.hpp"
+
+// Something that only one action can use at a time
+enum class ExecutionResource {
+  // Windows Installer only allows one installation at a time
+  WindowsInstaller,
+};
+
+// Runs cleanup actions concurrently, respecting their dependencies and
+// exclusive resources.
+//
+// Actions are coroutines, and every action that's ready is started at once;
+// they're expected to await native asynchronous operations, or move
+// blocking work to a `ThreadPool`, so no threads are dedicated to waiting.
+// When more than one action is ready, the earliest in the list is started
+// first.
+//
+// Cancellation is cooperative: each action is given a `std::stop_token`,
+// which is stopped if the action times out or the whole run is cancelled.
+// Timed out and cancelled actions are reported as such straight away, but
+// keep their resources, and their dependents don't start, until they
+// actually return.
+class ActionScheduler {
+ public:
+  using ResourceSet = std::bitset<8>;
+
+  struct Action {
+    std::string_view mName;
+    std::function<Task<>(std::stop_token)> mRun;
+    // Indices of actions that must finish before this one starts
+    std::vector<std::size_t> mDependencies;
+    ResourceSet mResources;
+    // Zero for no limit
+    std::chrono::milliseconds mTimeout {};
+  };
+
+  enum class Event {
+    Started,
+    Finished,
+    TimedOut,
+    // Either stopped while running, or never started
+    Cancelled,
+  };
+  // Invoked on whichever thread started, finished, or stopped the action.
+  // Callbacks are serialized by an internal lock, so must not block for
+  // long, and never run concurrently.
+  using Callback = std::function<void(std::size_t index, Event)>;
+
+  enum class Outcome {
+    Succeeded,
+    Failed,
+    TimedOut,
+    Cancelled,
+  };
+  struct Result {
+    Outcome mOutcome {Outcome::Succeeded};
+    // Only set for `Outcome::Failed`
+    std::exception_ptr mError;
+  };
+
+  ActionScheduler() = delete;
+  // Throws `std::invalid_argument` if dependencies are out of range or
+  // cyclic
+  explicit ActionScheduler(std::vector<Action> actions);
+
+  // Blocks until every action has finished, timed out, or been cancelled.
+  //
+  // Actions that throw or time out are still considered finished, so
+  // dependents still run, once the action returns; if `stopToken` is
+  // stopped, running actions are stopped, and no more are started. The
+  // returned results are indexed by action.
+  //
+  // Actions are started on the calling thread. Timed out or cancelled
+  // actions that haven't returned are left to finish in the background,
+  // unless something is waiting for them; they will not invoke the callback
+  // again.
+  std::vector<Result> Run(
+    const Callback& callback = {},
+    std::stop_token stopToken = {});
+
+  [[nodiscard]] static ResourceSet MakeResourceSet(
+    std::span<const ExecutionResource>);
+
+ private:
+  std::vector<Action> mActions;
+};
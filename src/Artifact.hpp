@@ -2,10 +2,17 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <filesystem>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include "Plan.hpp"
 #include "Version.hpp"
 
+class RepairableArtifact;
+
 class Artifact {
  public:
   enum class Kind {
@@ -14,24 +21,70 @@ class Artifact {
     Logs,
     TemporaryFiles,
   };
+  // Known without constructing the artifact; see ArtifactRegistry.hpp
+  struct Metadata {
+    std::string_view mTitle;
+    Kind mKind {};
+    Version mEarliestVersion;
+    std::optional<Version> mRemovedVersion;
+  };
+  // What's shown when the user asks for more information; drawn by the UI,
+  // so artifacts don't depend on it
+  struct Details {
+    // Paragraphs explaining what this is
+    std::vector<std::string_view> mExplanation;
+    // e.g. "Found in C:\..."; may be empty
+    std::string mSummary;
+    // Shown as a bulleted list
+    std::vector<std::string> mItems;
+  };
   virtual ~Artifact() = default;
 
   [[nodiscard]] virtual bool IsPresent() const = 0;
-  virtual void Remove() = 0;
+  // The concrete changes that remove this artifact, as it currently is.
+  //
+  // This should only look at what was found during discovery; nothing is
+  // changed until the resulting `Plan` is applied. Operations that remove
+  // files should include an estimate when it's cheap to find.
+  [[nodiscard]] virtual std::vector<PlannedOperation> PlanRemoval() const = 0;
+  // Files or folders that make up this artifact, for measuring its size; see
+  // `DiskUsageCache`
+  [[nodiscard]] virtual std::vector<std::filesystem::path>
+  GetDiskUsageRoots() const {
+    return {};
+  }
+
+  [[nodiscard]] virtual const Metadata& GetMetadata() const = 0;
+  [[nodiscard]] virtual Details GetDetails() const = 0;
 
-  [[nodiscard]] virtual std::string_view GetTitle() const = 0;
-  virtual void DrawCardContent() const = 0;
+  // nullptr if not repairable; lets callers skip `dynamic_cast`
+  [[nodiscard]] virtual RepairableArtifact* GetRepairable() {
+    return nullptr;
+  }
 
-  [[nodiscard]] virtual Kind GetKind() const = 0;
-  [[nodiscard]] virtual Version GetEarliestVersion() const = 0;
-  [[nodiscard]] virtual std::optional<Version> GetRemovedVersion() const = 0;
+  [[nodiscard]] std::string_view GetTitle() const {
+    return GetMetadata().mTitle;
+  }
+  [[nodiscard]] Kind GetKind() const {
+    return GetMetadata().mKind;
+  }
+  [[nodiscard]] Version GetEarliestVersion() const {
+    return GetMetadata().mEarliestVersion;
+  }
+  [[nodiscard]] std::optional<Version> GetRemovedVersion() const {
+    return GetMetadata().mRemovedVersion;
+  }
 };
 
 class RepairableArtifact : public virtual Artifact {
  public:
   ~RepairableArtifact() override = default;
+  [[nodiscard]] RepairableArtifact* GetRepairable() final {
+    return this;
+  }
   virtual bool CanRepair() const {
     return true;
   }
-  virtual void Repair() = 0;
+  // See `PlanRemoval()`
+  [[nodiscard]] virtual std::vector<PlannedOperation> PlanRepair() const = 0;
 };
\ No newline at end of file
@@ -0,0 +1,149 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "ActionScheduler.hpp"
+#include "Artifact.hpp"
+#include "ChangeSource.hpp"
+
+// Everything we know about an artifact type without constructing it.
+//
+// The full list is `ArtifactRegistry`; this is separate so that code that is
+// given descriptors doesn't depend on every artifact type, as some are
+// Windows-only.
+struct ArtifactDescriptor {
+  Artifact::Metadata mMetadata;
+  // Instances may still decline with `CanRepair()`
+  bool mIsRepairable {false};
+  // How long discovery should wait before giving up
+  std::chrono::milliseconds mDeadline {};
+  // How long removing or repairing can take before it's stopped
+  std::chrono::milliseconds mActionTimeout {};
+  // If any of these change, the artifact should be checked again
+  std::span<const ChangeSource> mChangeSources;
+  // Only one action can use each of these at a time
+  std::span<const ExecutionResource> mExclusiveResources;
+  // Titles of artifacts whose actions must finish before this one's start
+  std::span<const std::string_view> mRunsAfter;
+  std::unique_ptr<Artifact> (*mCreate)() {nullptr};
+};
+
+namespace ArtifactRegistryDetail {
+using namespace std::chrono_literals;
+
+// Installer enumeration can be very slow on some machines, but everything
+// else should be near-instant
+constexpr std::chrono::milliseconds InstallerDeadline {30s};
+constexpr std::chrono::milliseconds DefaultDeadline {10s};
+// Artifacts can declare their own `ActionTimeout`; this is generous for
+// deleting a large folder in place
+constexpr std::chrono::milliseconds DefaultActionTimeout {10min};
+
+template <std::derived_from<Artifact> T>
+std::unique_ptr<Artifact> Create() {
+  return std::make_unique<T>();
+}
+
+template <class T>
+constexpr std::array LocationChangeSources {
+  ChangeSource::Folder(T::Location),
+};
+
+template <std::derived_from<Artifact> T>
+constexpr ArtifactDescriptor Describe(
+  std::chrono::milliseconds deadline = DefaultDeadline) {
+  ArtifactDescriptor ret {
+    .mMetadata = T::StaticMetadata,
+    .mIsRepairable = std::derived_from<T, RepairableArtifact>,
+    .mDeadline = deadline,
+    .mActionTimeout = DefaultActionTimeout,
+    .mCreate = &Create<T>,
+  };
+  if constexpr (requires { T::ChangeSources; }) {
+    ret.mChangeSources = T::ChangeSources;
+  } else if constexpr (requires { T::Location; }) {
+    ret.mChangeSources = LocationChangeSources<T>;
+  }
+  if constexpr (requires { T::ExclusiveResources; }) {
+    ret.mExclusiveResources = T::ExclusiveResources;
+  }
+  if constexpr (requires { T::RunsAfter; }) {
+    ret.mRunsAfter = T::RunsAfter;
+  }
+  if constexpr (requires { T::ActionTimeout; }) {
+    ret.mActionTimeout = T::ActionTimeout;
+  }
+  return ret;
+}
+
+consteval std::size_t FindByTitle(
+  std::span<const ArtifactDescriptor> registry,
+  std::string_view title) {
+  return std::ranges::find(registry, title, [](const auto& it) {
+           return it.mMetadata.mTitle;
+         })
+    - registry.begin();
+}
+
+// Returns false if `mRunsAfter` refers to unknown artifacts, or has cycles
+consteval bool IsValidOrdering(std::span<const ArtifactDescriptor> registry) {
+  // `state`: 0 = unvisited, 1 = on the current path, 2 = done
+  std::vector<int> state(registry.size(), 0);
+  // Iterative DFS; each frame is (node, next dependency to check)
+  std::vector<std::pair<std::size_t, std::size_t>> stack;
+  for (std::size_t root = 0; root < registry.size(); ++root) {
+    if (state[root] != 0) {
+      continue;
+    }
+    stack.push_back({root, 0});
+    state[root] = 1;
+    while (!stack.empty()) {
+      auto& [node, next] = stack.back();
+      const auto& runsAfter = registry[node].mRunsAfter;
+      if (next == runsAfter.size()) {
+        state[node] = 2;
+        stack.pop_back();
+        continue;
+      }
+      const auto dependency = FindByTitle(registry, runsAfter[next++]);
+      if (dependency == registry.size() || state[dependency] == 1) {
+        return false;
+      }
+      if (state[dependency] == 0) {
+        state[dependency] = 1;
+        stack.push_back({dependency, 0});
+      }
+    }
+  }
+  return true;
+}
+
+consteval bool IsValid(std::span<const ArtifactDescriptor> registry) {
+  for (auto it = registry.begin(); it != registry.end(); ++it) {
+    const auto& metadata = it->mMetadata;
+    if (
+      metadata.mTitle.empty() || !it->mCreate || it->mChangeSources.empty()) {
+      return false;
+    }
+    if (metadata.mRemovedVersion == metadata.mEarliestVersion) {
+      return false;
+    }
+    // Titles are used to identify probes and rows
+    if (std::ranges::any_of(it + 1, registry.end(), [&](const auto& other) {
+          return other.mMetadata.mTitle == metadata.mTitle;
+        })) {
+      return false;
+    }
+  }
+  return IsValidOrdering(registry);
+}
+}// namespace ArtifactRegistryDetail
@@ -0,0 +1,50 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <array>
+
+#include "ArtifactDescriptor.hpp"
+#include "artifacts/BackupsFolder.hpp"
+#include "artifacts/DCSHooks.hpp"
+#include "artifacts/HKCULayer.hpp"
+#include "artifacts/HKLMLayer.hpp"
+#include "artifacts/LocalAppDataSettings.hpp"
+#include "artifacts/LogsFolder.hpp"
+#include "artifacts/MSIInstallation.hpp"
+#include "artifacts/MSIXInstallation.hpp"
+#include "artifacts/MultipleMSIInstallations.hpp"
+#include "artifacts/ProgramData.hpp"
+#include "artifacts/SavedGamesSettings.hpp"
+#include "artifacts/TemporaryFilesFolder.hpp"
+
+// Every artifact type, in display order
+inline constexpr std::array ArtifactRegistry {
+  ArtifactRegistryDetail::Describe<MSIXInstallation>(
+    ArtifactRegistryDetail::InstallerDeadline),
+  ArtifactRegistryDetail::Describe<ProgramData>(),
+  ArtifactRegistryDetail::Describe<HKCULayer>(),
+  ArtifactRegistryDetail::Describe<MultipleMSIInstallations>(
+    ArtifactRegistryDetail::InstallerDeadline),
+  ArtifactRegistryDetail::Describe<MSIInstallation>(
+    ArtifactRegistryDetail::InstallerDeadline),
+  ArtifactRegistryDetail::Describe<HKLMLayer>(),
+  ArtifactRegistryDetail::Describe<DCSHooks>(),
+  ArtifactRegistryDetail::Describe<SavedGamesSettings>(),
+  ArtifactRegistryDetail::Describe<LocalAppDataSettings>(),
+  ArtifactRegistryDetail::Describe<LogsFolder>(),
+  ArtifactRegistryDetail::Describe<BackupsFolder>(),
+  ArtifactRegistryDetail::Describe<TemporaryFilesFolder>(),
+};
+static_assert(ArtifactRegistryDetail::IsValid(ArtifactRegistry));
+
+// Every folder that artifacts are found in; looked up up-front, and checked
+// for leftovers from an earlier run
+inline constexpr std::array FilesystemLocations {
+  ProgramData::Location,
+  SavedGamesSettings::Location,
+  LocalAppDataSettings::Location,
+  LogsFolder::Location,
+  BackupsFolder::Location,
+  TemporaryFilesFolder::Location,
+};
@@ -0,0 +1,713 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "BackupArchive.hpp"
+
+#include <zstd.h>
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "DurableFile.hpp"
+#include "MappedFile.hpp"
+
+namespace {
+// Format, all inside one zstd frame:
+//
+// - `Magic`, then the version as a varint
+// - the root count, then each root's full path
+// - entries, each starting with its kind; folders and files are then
+//   followed by their root index and their path relative to the root (empty
+//   for the root itself), then files by their size and contents
+// - `EntryKind::End`
+//
+// Integers are unsigned LEB128 varints; strings are a varint byte count,
+// followed by UTF-8. Relative paths use `/` as the separator.
+constexpr std::array Magic {
+  std::byte {'O'},
+  std::byte {'K'},
+  std::byte {'B'},
+  std::byte {'B'},
+  std::byte {'A'},
+  std::byte {'C'},
+  std::byte {'K'},
+  std::byte {'\n'},
+};
+constexpr std::uint64_t FormatVersion = 1;
+
+enum class EntryKind : std::uint8_t {
+  End,
+  Folder,
+  File,
+};
+
+// Read into memory by the read-ahead threads; larger files are mapped
+constexpr std::size_t SmallFileSize = 256 * 1024;
+// How many files can be read ahead of the compressor; with `SmallFileSize`,
+// this limits read-ahead buffers to 16MB
+constexpr std::size_t ReadAheadCount = 64;
+// Larger files are mapped and compressed this much at a time
+constexpr std::size_t MappedWindowSize = 64 * 1024 * 1024;
+// Small writes are collected before compressing, as each call to zstd has
+// some overhead
+constexpr std::size_t StagingSize = 128 * 1024;
+// Longer strings are rejected when restoring; much longer than any path
+constexpr std::size_t MaxStringSize = 64 * 1024;
+
+std::string ToUTF8(const std::u8string& value) {
+  return {value.begin(), value.end()};
+}
+
+std::filesystem::path FromUTF8(const std::string_view value) {
+  return std::filesystem::path {std::u8string {value.begin(), value.end()}};
+}
+
+[[noreturn]] void ThrowIOError(
+  const std::string& what,
+  const std::filesystem::path& path) {
+  throw std::filesystem::filesystem_error(
+    what, path, std::make_error_code(std::errc::io_error));
+}
+
+struct Entry {
+  EntryKind mKind {};
+  std::uint64_t mRoot {};
+  std::filesystem::path mPath;
+  std::filesystem::path mRelativePath;
+};
+
+// Throws if anything can't be listed, as the backup would be incomplete
+std::vector<Entry> ListEntries(std::span<const std::filesystem::path> roots) {
+  namespace fs = std::filesystem;
+  std::vector<Entry> ret;
+  for (std::size_t i = 0; i < roots.size(); ++i) {
+    const auto& root = roots[i];
+    const auto type = fs::symlink_status(root).type();
+    if (type == fs::file_type::regular) {
+      ret.push_back({EntryKind::File, i, root, {}});
+      continue;
+    }
+    if (type != fs::file_type::directory) {
+      continue;
+    }
+    ret.push_back({EntryKind::Folder, i, root, {}});
+    for (auto it = fs::recursive_directory_iterator {root};
+         it != fs::recursive_directory_iterator {};
+         ++it) {
+      const auto entryType = it->symlink_status().type();
+      EntryKind kind {};
+      if (entryType == fs::file_type::directory) {
+        kind = EntryKind::Folder;
+      } else if (entryType == fs::file_type::regular) {
+        kind = EntryKind::File;
+      } else {
+        // Links, junctions, and anything else that isn't ours to copy
+        it.disable_recursion_pending();
+        continue;
+      }
+      ret.push_back({kind, i, it->path(), it->path().lexically_relative(root)});
+    }
+  }
+  return ret;
+}
+
+struct LoadedFile {
+  std::error_code mError;
+  std::uint64_t mSize {};
+  // For small files
+  std::vector<std::byte> mData;
+  // For larger files, with the first window already mapped and prefetched
+  std::optional<MappedFile> mFile;
+  MappedFile::View mFirstView;
+};
+
+LoadedFile Load(const std::filesystem::path& path) {
+  LoadedFile ret;
+  auto file = MappedFile::Open(path, ret.mError);
+  if (!file) {
+    return ret;
+  }
+  ret.mSize = file->GetSize();
+  if (ret.mSize <= SmallFileSize) {
+    ret.mData.resize(static_cast<std::size_t>(ret.mSize));
+    ret.mData.resize(file->Read(0, ret.mData, ret.mError));
+    ret.mSize = ret.mData.size();
+    return ret;
+  }
+  ret.mFirstView = file->Map(
+    0,
+    static_cast<std::size_t>(std::min<std::uint64_t>(ret.mSize, MappedWindowSize)),
+    ret.mError);
+  ret.mFirstView.Prefetch();
+  ret.mFile = std::move(file);
+  return ret;
+}
+
+// Loads files on several threads, but hands them out in order
+class ReadAhead {
+ public:
+  ReadAhead(
+    std::span<const Entry> entries,
+    const std::size_t threadCount,
+    const std::stop_token stopToken)
+    : mEntries(entries),
+      mForwardStop(stopToken, [this] { mStop.request_stop(); }) {
+    for (std::size_t i = 0; i < std::max<std::size_t>(threadCount, 1); ++i) {
+      mThreads.emplace_back([this] { Run(); });
+    }
+  }
+
+  ~ReadAhead() {
+    mStop.request_stop();
+  }
+
+  // Must be called for each index in turn; nullopt if stopped
+  std::optional<LoadedFile> Take(const std::size_t index) {
+    std::unique_lock lock(mMutex);
+    auto& slot = mSlots.at(index % mSlots.size());
+    if (!mCV.wait(
+          lock, mStop.get_token(), [&slot] { return slot.has_value(); })) {
+      return std::nullopt;
+    }
+    auto ret = std::exchange(slot, std::nullopt);
+    ++mTaken;
+    lock.unlock();
+    mCV.notify_all();
+    return ret;
+  }
+
+ private:
+  std::span<const Entry> mEntries;
+  std::stop_source mStop;
+  std::stop_callback<std::function<void()>> mForwardStop;
+
+  std::mutex mMutex;
+  std::condition_variable_any mCV;
+  // Next index to load
+  std::size_t mNext {0};
+  // Indices before this have been taken
+  std::size_t mTaken {0};
+  std::array<std::optional<LoadedFile>, ReadAheadCount> mSlots;
+
+  // Last, so that they're joined before anything else is destroyed
+  std::vector<std::jthread> mThreads;
+
+  void Run() {
+    const auto stopToken = mStop.get_token();
+    while (true) {
+      std::size_t index {};
+      {
+        std::unique_lock lock(mMutex);
+        if (!mCV.wait(lock, stopToken, [this] {
+              return mNext >= mEntries.size()
+                || mNext < mTaken + mSlots.size();
+            })) {
+          return;
+        }
+        if (mNext >= mEntries.size()) {
+          return;
+        }
+        index = mNext++;
+      }
+
+      const auto& entry = mEntries[index];
+      auto loaded = (entry.mKind == EntryKind::File) ? Load(entry.mPath)
+                                                      : LoadedFile {};
+      {
+        std::unique_lock lock(mMutex);
+        mSlots.at(index % mSlots.size()) = std::move(loaded);
+      }
+      mCV.notify_all();
+    }
+  }
+};
+
+class Compressor {
+ public:
+  Compressor(
+    const std::filesystem::path& path,
+    const BackupArchive::Options& options)
+    : mFile(DurableFile::Create(path)),
+      mContext(ZSTD_createCCtx(), &ZSTD_freeCCtx),
+      mOutput(ZSTD_CStreamOutSize()) {
+    if (!mContext) {
+      throw std::bad_alloc();
+    }
+    mStaging.reserve(StagingSize);
+    ZSTD_CCtx_setParameter(
+      mContext.get(), ZSTD_c_compressionLevel, options.mCompressionLevel);
+    ZSTD_CCtx_setParameter(mContext.get(), ZSTD_c_checksumFlag, 1);
+    // Fails if zstd was built without threading; that's fine, it's just
+    // slower
+    ZSTD_CCtx_setParameter(
+      mContext.get(),
+      ZSTD_c_nbWorkers,
+      static_cast<int>(std::max<std::size_t>(options.mThreadCount, 1)));
+  }
+
+  // Larger writes are compressed straight from `data`
+  void Write(std::span<const std::byte> data) {
+    if (mStaging.size() + data.size() <= StagingSize) {
+      mStaging.insert(mStaging.end(), data.begin(), data.end());
+      return;
+    }
+    Flush();
+    if (data.size() < StagingSize) {
+      mStaging.insert(mStaging.end(), data.begin(), data.end());
+      return;
+    }
+    Compress(data, ZSTD_e_continue);
+  }
+
+  void WriteInteger(std::uint64_t value) {
+    std::array<std::byte, 10> buffer {};
+    std::size_t size = 0;
+    do {
+      auto byte = static_cast<std::uint8_t>(value & 0x7f);
+      value >>= 7;
+      if (value) {
+        byte |= 0x80;
+      }
+      buffer[size++] = std::byte {byte};
+    } while (value);
+    Write(std::span {buffer}.first(size));
+  }
+
+  void WriteString(const std::string_view value) {
+    WriteInteger(value.size());
+    Write(std::as_bytes(std::span {value}));
+  }
+
+  // Waits until the archive has reached the disk, then closes it
+  void Finish() {
+    Compress(mStaging, ZSTD_e_end);
+    mStaging.clear();
+    mFile->Flush();
+    mFile.reset();
+  }
+
+ private:
+  std::optional<DurableFile> mFile;
+  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> mContext;
+  std::vector<std::byte> mStaging;
+  std::vector<std::byte> mOutput;
+
+  void Flush() {
+    if (!mStaging.empty()) {
+      Compress(mStaging, ZSTD_e_continue);
+      mStaging.clear();
+    }
+  }
+
+  void Compress(std::span<const std::byte> data, ZSTD_EndDirective mode) {
+    ZSTD_inBuffer input {data.data(), data.size(), 0};
+    while (true) {
+      ZSTD_outBuffer output {mOutput.data(), mOutput.size(), 0};
+      const auto remaining
+        = ZSTD_compressStream2(mContext.get(), &output, &input, mode);
+      if (ZSTD_isError(remaining)) {
+        throw std::runtime_error(
+          std::format("Compression failed: {}", ZSTD_getErrorName(remaining)));
+      }
+      mFile->Write(std::span {mOutput}.first(output.pos));
+      const auto done = (mode == ZSTD_e_end) ? (remaining == 0)
+                                             : (input.pos == input.size);
+      if (done) {
+        return;
+      }
+    }
+  }
+};
+
+class Decompressor {
+ public:
+  explicit Decompressor(const std::filesystem::path& path)
+    : mFile(path, std::ios::binary),
+      mContext(ZSTD_createDCtx(), &ZSTD_freeDCtx),
+      mInput(ZSTD_DStreamInSize()),
+      mOutput(ZSTD_DStreamOutSize()) {
+    if (!mFile) {
+      ThrowIOError("Failed to open backup", path);
+    }
+    if (!mContext) {
+      throw std::bad_alloc();
+    }
+  }
+
+  void Read(std::span<std::byte> buffer) {
+    while (!buffer.empty()) {
+      const auto available = Fill();
+      const auto count = std::min(available.size(), buffer.size());
+      std::ranges::copy(available.first(count), buffer.begin());
+      mOutputPosition += count;
+      buffer = buffer.subspan(count);
+    }
+  }
+
+  std::uint64_t ReadInteger() {
+    std::uint64_t ret = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      std::byte byte {};
+      Read({&byte, 1});
+      const auto value = std::to_integer<std::uint8_t>(byte);
+      ret |= static_cast<std::uint64_t>(value & 0x7f) << shift;
+      if (!(value & 0x80)) {
+        return ret;
+      }
+    }
+    throw std::runtime_error("Backup contains an invalid integer");
+  }
+
+  std::string ReadString() {
+    const auto size = ReadInteger();
+    if (size > MaxStringSize) {
+      throw std::runtime_error("Backup contains an invalid string");
+    }
+    std::string ret(static_cast<std::size_t>(size), '\0');
+    Read(std::as_writable_bytes(std::span {ret}));
+    return ret;
+  }
+
+  // Without holding the whole file in memory
+  void CopyTo(
+    std::ofstream& out,
+    std::uint64_t size,
+    const std::filesystem::path& path) {
+    while (size > 0) {
+      const auto available = Fill();
+      const auto count = static_cast<std::size_t>(
+        std::min<std::uint64_t>(available.size(), size));
+      out.write(
+        reinterpret_cast<const char*>(available.data()),
+        static_cast<std::streamsize>(count));
+      if (!out) {
+        ThrowIOError("Failed to restore file", path);
+      }
+      mOutputPosition += count;
+      size -= count;
+    }
+  }
+
+  // Like `CopyTo()`, but only checks the data
+  void Skip(std::uint64_t size) {
+    while (size > 0) {
+      const auto available = Fill();
+      const auto count = static_cast<std::size_t>(
+        std::min<std::uint64_t>(available.size(), size));
+      mOutputPosition += count;
+      size -= count;
+    }
+  }
+
+  // Checks that the zstd frame - and its checksum - is complete, and that
+  // there's nothing after it
+  void Finish() {
+    if (mOutputPosition != mOutputSize) {
+      throw std::runtime_error("Backup has trailing data");
+    }
+    while (mFrameRemaining != 0) {
+      if (!Decompress()) {
+        throw std::runtime_error("Backup is truncated");
+      }
+      if (mOutputSize != 0) {
+        throw std::runtime_error("Backup has trailing data");
+      }
+    }
+    if (mInputBuffer.pos != mInputBuffer.size || mFile.peek() != EOF) {
+      throw std::runtime_error("Backup has trailing data");
+    }
+  }
+
+ private:
+  std::ifstream mFile;
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> mContext;
+  std::vector<std::byte> mInput;
+  ZSTD_inBuffer mInputBuffer {nullptr, 0, 0};
+  std::vector<std::byte> mOutput;
+  std::size_t mOutputPosition {0};
+  std::size_t mOutputSize {0};
+  // Non-zero until the end of the frame has been decompressed
+  std::size_t mFrameRemaining {1};
+
+  // Decompressed data that hasn't been consumed yet; throws if there's none
+  std::span<const std::byte> Fill() {
+    while (mOutputPosition == mOutputSize) {
+      if (!Decompress()) {
+        throw std::runtime_error("Backup is truncated");
+      }
+    }
+    return std::span {mOutput}.subspan(
+      mOutputPosition, mOutputSize - mOutputPosition);
+  }
+
+  // Replaces the output buffer; returns false at the end of the file
+  bool Decompress() {
+    if (mInputBuffer.pos == mInputBuffer.size) {
+      mFile.read(
+        reinterpret_cast<char*>(mInput.data()),
+        static_cast<std::streamsize>(mInput.size()));
+      const auto count = static_cast<std::size_t>(mFile.gcount());
+      if (count == 0) {
+        return false;
+      }
+      mInputBuffer = {mInput.data(), count, 0};
+    }
+    ZSTD_outBuffer output {mOutput.data(), mOutput.size(), 0};
+    mFrameRemaining
+      = ZSTD_decompressStream(mContext.get(), &output, &mInputBuffer);
+    if (ZSTD_isError(mFrameRemaining)) {
+      throw std::runtime_error(std::format(
+        "Backup is corrupt: {}", ZSTD_getErrorName(mFrameRemaining)));
+    }
+    mOutputPosition = 0;
+    mOutputSize = output.pos;
+    return true;
+  }
+};
+
+// Returns the roots
+std::vector<std::filesystem::path> ReadHeader(Decompressor& in) {
+  std::array<std::byte, Magic.size()> magic {};
+  in.Read(magic);
+  if (magic != Magic) {
+    throw std::runtime_error("Not an OpenKneeboard backup");
+  }
+  if (const auto version = in.ReadInteger(); version != FormatVersion) {
+    throw std::runtime_error(
+      std::format("Unsupported backup version {}", version));
+  }
+
+  std::vector<std::filesystem::path> roots;
+  const auto rootCount = in.ReadInteger();
+  for (std::uint64_t i = 0; i < rootCount; ++i) {
+    auto root = FromUTF8(in.ReadString());
+    if (!root.is_absolute()) {
+      throw std::runtime_error("Backup contains a relative root");
+    }
+    roots.push_back(std::move(root));
+  }
+  return roots;
+}
+
+// Keeps corrupt or malicious archives from writing outside of the roots
+std::filesystem::path GetRestorePath(
+  const std::vector<std::filesystem::path>& roots,
+  const std::uint64_t root,
+  const std::string_view relativePath) {
+  if (root >= roots.size()) {
+    throw std::runtime_error("Backup contains an invalid root");
+  }
+  const auto relative = FromUTF8(relativePath);
+  if (relative.has_root_path()) {
+    throw std::runtime_error("Backup contains an absolute path");
+  }
+  for (auto&& component: relative) {
+    if (component == "..") {
+      throw std::runtime_error("Backup contains a path outside of its roots");
+    }
+  }
+  if (relative.empty()) {
+    return roots.at(root);
+  }
+  return roots.at(root) / relative;
+}
+
+// Calls `onFolder(path)` for each folder, and `onFile(path, size)` for each
+// file, which must read or skip its contents; returns false if stopped
+// before the end
+template <class OnFolder, class OnFile>
+bool ReadEntries(
+  Decompressor& in,
+  const std::vector<std::filesystem::path>& roots,
+  const std::stop_token& stopToken,
+  OnFolder&& onFolder,
+  OnFile&& onFile) {
+  while (!stopToken.stop_requested()) {
+    const auto kind = in.ReadInteger();
+    if (kind == std::to_underlying(EntryKind::End)) {
+      in.Finish();
+      return true;
+    }
+    if (
+      kind != std::to_underlying(EntryKind::Folder)
+      && kind != std::to_underlying(EntryKind::File)) {
+      throw std::runtime_error("Backup contains an invalid entry");
+    }
+    const auto root = in.ReadInteger();
+    const auto path = GetRestorePath(roots, root, in.ReadString());
+    if (kind == std::to_underlying(EntryKind::Folder)) {
+      onFolder(path);
+    } else {
+      onFile(path, in.ReadInteger());
+    }
+  }
+  return false;
+}
+}// namespace
+
+BackupArchive::BackupArchive(const Options& options) : mOptions(options) {}
+
+bool BackupArchive::Create(
+  const std::filesystem::path& archive,
+  std::span<const std::filesystem::path> roots,
+  Progress* progress) const {
+  const auto partial = std::filesystem::path {archive} += L".partial";
+  try {
+    const auto entries = ListEntries(roots);
+
+    Compressor out {partial, mOptions};
+    out.Write(Magic);
+    out.WriteInteger(FormatVersion);
+    out.WriteInteger(roots.size());
+    for (auto&& root: roots) {
+      out.WriteString(ToUTF8(root.u8string()));
+    }
+
+    const auto& stopToken = mOptions.mStopToken;
+    ReadAhead readAhead {entries, mOptions.mThreadCount, stopToken};
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      const auto& entry = entries[i];
+      auto loaded = readAhead.Take(i);
+      if (!loaded) {
+        break;
+      }
+
+      out.WriteInteger(std::to_underlying(entry.mKind));
+      out.WriteInteger(entry.mRoot);
+      out.WriteString(ToUTF8(entry.mRelativePath.generic_u8string()));
+      if (entry.mKind == EntryKind::Folder) {
+        if (progress) {
+          progress->Add({.mFiles = 1});
+        }
+        continue;
+      }
+
+      if (loaded->mError) {
+        throw std::filesystem::filesystem_error(
+          "Failed to read file for backup", entry.mPath, loaded->mError);
+      }
+      out.WriteInteger(loaded->mSize);
+      if (!loaded->mFile) {
+        out.Write(loaded->mData);
+        if (progress) {
+          progress->Add({.mBytes = loaded->mSize, .mFiles = 1});
+        }
+        continue;
+      }
+
+      // Map the next window while compressing this one, so that reading
+      // and compressing overlap
+      auto view = std::move(loaded->mFirstView);
+      std::uint64_t offset = 0;
+      while (offset < loaded->mSize && !stopToken.stop_requested()) {
+        const auto nextOffset = offset + view.GetData().size();
+        MappedFile::View next;
+        if (nextOffset < loaded->mSize) {
+          std::error_code ec;
+          next = loaded->mFile->Map(
+            nextOffset,
+            static_cast<std::size_t>(std::min<std::uint64_t>(
+              loaded->mSize - nextOffset, MappedWindowSize)),
+            ec);
+          if (ec) {
+            throw std::filesystem::filesystem_error(
+              "Failed to read file for backup", entry.mPath, ec);
+          }
+          next.Prefetch();
+        }
+        out.Write(view.GetData());
+        if (progress) {
+          progress->Add({.mBytes = view.GetData().size()});
+        }
+        view = std::move(next);
+        offset = nextOffset;
+      }
+      if (progress) {
+        progress->Add({.mFiles = 1});
+      }
+    }
+
+    if (stopToken.stop_requested()) {
+      std::error_code ec;
+      std::filesystem::remove(partial, ec);
+      return false;
+    }
+    out.WriteInteger(std::to_underlying(EntryKind::End));
+    out.Finish();
+    // Only complete archives ever have the real name, even after a crash
+    DurableFile::Rename(partial, archive);
+    return true;
+  } catch (...) {
+    std::error_code ec;
+    std::filesystem::remove(partial, ec);
+    throw;
+  }
+}
+
+void BackupArchive::Restore(
+  const std::filesystem::path& archive,
+  Progress* progress) const {
+  const auto& stopToken = mOptions.mStopToken;
+  // The checksum is at the end, so read everything once before writing
+  // anything; this is much quicker than the writes
+  {
+    Decompressor in {archive};
+    const auto roots = ReadHeader(in);
+    const auto complete = ReadEntries(
+      in,
+      roots,
+      stopToken,
+      [](const auto&) {},
+      [&in](const auto&, const auto size) { in.Skip(size); });
+    if (!complete) {
+      return;
+    }
+  }
+
+  Decompressor in {archive};
+  const auto roots = ReadHeader(in);
+  ReadEntries(
+    in,
+    roots,
+    stopToken,
+    [progress](const std::filesystem::path& path) {
+      std::filesystem::create_directories(path);
+      if (progress) {
+        progress->Add({.mFiles = 1});
+      }
+    },
+    [&in, progress](
+      const std::filesystem::path& path, const std::uint64_t size) {
+      std::filesystem::create_directories(path.parent_path());
+      std::ofstream out {path, std::ios::binary | std::ios::trunc};
+      if (!out) {
+        ThrowIOError("Failed to restore file", path);
+      }
+      in.CopyTo(out, size, path);
+      out.close();
+      if (!out) {
+        ThrowIOError("Failed to restore file", path);
+      }
+      if (progress) {
+        progress->Add({.mBytes = size, .mFiles = 1});
+      }
+    });
+}
+
+std::vector<std::filesystem::path> BackupArchive::GetRoots(
+  const std::filesystem::path& archive) {
+  Decompressor in {archive};
+  return ReadHeader(in);
+}
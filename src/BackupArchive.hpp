@@ -0,0 +1,72 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "Progress.hpp"
+
+// Copies folders into a single compressed file before they are deleted, so
+// that they can be restored later.
+//
+// The archive is one zstd stream, written as files are read, so memory use
+// doesn't depend on how much is being backed up:
+//
+// - several threads read small files ahead, into a fixed number of buffers
+// - larger files are mapped, and compressed straight from the OS cache
+// - zstd compresses with several worker threads
+//
+// Links and junctions are skipped, not followed.
+class BackupArchive {
+ public:
+  struct Options {
+    // Also used for reading ahead
+    std::size_t mThreadCount {std::thread::hardware_concurrency()};
+    // zstd's default; higher levels are much slower, for little gain on
+    // settings files
+    int mCompressionLevel {3};
+    // If stopped, `Create()` removes the partial archive, and returns false;
+    // `Restore()` returns, leaving anything not yet restored
+    std::stop_token mStopToken;
+  };
+
+  BackupArchive() = default;
+  explicit BackupArchive(const Options& options);
+
+  // Roots that don't exist are skipped. The archive is written next to
+  // `archive`, then renamed into place when complete; both the contents and
+  // the rename have reached the disk before this returns true.
+  //
+  // If `progress` is provided, each archived file and folder is added to it.
+  //
+  // Throws `std::filesystem::filesystem_error` if anything can't be read or
+  // written, or `std::runtime_error` if compression fails; in either case,
+  // nothing is left behind.
+  [[nodiscard]] bool Create(
+    const std::filesystem::path& archive,
+    std::span<const std::filesystem::path> roots,
+    Progress* progress = nullptr) const;
+
+  // Puts everything back where it was, replacing any files that are already
+  // there. The whole archive is checked first, so nothing is written if it's
+  // truncated or corrupt.
+  //
+  // Throws `std::runtime_error` if the archive is corrupt or unsafe, e.g. it
+  // contains paths outside of its roots, or
+  // `std::filesystem::filesystem_error` if anything can't be written.
+  void Restore(
+    const std::filesystem::path& archive,
+    Progress* progress = nullptr) const;
+
+  // The folders that `Restore()` would write to
+  [[nodiscard]] static std::vector<std::filesystem::path> GetRoots(
+    const std::filesystem::path& archive);
+
+ private:
+  Options mOptions;
+};
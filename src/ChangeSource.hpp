@@ -0,0 +1,45 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <string_view>
+
+#include "KnownFolders.hpp"
+
+enum class RegistryHive {
+  CurrentUser,
+  LocalMachine,
+};
+
+// Somewhere an artifact type keeps its state; if this changes, the artifact
+// should be checked again.
+struct ChangeSource {
+  enum class Kind {
+    Folder,
+    RegistryKey,
+  };
+
+  Kind mKind {};
+  KnownFolder mFolder {};
+  RegistryHive mHive {};
+  // Child of `mFolder`, or a registry subkey; for folders, empty means the
+  // whole folder tree.
+  std::wstring_view mPath;
+
+  static constexpr ChangeSource Folder(
+    KnownFolder folder,
+    std::wstring_view child = {}) {
+    return {.mKind = Kind::Folder, .mFolder = folder, .mPath = child};
+  }
+
+  static constexpr ChangeSource Folder(
+    const KnownFolders::Location& location) {
+    return Folder(location.mRoot, location.mChild);
+  }
+
+  static constexpr ChangeSource RegistryKey(
+    RegistryHive hive,
+    std::wstring_view subKey) {
+    return {.mKind = Kind::RegistryKey, .mHive = hive, .mPath = subKey};
+  }
+};
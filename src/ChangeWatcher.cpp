@@ -0,0 +1,68 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "ChangeWatcher.hpp"
+
+#include <algorithm>
+#include <utility>
+
+ChangeWatcher::ChangeWatcher(
+  Callback callback,
+  std::chrono::milliseconds quietPeriod)
+  : mCallback(std::move(callback)),
+    mQuietPeriod(quietPeriod) {
+  mDebounceThread = std::jthread {&ChangeWatcher::DebounceThread, this};
+}
+
+ChangeWatcher::~ChangeWatcher() {
+  StopDebouncing();
+}
+
+void ChangeWatcher::StopDebouncing() {
+  {
+    std::unique_lock lock(mMutex);
+    mStopping = true;
+    mChanged.notify_all();
+  }
+  if (mDebounceThread.joinable()) {
+    mDebounceThread.join();
+  }
+}
+
+void ChangeWatcher::Notify(Tag tag) {
+  std::unique_lock lock(mMutex);
+  mPending.push_back(tag);
+  mLastChange = std::chrono::steady_clock::now();
+  mChanged.notify_all();
+}
+
+void ChangeWatcher::DebounceThread() {
+  std::unique_lock lock(mMutex);
+  while (true) {
+    mChanged.wait(lock, [this] { return mStopping || !mPending.empty(); });
+    if (mStopping) {
+      return;
+    }
+
+    // Wait for things to settle down; every notification pushes this back
+    while (!mStopping) {
+      const auto quietUntil = mLastChange + mQuietPeriod;
+      if (std::chrono::steady_clock::now() >= quietUntil) {
+        break;
+      }
+      mChanged.wait_until(lock, quietUntil);
+    }
+    if (mStopping) {
+      return;
+    }
+
+    auto tags = std::exchange(mPending, {});
+    std::ranges::sort(tags);
+    const auto [first, last] = std::ranges::unique(tags);
+    tags.erase(first, last);
+
+    lock.unlock();
+    mCallback(std::move(tags));
+    lock.lock();
+  }
+}
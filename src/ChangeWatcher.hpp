@@ -0,0 +1,79 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "ChangeSource.hpp"
+
+// Watches folders and registry keys, and reports which tags have changed.
+//
+// Notifications are debounced: the callback is invoked once changes have
+// stopped for the quiet period, with every tag that changed, so a burst of
+// writes (e.g. an installer running) leads to one re-check per artifact.
+class ChangeWatcher {
+ public:
+  using Tag = std::size_t;
+  // Invoked on a background thread; tags are unique and sorted
+  using Callback = std::function<void(std::vector<Tag>)>;
+
+  static constexpr std::chrono::milliseconds DefaultQuietPeriod {500};
+
+  ChangeWatcher() = delete;
+  virtual ~ChangeWatcher();
+
+  ChangeWatcher(const ChangeWatcher&) = delete;
+  ChangeWatcher& operator=(const ChangeWatcher&) = delete;
+
+  // Uses the best implementation for the current platform
+  static std::unique_ptr<ChangeWatcher> Create(
+    Callback callback,
+    std::chrono::milliseconds quietPeriod = DefaultQuietPeriod);
+
+  // A folder doesn't need to exist; if it doesn't, this does nothing.
+  virtual void WatchFolder(
+    Tag tag,
+    const std::filesystem::path& path,
+    bool recursive)
+    = 0;
+  // Does nothing if the key doesn't exist, or on platforms without a registry
+  virtual void WatchRegistryKey(
+    Tag tag,
+    RegistryHive hive,
+    std::wstring_view subKey)
+    = 0;
+  // Removes every watch added for this tag
+  virtual void Unwatch(Tag tag) = 0;
+
+ protected:
+  ChangeWatcher(Callback callback, std::chrono::milliseconds quietPeriod);
+
+  // Thread-safe; called by implementations when a watch fires
+  void Notify(Tag tag);
+
+  // Implementations must call this at the start of their destructor, so
+  // that the callback isn't invoked while they are being destroyed.
+  void StopDebouncing();
+
+ private:
+  Callback mCallback;
+  std::chrono::milliseconds mQuietPeriod;
+
+  std::mutex mMutex;
+  std::condition_variable mChanged;
+  std::vector<Tag> mPending;
+  std::chrono::steady_clock::time_point mLastChange;
+  bool mStopping {false};
+
+  std::jthread mDebounceThread;
+
+  void DebounceThread();
+};
@@ -0,0 +1,129 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "DCSHooksScanner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <thread>
+#include <utility>
+
+#include "FileSystem.hpp"
+#include "Instrumentation.hpp"
+
+namespace {
+
+std::vector<DirectoryEntry> List(const std::filesystem::path& path) {
+  std::error_code ec;
+  return RetryIfInUse(
+    [&path](auto& error) {
+      return FileSystem::Get().ListDirectory(
+        path, error, ListingDetail::TypeOnly);
+    },
+    ec);
+}
+
+bool EqualsIgnoringASCIICase(std::wstring_view a, std::wstring_view b) {
+  const auto lower = [](wchar_t c) {
+    return (c >= L'A' && c <= L'Z') ? static_cast<wchar_t>(c - L'A' + L'a')
+                                    : c;
+  };
+  return std::ranges::equal(a, b, {}, lower, lower);
+}
+
+struct FolderResult {
+  std::vector<std::filesystem::path> mHooks;
+  std::chrono::steady_clock::duration mDuration {};
+};
+
+FolderResult ScanFolder(const std::filesystem::path& game) {
+  using namespace Instrumentation;
+  const auto started = std::chrono::steady_clock::now();
+
+  FolderResult ret;
+  // Skip a separate exists() check; failing to open is just as informative
+  auto entries = List(game / L"Scripts" / L"Hooks");
+  Increment(Counter::FilesVisited, entries.size());
+  for (auto&& it: entries) {
+    if (it.mPath.filename().wstring().starts_with(L"OpenKneeboard")) {
+      ret.mHooks.push_back(std::move(it.mPath));
+    }
+  }
+
+  ret.mDuration = std::chrono::steady_clock::now() - started;
+  return ret;
+}
+
+}// namespace
+
+DCSHooksScanner::DCSHooksScanner(const Options& options)
+  : mOptions(options) {}
+
+bool DCSHooksScanner::IsKnownNonDCSFolder(std::wstring_view name) {
+  constexpr std::wstring_view KnownFolders[] {
+    L"OpenKneeboard",
+    L"CD Projekt Red",
+    L"Frontier Developments",
+    L"Respawn",
+  };
+  return std::ranges::any_of(KnownFolders, [name](const auto it) {
+    return EqualsIgnoringASCIICase(it, name);
+  });
+}
+
+DCSHooksScanner::Result DCSHooksScanner::Scan(
+  const std::filesystem::path& savedGames) const {
+  using namespace Instrumentation;
+  const ScopedTimer timer {"Discovery", "DCSHooksScanner"};
+
+  // The types come from the listing, so this doesn't need to stat each
+  // entry. Links and junctions are candidates too, as some users move game
+  // folders to other drives; if they're links to files, they just fail to
+  // open as a folder.
+  std::vector<std::filesystem::path> candidates;
+  auto entries = List(savedGames);
+  Increment(Counter::FilesVisited, entries.size());
+  for (auto&& it: entries) {
+    if (!(it.mIsDirectory || it.mIsLink)) {
+      continue;
+    }
+    if (IsKnownNonDCSFolder(it.mPath.filename().wstring())) {
+      continue;
+    }
+    candidates.push_back(std::move(it.mPath));
+  }
+
+  std::vector<FolderResult> results(candidates.size());
+  std::atomic<std::size_t> next {0};
+  const auto worker = [&] {
+    for (auto i = next++; i < candidates.size(); i = next++) {
+      results[i] = ScanFolder(candidates[i]);
+    }
+  };
+
+  const auto threadCount = std::min(
+    std::max<std::size_t>(mOptions.mMaxConcurrency, 1), candidates.size());
+  if (threadCount <= 1) {
+    worker();
+  } else {
+    std::vector<std::jthread> threads;
+    threads.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+      threads.emplace_back(worker);
+    }
+  }
+
+  Result ret;
+  ret.mFolderTimings.reserve(candidates.size());
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    auto& result = results[i];
+    ret.mFolderTimings.push_back({
+      .mFolder = std::move(candidates[i]),
+      .mDuration = result.mDuration,
+      .mHookCount = result.mHooks.size(),
+    });
+    std::ranges::move(result.mHooks, std::back_inserter(ret.mHooks));
+  }
+  return ret;
+}
@@ -0,0 +1,44 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+// Finds OpenKneeboard's DCS hooks in every game folder under 'Saved Games'.
+//
+// Game folders are checked in parallel, as some users have dozens of them,
+// sometimes on slow or redirected storage.
+class DCSHooksScanner {
+ public:
+  struct Options {
+    std::size_t mMaxConcurrency {8};
+  };
+
+  struct FolderTiming {
+    std::filesystem::path mFolder;
+    std::chrono::steady_clock::duration mDuration {};
+    std::size_t mHookCount {};
+  };
+
+  struct Result {
+    // In directory iteration order
+    std::vector<std::filesystem::path> mHooks;
+    std::vector<FolderTiming> mFolderTimings;
+  };
+
+  DCSHooksScanner() = default;
+  explicit DCSHooksScanner(const Options& options);
+
+  [[nodiscard]] Result Scan(const std::filesystem::path& savedGames) const;
+
+  // Folders commonly found in 'Saved Games' which can not be DCS; DCS can be
+  // told to use any folder name, so this is an exclusion list rather than an
+  // allow list.
+  [[nodiscard]] static bool IsKnownNonDCSFolder(std::wstring_view name);
+
+ private:
+  Options mOptions;
+};
@@ -0,0 +1,172 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "Decisions.hpp"
+
+#include <chrono>
+#include <format>
+#include <string>
+#include <utility>
+
+#include "Instrumentation.hpp"
+#include "KnownFolders.hpp"
+
+namespace {
+// Unique per run, so earlier backups are never replaced
+std::filesystem::path GetBackupPath(const CleanupOptions& options) {
+  const std::chrono::zoned_time now {
+    std::chrono::current_zone(),
+    std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now())};
+  return GetBackupFolder(options)
+    / std::format(
+           L"OpenKneeboard settings backup {:%Y-%m-%d %H-%M-%S}.okbbackup",
+           now);
+}
+}// namespace
+
+ArtifactFlags GetArtifactFlags(Artifact& artifact) {
+  const auto repairable = artifact.GetRepairable();
+  ArtifactFlags ret {
+    .mIsUserSettings = artifact.GetKind() == Artifact::Kind::UserSettings,
+    .mIsOutdated = artifact.GetRemovedVersion().has_value(),
+    .mIsTemporaryFiles = artifact.GetKind() == Artifact::Kind::TemporaryFiles,
+    .mCanRepair = repairable && repairable->CanRepair(),
+  };
+  ret.mDefaultAction = GetDefaultAction(ret);
+  return ret;
+}
+
+Action GetDefaultAction(const ArtifactFlags& flags) {
+  if (flags.mIsUserSettings) {
+    return Action::Ignore;
+  }
+  if (flags.mCanRepair) {
+    return Action::Repair;
+  }
+  if (flags.mIsOutdated) {
+    return Action::Remove;
+  }
+  if (flags.mIsTemporaryFiles) {
+    return Action::Remove;
+  }
+  return Action::Ignore;
+}
+
+std::optional<Action> GetPlannedAction(
+  const ArtifactFlags& flags,
+  const CleanupOptions& options,
+  const Action selected) {
+  if (!flags.mIsPresent) {
+    return std::nullopt;
+  }
+
+  switch (options.mMode) {
+    case CleanupMode::Repair:
+      if (flags.mCanRepair) {
+        return Action::Repair;
+      }
+      if (flags.mIsOutdated && !flags.mIsUserSettings) {
+        return Action::Remove;
+      }
+      if (flags.mIsTemporaryFiles) {
+        return Action::Remove;
+      }
+      return std::nullopt;
+    case CleanupMode::RemoveAll:
+      if (options.mRemoveSettings || !flags.mIsUserSettings) {
+        return Action::Remove;
+      }
+      return std::nullopt;
+    case CleanupMode::Custom:
+      switch (selected) {
+        case Action::Ignore:
+          return std::nullopt;
+        case Action::Repair: {
+          if (flags.mCanRepair) {
+            return Action::Repair;
+          }
+          return std::nullopt;
+        }
+        case Action::Remove:
+          return Action::Remove;
+      }
+  }
+  std::unreachable();
+}
+
+std::vector<PlannedOperation> PlanAction(
+  Artifact& artifact,
+  const Action action) {
+  switch (action) {
+    case Action::Ignore:
+      return {};
+    case Action::Repair:
+      return artifact.GetRepairable()->PlanRepair();
+    case Action::Remove:
+      return artifact.PlanRemoval();
+  }
+  std::unreachable();
+}
+
+std::filesystem::path GetBackupFolder(const CleanupOptions& options) {
+  if (!options.mBackupFolder.empty()) {
+    return options.mBackupFolder;
+  }
+  return KnownFolders::Get().GetRoot(KnownFolder::Documents);
+}
+
+Plan BuildPlan(
+  std::span<const PlannedArtifact> artifacts,
+  const CleanupOptions& options) {
+  const Instrumentation::ScopedTimer timer {"Actions", "Plan"};
+  struct PlannedStep {
+    std::string mTitle;
+    Plan::Action mAction {};
+    std::vector<PlannedOperation> mOperations;
+  };
+  std::vector<PlannedStep> steps;
+  std::vector<std::filesystem::path> settings;
+  WorkAmount settingsSize;
+
+  for (auto&& artifact: artifacts) {
+    if (artifact.mAction == Action::Ignore) {
+      continue;
+    }
+    auto operations = PlanAction(*artifact.mArtifact, artifact.mAction);
+    if (
+      artifact.mKnownSize && operations.size() == 1
+      && operations.front().mKind == PlannedOperation::Kind::RemovePath
+      && operations.front().mEstimate == WorkAmount {}) {
+      operations.front().mEstimate = *artifact.mKnownSize;
+    }
+    if (artifact.mAction == Action::Remove && artifact.mIsUserSettings) {
+      for (auto&& it: operations) {
+        if (it.mKind == PlannedOperation::Kind::RemovePath) {
+          settings.push_back(it.mTarget);
+          settingsSize += it.mEstimate;
+        }
+      }
+    }
+    steps.push_back({
+      .mTitle = std::string {artifact.mArtifact->GetTitle()},
+      .mAction = (artifact.mAction == Action::Repair) ? Plan::Action::Repair
+                                                      : Plan::Action::Remove,
+      .mOperations = std::move(operations),
+    });
+  }
+
+  Plan::Builder builder;
+  // First, so it's shown first
+  if (options.mBackUpSettings && !settings.empty()) {
+    builder.AddStep(
+      std::string {BackupStepTitle},
+      Plan::Action::Backup,
+      {PlannedOperation::BackupPaths(
+        GetBackupPath(options), settings, settingsSize)});
+  }
+  for (auto&& it: steps) {
+    builder.AddStep(
+      std::move(it.mTitle), it.mAction, std::move(it.mOperations));
+  }
+  return std::move(builder).Build();
+}
@@ -0,0 +1,86 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "Artifact.hpp"
+#include "Plan.hpp"
+#include "Progress.hpp"
+
+// What to do with each artifact, and the resulting plan; shared by the GUI
+// and the headless mode, so nothing here looks at any UI state.
+
+enum class CleanupMode {
+  Repair,
+  RemoveAll,
+  Custom,
+};
+
+enum class Action {
+  Ignore,
+  Repair,
+  Remove,
+};
+
+struct CleanupOptions {
+  CleanupMode mMode {CleanupMode::Repair};
+  bool mRemoveSettings {false};
+  // Settings are copied into an archive before they're deleted; see
+  // `BackupArchive`
+  bool mBackUpSettings {true};
+  // Where backups are saved; empty for the user's Documents folder
+  std::filesystem::path mBackupFolder;
+};
+
+// Everything needed to decide what to do with an artifact; these all require
+// virtual calls or RTTI, so callers may want to cache them
+struct ArtifactFlags {
+  bool mIsPresent {false};
+  bool mIsUserSettings {false};
+  bool mIsOutdated {false};
+  bool mIsTemporaryFiles {false};
+  bool mCanRepair {false};
+  Action mDefaultAction {};
+};
+
+// Does not include presence, as `IsPresent()` can be slow
+[[nodiscard]] ArtifactFlags GetArtifactFlags(Artifact&);
+
+[[nodiscard]] Action GetDefaultAction(const ArtifactFlags&);
+
+// What will happen to an artifact with these options; `selected` is only
+// used by `CleanupMode::Custom`
+[[nodiscard]] std::optional<Action> GetPlannedAction(
+  const ArtifactFlags&,
+  const CleanupOptions&,
+  Action selected = Action::Ignore);
+
+// Empty if there's nothing to do
+[[nodiscard]] std::vector<PlannedOperation> PlanAction(Artifact&, Action);
+
+// The title of the step added by `BuildPlan()`, which isn't an artifact
+constexpr std::string_view BackupStepTitle = "Back up settings";
+
+[[nodiscard]] std::filesystem::path GetBackupFolder(const CleanupOptions&);
+
+struct PlannedArtifact {
+  Artifact* mArtifact {nullptr};
+  bool mIsUserSettings {false};
+  Action mAction {};
+  // Used as the estimate for removing a folder, as folders aren't measured
+  // while planning
+  std::optional<WorkAmount> mKnownSize;
+};
+
+// Steps are in the same order as `artifacts`, after the settings backup, if
+// any; settings removals wait for the backup, see `PlanRunner.hpp`.
+//
+// Nothing looks at the artifacts again once the plan is built.
+[[nodiscard]] Plan BuildPlan(
+  std::span<const PlannedArtifact> artifacts,
+  const CleanupOptions&);
@@ -0,0 +1,61 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <system_error>
+#include <vector>
+
+// Platform-specific directory listing, including the details that
+// `std::filesystem` doesn't expose: allocated size, and file identity for
+// hard links.
+//
+// Usually used via `FileSystem`, so that it can be replaced for testing.
+struct FileID {
+  std::uint64_t mVolume {};
+  std::uint64_t mFile {};
+
+  bool operator==(const FileID&) const noexcept = default;
+};
+
+template <>
+struct std::hash<FileID> {
+  std::size_t operator()(const FileID& id) const noexcept {
+    return std::hash<std::uint64_t> {}(id.mVolume * 31 + id.mFile);
+  }
+};
+
+struct DirectoryEntry {
+  std::filesystem::path mPath;
+  // False for links and junctions, even if they point to a folder
+  bool mIsDirectory {false};
+  // Symbolic links, junctions, and other reparse points
+  bool mIsLink {false};
+  // Space used on disk, which may differ from the file size, e.g. for
+  // compressed or sparse files. Zero for folders.
+  std::uint64_t mAllocatedBytes {};
+  // Logical size, e.g. for progress; zero for folders and links
+  std::uint64_t mSize {};
+  // Set if the file may have other hard links
+  std::optional<FileID> mHardLinkID;
+};
+
+enum class ListingDetail {
+  // Every field of `DirectoryEntry`; this may need a `stat()` per entry
+  Full,
+  // Only the path and type; usually available from the listing itself
+  TypeOnly,
+};
+
+// Contents of a folder, excluding `.` and `..`
+[[nodiscard]] std::vector<DirectoryEntry> ListDirectory(
+  const std::filesystem::path&,
+  std::error_code&,
+  ListingDetail = ListingDetail::Full);
+// Details of a single file or folder, without following links
+[[nodiscard]] DirectoryEntry GetDirectoryEntry(
+  const std::filesystem::path&,
+  std::error_code&);
@@ -0,0 +1,182 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "DiscoveryScheduler.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <ranges>
+#include <thread>
+#include <utility>
+
+#include "Instrumentation.hpp"
+
+struct DiscoveryScheduler::State {
+  using clock = std::chrono::steady_clock;
+
+  struct InFlight {
+    std::size_t mIndex {};
+    clock::time_point mStarted;
+    clock::time_point mDeadline;
+  };
+
+  std::vector<std::unique_ptr<ArtifactProbe>> mProbes;
+  std::function<void()> mOnResult;
+
+  mutable std::mutex mMutex;
+  mutable std::condition_variable mChanged;
+  std::size_t mNextProbe {};
+  std::vector<InFlight> mInFlight;
+  // Whether or not a result has been recorded; either a real result, or a
+  // timeout
+  std::vector<bool> mFinished;
+  std::size_t mFinishedCount {};
+  std::vector<Result> mResults;
+  bool mStopping {false};
+
+  [[nodiscard]] bool AllFinished() const {
+    return mFinishedCount == mProbes.size();
+  }
+
+  // Caller must hold mMutex
+  void Record(Result&& result) {
+    mFinished.at(result.mIndex) = true;
+    ++mFinishedCount;
+    mResults.push_back(std::move(result));
+    mChanged.notify_all();
+  }
+};
+
+DiscoveryScheduler::DiscoveryScheduler(
+  std::vector<std::unique_ptr<ArtifactProbe>> probes,
+  std::size_t workerCount,
+  std::function<void()> onResult)
+  : mState(std::make_shared<State>()) {
+  mState->mProbes = std::move(probes);
+  mState->mOnResult = std::move(onResult);
+  mState->mFinished.resize(mState->mProbes.size(), false);
+
+  if (mState->mProbes.empty()) {
+    return;
+  }
+
+  workerCount
+    = std::clamp<std::size_t>(workerCount, 1, mState->mProbes.size());
+  // Threads are detached: a probe that is stuck in a system call must not
+  // block exiting the process. They keep the state alive until they return.
+  for (std::size_t i = 0; i < workerCount; ++i) {
+    std::thread {&DiscoveryScheduler::Worker, mState}.detach();
+  }
+  std::thread {&DiscoveryScheduler::Watchdog, mState}.detach();
+}
+
+DiscoveryScheduler::~DiscoveryScheduler() {
+  std::unique_lock lock(mState->mMutex);
+  mState->mStopping = true;
+  mState->mChanged.notify_all();
+}
+
+std::vector<DiscoveryScheduler::Result> DiscoveryScheduler::TakeResults() {
+  std::unique_lock lock(mState->mMutex);
+  return std::exchange(mState->mResults, {});
+}
+
+bool DiscoveryScheduler::IsComplete() const {
+  std::unique_lock lock(mState->mMutex);
+  return mState->AllFinished() && mState->mResults.empty();
+}
+
+void DiscoveryScheduler::WaitForAll() const {
+  std::unique_lock lock(mState->mMutex);
+  mState->mChanged.wait(lock, [this] { return mState->AllFinished(); });
+}
+
+void DiscoveryScheduler::Worker(std::shared_ptr<State> state) {
+  std::unique_lock lock(state->mMutex);
+  while (!state->mStopping && state->mNextProbe < state->mProbes.size()) {
+    const auto index = state->mNextProbe++;
+    auto& probe = *state->mProbes.at(index);
+    const auto started = State::clock::now();
+    state->mInFlight.push_back({
+      .mIndex = index,
+      .mStarted = started,
+      .mDeadline = started + probe.GetDeadline(),
+    });
+    // Wake the watchdog so it can track the new deadline
+    state->mChanged.notify_all();
+    lock.unlock();
+
+    Result result {
+      .mIndex = index,
+      .mName = probe.GetName(),
+    };
+    try {
+      {
+        const Instrumentation::ScopedTimer timer {"Discovery", result.mName};
+        result.mArtifact = probe.Run();
+      }
+      const Instrumentation::ScopedTimer timer {"IsPresent", result.mName};
+      if (result.mArtifact && result.mArtifact->IsPresent()) {
+        result.mStatus = Status::Found;
+      } else {
+        result.mStatus = Status::NotFound;
+        result.mArtifact.reset();
+      }
+    } catch (...) {
+      result.mStatus = Status::Failed;
+      result.mArtifact.reset();
+    }
+    result.mDuration = State::clock::now() - started;
+
+    lock.lock();
+    std::erase_if(state->mInFlight, [index](const auto& it) {
+      return it.mIndex == index;
+    });
+    if (state->mFinished.at(index)) {
+      // We timed out, and the watchdog started a replacement worker
+      return;
+    }
+    state->Record(std::move(result));
+    if (state->mOnResult && !state->mStopping) {
+      lock.unlock();
+      state->mOnResult();
+      lock.lock();
+    }
+  }
+}
+
+void DiscoveryScheduler::Watchdog(std::shared_ptr<State> state) {
+  std::unique_lock lock(state->mMutex);
+  while (!(state->mStopping || state->AllFinished())) {
+    auto pending = state->mInFlight
+      | std::views::filter([&state](const auto& it) {
+                           return !state->mFinished.at(it.mIndex);
+                         });
+    if (pending.empty()) {
+      state->mChanged.wait(lock);
+      continue;
+    }
+
+    const auto next
+      = std::ranges::min(pending, {}, &State::InFlight::mDeadline);
+    const auto now = State::clock::now();
+    if (now < next.mDeadline) {
+      state->mChanged.wait_until(lock, next.mDeadline);
+      continue;
+    }
+
+    state->Record({
+      .mIndex = next.mIndex,
+      .mName = state->mProbes.at(next.mIndex)->GetName(),
+      .mStatus = Status::TimedOut,
+      .mDuration = now - next.mStarted,
+    });
+    std::thread {&DiscoveryScheduler::Worker, state}.detach();
+    if (state->mOnResult) {
+      lock.unlock();
+      state->mOnResult();
+      lock.lock();
+    }
+  }
+}
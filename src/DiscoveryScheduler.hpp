@@ -0,0 +1,66 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "Artifact.hpp"
+
+class ArtifactProbe {
+ public:
+  virtual ~ArtifactProbe() = default;
+
+  [[nodiscard]] virtual std::string_view GetName() const = 0;
+  [[nodiscard]] virtual std::chrono::milliseconds GetDeadline() const = 0;
+  [[nodiscard]] virtual std::unique_ptr<Artifact> Run() = 0;
+};
+
+// Runs artifact probes concurrently on a small worker pool.
+//
+// Results are queued as each probe finishes, and collected by the UI thread
+// with `TakeResults()`. If a probe exceeds its deadline, it is reported as
+// `TimedOut`, a replacement worker is started, and the late result is
+// discarded.
+class DiscoveryScheduler {
+ public:
+  enum class Status {
+    Found,
+    NotFound,
+    Failed,
+    TimedOut,
+  };
+
+  struct Result {
+    std::size_t mIndex {};
+    std::string_view mName;
+    Status mStatus {};
+    std::unique_ptr<Artifact> mArtifact;
+    std::chrono::steady_clock::duration mDuration {};
+  };
+
+  DiscoveryScheduler() = delete;
+  DiscoveryScheduler(
+    std::vector<std::unique_ptr<ArtifactProbe>> probes,
+    std::size_t workerCount,
+    std::function<void()> onResult);
+  ~DiscoveryScheduler();
+
+  DiscoveryScheduler(const DiscoveryScheduler&) = delete;
+  DiscoveryScheduler& operator=(const DiscoveryScheduler&) = delete;
+
+  [[nodiscard]] std::vector<Result> TakeResults();
+  // True once every probe has finished and every result has been taken
+  [[nodiscard]] bool IsComplete() const;
+  void WaitForAll() const;
+
+ private:
+  struct State;
+  std::shared_ptr<State> mState;
+
+  static void Worker(std::shared_ptr<State> state);
+  static void Watchdog(std::shared_ptr<State> state);
+};
@@ -0,0 +1,81 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "DiskUsageCache.hpp"
+
+DiskUsageCache::DiskUsageCache(std::function<void()> onUpdate)
+  : mOnUpdate(std::move(onUpdate)),
+    mThread(std::bind_front(&DiskUsageCache::Run, this)) {}
+
+DiskUsageCache::~DiskUsageCache() = default;
+
+std::optional<DiskUsage> DiskUsageCache::Get(const Artifact& artifact) {
+  std::unique_lock lock(mMutex);
+  if (const auto it = mEntries.find(&artifact); it != mEntries.end()) {
+    return it->second.mUsage;
+  }
+
+  const auto id = ++mNextID;
+  mEntries.emplace(&artifact, Entry {.mID = id});
+  auto roots = artifact.GetDiskUsageRoots();
+  if (!roots.empty()) {
+    mQueue.push_back({&artifact, id, std::move(roots)});
+    mChanged.notify_one();
+  }
+  return std::nullopt;
+}
+
+void DiskUsageCache::Forget(const Artifact& artifact) {
+  std::unique_lock lock(mMutex);
+  const auto it = mEntries.find(&artifact);
+  if (it == mEntries.end()) {
+    return;
+  }
+  if (mIsMeasuring && it->second.mID == mCurrentID) {
+    mCurrentStop.request_stop();
+  }
+  mEntries.erase(it);
+  std::erase_if(
+    mQueue, [&artifact](const Job& job) { return job.mArtifact == &artifact; });
+}
+
+bool DiskUsageCache::IsMeasuring() const {
+  std::unique_lock lock(mMutex);
+  return mIsMeasuring || !mQueue.empty();
+}
+
+void DiskUsageCache::Run(std::stop_token stop) {
+  std::unique_lock lock(mMutex);
+  while (mChanged.wait(lock, stop, [this] { return !mQueue.empty(); })) {
+    const auto job = std::move(mQueue.front());
+    mQueue.pop_front();
+    mIsMeasuring = true;
+    // Stopped by `Forget()`, or when we're shutting down
+    mCurrentID = job.mID;
+    mCurrentStop = {};
+    const std::stop_callback onStop {
+      stop, [jobStop = mCurrentStop] mutable { jobStop.request_stop(); }};
+    // Each scan is already parallel
+    const SizeScanner scanner {{.mStopToken = mCurrentStop.get_token()}};
+    lock.unlock();
+
+    const auto usage = scanner.Scan(job.mRoots);
+
+    lock.lock();
+    mIsMeasuring = false;
+    if (stop.stop_requested()) {
+      return;
+    }
+    // The artifact may have been forgotten, and the address reused
+    const auto it = mEntries.find(job.mArtifact);
+    if (it == mEntries.end() || it->second.mID != job.mID) {
+      continue;
+    }
+    it->second.mUsage = usage;
+    if (mOnUpdate) {
+      lock.unlock();
+      mOnUpdate();
+      lock.lock();
+    }
+  }
+}
@@ -0,0 +1,71 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Artifact.hpp"
+#include "SizeScanner.hpp"
+
+// Measures the disk usage of artifacts in the background, in the order they
+// were first asked for, and keeps the results for as long as the artifact
+// exists.
+class DiskUsageCache {
+ public:
+  DiskUsageCache() = delete;
+  // `onUpdate` is invoked on a background thread when a result is ready
+  explicit DiskUsageCache(std::function<void()> onUpdate);
+  ~DiskUsageCache();
+
+  DiskUsageCache(const DiskUsageCache&) = delete;
+  DiskUsageCache& operator=(const DiskUsageCache&) = delete;
+
+  // `nullopt` while the artifact is still being measured, or if it doesn't
+  // use any disk space of its own; the first call queues the measurement
+  [[nodiscard]] std::optional<DiskUsage> Get(const Artifact&);
+  // Must be called before the artifact is destroyed; stops measuring it if
+  // that's already started
+  void Forget(const Artifact&);
+
+  // True if any requested measurements haven't finished
+  [[nodiscard]] bool IsMeasuring() const;
+
+ private:
+  struct Entry {
+    std::uint64_t mID {};
+    std::optional<DiskUsage> mUsage;
+  };
+  // Doesn't refer to the artifact, as it may be destroyed while measuring
+  struct Job {
+    const Artifact* mArtifact {nullptr};
+    std::uint64_t mID {};
+    std::vector<std::filesystem::path> mRoots;
+  };
+
+  std::function<void()> mOnUpdate;
+
+  mutable std::mutex mMutex;
+  std::condition_variable_any mChanged;
+  std::unordered_map<const Artifact*, Entry> mEntries;
+  std::deque<Job> mQueue;
+  bool mIsMeasuring {false};
+  std::uint64_t mNextID {};
+  // The job being measured, if any
+  std::uint64_t mCurrentID {};
+  std::stop_source mCurrentStop;
+
+  // Last, so that it's stopped before anything else is destroyed
+  std::jthread mThread;
+
+  void Run(std::stop_token);
+};
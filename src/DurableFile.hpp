@@ -0,0 +1,46 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <span>
+
+// A file that is only appended to, where each append has reached the disk -
+// not just the OS cache - before returning; implemented per platform.
+//
+// Large files can instead be written with `Write()`, then `Flush()`ed once.
+class DurableFile {
+ public:
+  DurableFile() = delete;
+  ~DurableFile();
+  DurableFile(DurableFile&&) noexcept;
+  DurableFile& operator=(DurableFile&&) noexcept;
+  DurableFile(const DurableFile&) = delete;
+  DurableFile& operator=(const DurableFile&) = delete;
+
+  // Replaces any existing file. Throws `std::filesystem::filesystem_error`.
+  [[nodiscard]] static DurableFile Create(const std::filesystem::path&);
+
+  // Throws `std::filesystem::filesystem_error`; if it does, some of the data
+  // may have been written
+  void Append(std::span<const std::byte>);
+
+  // Like `Append()`, but may only be in the OS cache until `Flush()`
+  void Write(std::span<const std::byte>);
+  // Throws `std::filesystem::filesystem_error`
+  void Flush();
+
+  // Replaces `to` with the closed file `from`, and waits until the new name
+  // has reached the disk. Throws `std::filesystem::filesystem_error`.
+  static void Rename(
+    const std::filesystem::path& from,
+    const std::filesystem::path& to);
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> mImpl;
+
+  explicit DurableFile(std::unique_ptr<Impl>);
+};
@@ -0,0 +1,80 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "SpscQueue.hpp"
+
+// Delivers events from worker threads to the UI thread without locks.
+//
+// Each producer has its own `SpscQueue`, so events from the same producer
+// stay in order. `wake` is invoked when the first event arrives after a
+// `Drain()`, rather than for every event; for the UI, this is
+// `InvalidateRect()`.
+template <class T>
+class EventChannel {
+ public:
+  static constexpr std::size_t QueueCapacity = 64;
+
+  EventChannel() = delete;
+  EventChannel(std::size_t producerCount, std::function<void()> wake)
+    : mWake(std::move(wake)) {
+    mQueues.reserve(producerCount);
+    for (std::size_t i = 0; i < producerCount; ++i) {
+      mQueues.push_back(std::make_unique<Queue>());
+    }
+  }
+
+  EventChannel(const EventChannel&) = delete;
+  EventChannel& operator=(const EventChannel&) = delete;
+
+  // Each producer index must only be used by one thread at a time.
+  //
+  // If the producer's queue is full, this waits for the consumer.
+  void Push(std::size_t producer, T event) {
+    auto& queue = *mQueues.at(producer);
+    while (!queue.TryPush(event)) {
+      Wake();
+      std::this_thread::yield();
+    }
+    // Pairs with the exchange in `Drain()`: either this sees the flag was
+    // cleared and wakes the consumer, or the consumer sees this event
+    if (!mWakePending.exchange(true, std::memory_order_acq_rel)) {
+      Wake();
+    }
+  }
+
+  // Consumer only; invokes `f` for each pending event, in order per
+  // producer
+  template <std::invocable<T&&> F>
+  void Drain(F&& f) {
+    if (!mWakePending.exchange(false, std::memory_order_acq_rel)) {
+      return;
+    }
+    for (auto&& queue: mQueues) {
+      while (auto event = queue->TryPop()) {
+        std::invoke(f, std::move(*event));
+      }
+    }
+  }
+
+ private:
+  using Queue = SpscQueue<T, QueueCapacity>;
+
+  std::vector<std::unique_ptr<Queue>> mQueues;
+  std::atomic<bool> mWakePending {false};
+  std::function<void()> mWake;
+
+  void Wake() {
+    if (mWake) {
+      mWake();
+    }
+  }
+};
@@ -0,0 +1,136 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "FaultInjectingFileSystem.hpp"
+
+#include <thread>
+#include <utility>
+
+FaultInjectingFileSystem::FaultInjectingFileSystem(
+  FileSystem& inner,
+  const Options& options)
+  : mInner(inner),
+    mOptions(options),
+    mRandom(options.mSeed) {}
+
+FaultInjectingFileSystem::~FaultInjectingFileSystem() = default;
+
+bool FaultInjectingFileSystem::Chance(const double probability) {
+  if (probability <= 0) {
+    return false;
+  }
+  std::unique_lock lock(mRandomMutex);
+  return std::bernoulli_distribution {probability}(mRandom);
+}
+
+std::error_code FaultInjectingFileSystem::Inject(const Operation operation) {
+  ++mCalls;
+
+  auto latency = mOptions.mLatency.at(std::to_underlying(operation));
+  if (mOptions.mJitter.count() > 0) {
+    std::unique_lock lock(mRandomMutex);
+    latency += std::chrono::microseconds {
+      std::uniform_int_distribution<std::chrono::microseconds::rep> {
+        0, mOptions.mJitter.count()}(mRandom)};
+  }
+  if (latency.count() > 0) {
+    mAddedLatency += latency.count();
+    std::this_thread::sleep_for(latency);
+  }
+
+  if (Chance(mOptions.mSharingViolationRate)) {
+    ++mSharingViolations;
+    return MakeSharingViolationError();
+  }
+  if (Chance(mOptions.mAccessDeniedRate)) {
+    ++mAccessDenied;
+    return MakeAccessDeniedError();
+  }
+  return {};
+}
+
+bool FaultInjectingFileSystem::Exists(
+  const std::filesystem::path& path,
+  std::error_code& ec) {
+  ec = Inject(Operation::Exists);
+  if (ec) {
+    return false;
+  }
+  return mInner.Exists(path, ec);
+}
+
+std::vector<DirectoryEntry> FaultInjectingFileSystem::ListDirectory(
+  const std::filesystem::path& path,
+  std::error_code& ec,
+  const ListingDetail detail) {
+  ec = Inject(Operation::ListDirectory);
+  if (ec) {
+    return {};
+  }
+  auto ret = mInner.ListDirectory(path, ec, detail);
+  // Still returned, as the caller has to cope with whatever it finds when it
+  // gets to them
+  for (auto&& entry: ret) {
+    if (!Chance(mOptions.mDisappearanceRate)) {
+      continue;
+    }
+    std::error_code removeEC;
+    std::filesystem::remove_all(entry.mPath, removeEC);
+    if (!removeEC) {
+      ++mDisappeared;
+    }
+  }
+  return ret;
+}
+
+DirectoryEntry FaultInjectingFileSystem::GetDirectoryEntry(
+  const std::filesystem::path& path,
+  std::error_code& ec) {
+  ec = Inject(Operation::GetDirectoryEntry);
+  if (ec) {
+    return {.mPath = path};
+  }
+  return mInner.GetDirectoryEntry(path, ec);
+}
+
+bool FaultInjectingFileSystem::Remove(
+  const std::filesystem::path& path,
+  std::error_code& ec) {
+  ec = Inject(Operation::Remove);
+  if (ec) {
+    return false;
+  }
+  return mInner.Remove(path, ec);
+}
+
+void FaultInjectingFileSystem::Rename(
+  const std::filesystem::path& from,
+  const std::filesystem::path& to,
+  std::error_code& ec) {
+  ec = Inject(Operation::Rename);
+  if (ec) {
+    return;
+  }
+  mInner.Rename(from, to, ec);
+}
+
+bool FaultInjectingFileSystem::CreateDirectory(
+  const std::filesystem::path& path,
+  std::error_code& ec) {
+  ec = Inject(Operation::CreateDirectory);
+  if (ec) {
+    return false;
+  }
+  return mInner.CreateDirectory(path, ec);
+}
+
+FaultInjectingFileSystem::Counters FaultInjectingFileSystem::GetCounters()
+  const {
+  return {
+    .mCalls = mCalls.load(),
+    .mSharingViolations = mSharingViolations.load(),
+    .mAccessDenied = mAccessDenied.load(),
+    .mDisappeared = mDisappeared.load(),
+    .mAddedLatency = std::chrono::microseconds {mAddedLatency.load()},
+  };
+}
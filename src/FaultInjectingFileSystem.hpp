@@ -0,0 +1,117 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string_view>
+
+#include "FileSystem.hpp"
+
+// Wraps another `FileSystem`, making it slow and unreliable in the ways that
+// users' storage can be: e.g. on network drives, or with an aggressive
+// antivirus scanner.
+//
+// - every operation can be delayed
+// - any operation can fail with a sharing violation or access denied
+// - entries can disappear between being listed and being used, as if
+//   another process deleted them
+//
+// Faults are chosen at random; with the same seed, a single-threaded caller
+// sees the same faults each time.
+class FaultInjectingFileSystem final : public FileSystem {
+ public:
+  enum class Operation {
+    Exists,
+    ListDirectory,
+    GetDirectoryEntry,
+    Remove,
+    Rename,
+    CreateDirectory,
+  };
+  static constexpr std::array<std::string_view, 6> OperationNames {
+    "exists",
+    "list",
+    "stat",
+    "remove",
+    "rename",
+    "mkdir",
+  };
+
+  struct Options {
+    // Added to every call, indexed by `Operation`
+    std::array<std::chrono::microseconds, OperationNames.size()> mLatency {};
+    // Up to this much extra latency is added to each call, at random
+    std::chrono::microseconds mJitter {};
+    // Probabilities for each call, from 0 to 1
+    double mSharingViolationRate {};
+    double mAccessDeniedRate {};
+    // Probability that each listed entry is deleted after it's listed.
+    //
+    // These are really deleted, bypassing this wrapper; folders are
+    // deleted with everything inside them.
+    double mDisappearanceRate {};
+    std::uint64_t mSeed {std::random_device {}()};
+  };
+
+  struct Counters {
+    std::uint64_t mCalls {};
+    std::uint64_t mSharingViolations {};
+    std::uint64_t mAccessDenied {};
+    std::uint64_t mDisappeared {};
+    std::chrono::microseconds mAddedLatency {};
+
+    Counters& operator+=(const Counters& other) noexcept {
+      mCalls += other.mCalls;
+      mSharingViolations += other.mSharingViolations;
+      mAccessDenied += other.mAccessDenied;
+      mDisappeared += other.mDisappeared;
+      mAddedLatency += other.mAddedLatency;
+      return *this;
+    }
+  };
+
+  FaultInjectingFileSystem() = delete;
+  FaultInjectingFileSystem(FileSystem& inner, const Options& options);
+  ~FaultInjectingFileSystem() override;
+
+  [[nodiscard]] bool Exists(const std::filesystem::path&, std::error_code&)
+    override;
+  [[nodiscard]] std::vector<DirectoryEntry> ListDirectory(
+    const std::filesystem::path&,
+    std::error_code&,
+    ListingDetail) override;
+  [[nodiscard]] DirectoryEntry GetDirectoryEntry(
+    const std::filesystem::path&,
+    std::error_code&) override;
+  bool Remove(const std::filesystem::path&, std::error_code&) override;
+  void Rename(
+    const std::filesystem::path& from,
+    const std::filesystem::path& to,
+    std::error_code&) override;
+  bool CreateDirectory(const std::filesystem::path&, std::error_code&)
+    override;
+
+  [[nodiscard]] Counters GetCounters() const;
+
+ private:
+  FileSystem& mInner;
+  Options mOptions;
+
+  std::mutex mRandomMutex;
+  std::mt19937_64 mRandom;
+
+  std::atomic<std::uint64_t> mCalls {};
+  std::atomic<std::uint64_t> mSharingViolations {};
+  std::atomic<std::uint64_t> mAccessDenied {};
+  std::atomic<std::uint64_t> mDisappeared {};
+  std::atomic<std::chrono::microseconds::rep> mAddedLatency {};
+
+  // Sleeps, then returns the error to fail this call with, if any
+  [[nodiscard]] std::error_code Inject(Operation);
+  [[nodiscard]] bool Chance(double probability);
+};
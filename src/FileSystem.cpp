@@ -0,0 +1,64 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "FileSystem.hpp"
+
+#include <atomic>
+#include <utility>
+
+namespace {
+class RealFileSystem final : public FileSystem {
+ public:
+  bool Exists(const std::filesystem::path& path, std::error_code& ec)
+    override {
+    return std::filesystem::exists(path, ec);
+  }
+
+  std::vector<DirectoryEntry> ListDirectory(
+    const std::filesystem::path& path,
+    std::error_code& ec,
+    const ListingDetail detail) override {
+    return ::ListDirectory(path, ec, detail);
+  }
+
+  DirectoryEntry GetDirectoryEntry(
+    const std::filesystem::path& path,
+    std::error_code& ec) override {
+    return ::GetDirectoryEntry(path, ec);
+  }
+
+  bool Remove(const std::filesystem::path& path, std::error_code& ec)
+    override {
+    return std::filesystem::remove(path, ec);
+  }
+
+  void Rename(
+    const std::filesystem::path& from,
+    const std::filesystem::path& to,
+    std::error_code& ec) override {
+    std::filesystem::rename(from, to, ec);
+  }
+
+  bool CreateDirectory(const std::filesystem::path& path, std::error_code& ec)
+    override {
+    return std::filesystem::create_directory(path, ec);
+  }
+};
+
+std::atomic<FileSystem*> gOverride {nullptr};
+}// namespace
+
+FileSystem::ScopedOverride::ScopedOverride(FileSystem& fileSystem)
+  : mPrevious(gOverride.exchange(&fileSystem)) {}
+
+FileSystem::ScopedOverride::~ScopedOverride() {
+  gOverride.store(mPrevious);
+}
+
+FileSystem& FileSystem::Get() {
+  if (const auto it = gOverride.load()) {
+    return *it;
+  }
+  static RealFileSystem sInstance;
+  return sInstance;
+}
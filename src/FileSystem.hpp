@@ -0,0 +1,98 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <chrono>
+#include <concepts>
+#include <filesystem>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "DirectoryListing.hpp"
+
+// The filesystem operations used to find, measure, and remove filesystem
+// artifacts.
+//
+// This is usually the real filesystem; benchmarks can replace it with a
+// `FaultInjectingFileSystem` to see how scans and removals cope with slow,
+// antivirus-scanned, or unreliable storage. Errors are always reported via
+// `std::error_code`, never thrown.
+class FileSystem {
+ public:
+  // Replaces what `Get()` returns until destroyed; these can be nested.
+  //
+  // Create this before starting any work that uses the filesystem, and
+  // destroy it after that work has finished, including background deletion;
+  // see `TombstoneReaper::WaitUntilIdle()`.
+  class ScopedOverride {
+   public:
+    ScopedOverride() = delete;
+    explicit ScopedOverride(FileSystem&);
+    ~ScopedOverride();
+
+    ScopedOverride(const ScopedOverride&) = delete;
+    ScopedOverride& operator=(const ScopedOverride&) = delete;
+
+   private:
+    FileSystem* mPrevious {nullptr};
+  };
+
+  virtual ~FileSystem() = default;
+
+  // The real filesystem, unless replaced by a `ScopedOverride`
+  static FileSystem& Get();
+
+  // Follows links; false with an error if it couldn't be checked
+  [[nodiscard]] virtual bool Exists(
+    const std::filesystem::path&,
+    std::error_code&)
+    = 0;
+  // See `::ListDirectory()`
+  [[nodiscard]] virtual std::vector<DirectoryEntry> ListDirectory(
+    const std::filesystem::path&,
+    std::error_code&,
+    ListingDetail)
+    = 0;
+  // See `::GetDirectoryEntry()`
+  [[nodiscard]] virtual DirectoryEntry GetDirectoryEntry(
+    const std::filesystem::path&,
+    std::error_code&)
+    = 0;
+  // Removes a file or empty folder; false without an error if it didn't
+  // exist
+  virtual bool Remove(const std::filesystem::path&, std::error_code&) = 0;
+  virtual void Rename(
+    const std::filesystem::path& from,
+    const std::filesystem::path& to,
+    std::error_code&)
+    = 0;
+  // False without an error if it already exists
+  virtual bool CreateDirectory(const std::filesystem::path&, std::error_code&)
+    = 0;
+};
+
+// The file is open in another process, e.g. an antivirus scanner or the
+// search indexer; this is usually brief, so is worth retrying
+[[nodiscard]] bool IsSharingViolation(const std::error_code&);
+// As the real filesystem would report them on this platform
+[[nodiscard]] std::error_code MakeSharingViolationError();
+[[nodiscard]] std::error_code MakeAccessDeniedError();
+
+// Calls `f(ec)`, retrying a few times with increasing delays while it fails
+// with a sharing violation; other errors are returned immediately
+template <std::invocable<std::error_code&> F>
+auto RetryIfInUse(F&& f, std::error_code& ec) {
+  using namespace std::chrono_literals;
+  constexpr std::size_t RetryCount {4};
+  auto delay = 10ms;
+  for (std::size_t i = 0;; ++i) {
+    auto ret = std::invoke(f, ec);
+    if (i == RetryCount || !IsSharingViolation(ec)) {
+      return ret;
+    }
+    std::this_thread::sleep_for(delay);
+    delay *= 2;
+  }
+}
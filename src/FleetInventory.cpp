@@ -0,0 +1,206 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "FleetInventory.hpp"
+
+#include <algorithm>
+#include <format>
+#include <string_view>
+#include <utility>
+
+#include "JSON.hpp"
+
+using namespace std::string_view_literals;
+
+namespace {
+constexpr std::array RejectionNames {
+  "unreadable"sv,
+  "malformed"sv,
+  "unsupportedVersion"sv,
+};
+
+// e.g. "v0.1 until v1.5"
+std::string GetVersionRange(const ScanReport::FoundArtifact& artifact) {
+  if (artifact.mRemovedVersion.empty()) {
+    return std::format("v{} onwards", artifact.mEarliestVersion);
+  }
+  return std::format(
+    "v{} until v{}", artifact.mEarliestVersion, artifact.mRemovedVersion);
+}
+
+// e.g. "remove: succeeded", or "remove: planned" if the report is from a
+// scan
+std::string GetActionTaken(
+  const ScanReport& report,
+  const ScanReport::FoundArtifact& artifact) {
+  if (artifact.mAction.empty() || artifact.mAction == "none") {
+    return "none";
+  }
+  const auto step = std::ranges::find(
+    report.mSteps, artifact.mTitle, &ScanReport::Step::mTitle);
+  if (step == report.mSteps.end() || step->mOutcome.empty()) {
+    return std::format("{}: planned", artifact.mAction);
+  }
+  return std::format("{}: {}", artifact.mAction, step->mOutcome);
+}
+
+template <class T>
+void MergeCounts(T& into, const T& from) {
+  for (auto&& [key, count]: from) {
+    into[key] += count;
+  }
+}
+
+void WriteCountsText(
+  std::ostream& out,
+  const std::string_view heading,
+  const std::map<std::string, std::size_t>& counts) {
+  if (counts.empty()) {
+    return;
+  }
+  out << std::format("\n{}:\n", heading);
+  for (auto&& [key, count]: counts) {
+    out << std::format("  {:<40} {:>10}\n", key, count);
+  }
+}
+
+void WriteCountsJSON(
+  std::ostream& out,
+  const std::map<std::string, std::size_t>& counts) {
+  out << '{';
+  bool first = true;
+  for (auto&& [key, count]: counts) {
+    out << (std::exchange(first, false) ? "" : ",");
+    WriteJSONString(out, key);
+    out << ':' << count;
+  }
+  out << '}';
+}
+}// namespace
+
+void FleetInventory::Add(const ScanReport& report) {
+  ++mReportCount;
+  if (!report.mIncompleteChecks.empty()) {
+    ++mIncompleteCount;
+  }
+  ++mFreshStartVersions[report.mFreshStartVersion];
+
+  for (auto&& artifact: report.mArtifacts) {
+    if (!artifact.mIsPresent) {
+      continue;
+    }
+    auto versions = GetVersionRange(artifact);
+    const auto action = GetActionTaken(report, artifact);
+
+    ++mKinds[artifact.mKind];
+    ++mActions[action];
+    ++mVersions[versions];
+
+    auto& summary = mArtifacts[artifact.mTitle];
+    if (summary.mMachineCount == 0) {
+      summary.mKind = artifact.mKind;
+      summary.mVersions = std::move(versions);
+      summary.mIsOutdated = artifact.mIsOutdated;
+    }
+    ++summary.mMachineCount;
+    ++summary.mActions[action];
+  }
+}
+
+void FleetInventory::AddRejected(const Rejection reason) {
+  ++mRejected.at(std::to_underlying(reason));
+}
+
+void FleetInventory::Merge(const FleetInventory& other) {
+  mReportCount += other.mReportCount;
+  mIncompleteCount += other.mIncompleteCount;
+  for (std::size_t i = 0; i < mRejected.size(); ++i) {
+    mRejected[i] += other.mRejected[i];
+  }
+
+  for (auto&& [title, theirs]: other.mArtifacts) {
+    auto [it, inserted] = mArtifacts.try_emplace(title, theirs);
+    if (inserted) {
+      continue;
+    }
+    auto& ours = it->second;
+    ours.mMachineCount += theirs.mMachineCount;
+    MergeCounts(ours.mActions, theirs.mActions);
+  }
+  MergeCounts(mKinds, other.mKinds);
+  MergeCounts(mVersions, other.mVersions);
+  MergeCounts(mActions, other.mActions);
+  MergeCounts(mFreshStartVersions, other.mFreshStartVersions);
+}
+
+void FleetInventory::WriteText(std::ostream& out) const {
+  out << std::format("Reports: {}\n", mReportCount);
+  if (mIncompleteCount) {
+    out << std::format(
+      "Reports where some checks did not finish: {}\n", mIncompleteCount);
+  }
+  for (std::size_t i = 0; i < mRejected.size(); ++i) {
+    if (mRejected[i]) {
+      out << std::format(
+        "Rejected ({}): {}\n", RejectionNames[i], mRejected[i]);
+    }
+  }
+
+  WriteCountsText(out, "By kind", mKinds);
+  WriteCountsText(out, "By OpenKneeboard versions", mVersions);
+  WriteCountsText(out, "By action", mActions);
+  WriteCountsText(out, "By Fresh Start version", mFreshStartVersions);
+
+  if (mArtifacts.empty()) {
+    return;
+  }
+  out << "\nBy artifact:\n";
+  for (auto&& [title, summary]: mArtifacts) {
+    out << std::format(
+      "  {} ({}, {}{}): {}\n",
+      title,
+      summary.mKind,
+      summary.mVersions,
+      summary.mIsOutdated ? ", obsolete" : "",
+      summary.mMachineCount);
+    for (auto&& [action, count]: summary.mActions) {
+      out << std::format("    {:<38} {:>10}\n", action, count);
+    }
+  }
+}
+
+void FleetInventory::WriteJSON(std::ostream& out) const {
+  out << std::format(
+    R"({{"reports":{},"incompleteReports":{},"rejected":{{)",
+    mReportCount,
+    mIncompleteCount);
+  for (std::size_t i = 0; i < mRejected.size(); ++i) {
+    out << std::format(
+      R"({}"{}":{})", i ? "," : "", RejectionNames[i], mRejected[i]);
+  }
+  out << R"(},"kinds":)";
+  WriteCountsJSON(out, mKinds);
+  out << R"(,"versions":)";
+  WriteCountsJSON(out, mVersions);
+  out << R"(,"actions":)";
+  WriteCountsJSON(out, mActions);
+  out << R"(,"freshStartVersions":)";
+  WriteCountsJSON(out, mFreshStartVersions);
+  out << R"(,"artifacts":[)";
+  bool first = true;
+  for (auto&& [title, summary]: mArtifacts) {
+    out << (std::exchange(first, false) ? "" : ",") << R"({"title":)";
+    WriteJSONString(out, title);
+    out << R"(,"kind":)";
+    WriteJSONString(out, summary.mKind);
+    out << R"(,"versions":)";
+    WriteJSONString(out, summary.mVersions);
+    out << std::format(
+      R"(,"outdated":{},"machines":{},"actions":)",
+      summary.mIsOutdated ? "true" : "false",
+      summary.mMachineCount);
+    WriteCountsJSON(out, summary.mActions);
+    out << '}';
+  }
+  out << "]}" << std::endl;
+}
@@ -0,0 +1,60 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+
+#include "ScanReport.hpp"
+
+// Counts of what was found across many machines' scan reports, e.g. to see
+// which obsolete components are still out there.
+//
+// Only present artifacts are counted. Memory use depends on the number of
+// distinct artifacts, versions, and actions, not the number of reports, so
+// each thread can fill its own inventory, and merge them at the end.
+class FleetInventory {
+ public:
+  enum class Rejection {
+    Unreadable,
+    Malformed,
+    UnsupportedVersion,
+  };
+
+  void Add(const ScanReport&);
+  void AddRejected(Rejection);
+  void Merge(const FleetInventory&);
+
+  [[nodiscard]] std::size_t GetReportCount() const noexcept {
+    return mReportCount;
+  }
+
+  void WriteText(std::ostream&) const;
+  void WriteJSON(std::ostream&) const;
+
+ private:
+  using Counts = std::map<std::string, std::size_t>;
+
+  struct ArtifactSummary {
+    std::string mKind;
+    std::string mVersions;
+    bool mIsOutdated {false};
+    std::size_t mMachineCount {};
+    Counts mActions;
+  };
+
+  std::size_t mReportCount {};
+  // Reports where some checks didn't finish, so may be missing artifacts
+  std::size_t mIncompleteCount {};
+  std::array<std::size_t, 3> mRejected {};
+
+  // By title
+  std::map<std::string, ArtifactSummary> mArtifacts;
+  Counts mKinds;
+  Counts mVersions;
+  Counts mActions;
+  Counts mFreshStartVersions;
+};
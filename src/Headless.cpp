@@ -0,0 +1,528 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "Headless.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "ArtifactRegistry.hpp"
+#include "BackupArchive.hpp"
+#include "DiscoveryScheduler.hpp"
+#include "Instrumentation.hpp"
+#include "JSON.hpp"
+#include "KnownFolders.hpp"
+#include "PlanRunner.hpp"
+#include "RegistryProbe.hpp"
+#include "ScanReport.hpp"
+#include "TombstoneReaper.hpp"
+#include "config.hpp"
+
+namespace {
+constexpr std::wstring_view ModePrefix {L"--mode="};
+constexpr std::wstring_view BackupFolderPrefix {L"--backup-folder="};
+constexpr std::wstring_view RestorePrefix {L"--restore="};
+
+std::string ToUTF8(const std::wstring_view value) {
+  const auto ret = std::filesystem::path {value}.u8string();
+  return {ret.begin(), ret.end()};
+}
+
+struct DiscoveredArtifact {
+  std::unique_ptr<Artifact> mArtifact;
+  ArtifactFlags mFlags;
+  std::optional<Action> mAction;
+};
+
+struct Discovery {
+  // In registry order, like the GUI
+  std::vector<DiscoveredArtifact> mArtifacts;
+  std::vector<std::string_view> mIncompleteChecks;
+};
+
+Discovery Discover(const CleanupOptions& options) {
+  KnownFolders::Get().Expect(FilesystemLocations);
+  DiscoveryScheduler scheduler {
+    MakeRegistryProbes(), std::thread::hardware_concurrency(), {}};
+  scheduler.WaitForAll();
+  auto results = scheduler.TakeResults();
+  std::ranges::sort(results, {}, &DiscoveryScheduler::Result::mIndex);
+
+  Discovery ret;
+  for (auto&& result: results) {
+    using enum DiscoveryScheduler::Status;
+    switch (result.mStatus) {
+      case Found: {
+        auto& artifact = *result.mArtifact;
+        auto flags = GetArtifactFlags(artifact);
+        flags.mIsPresent = artifact.IsPresent();
+        ret.mArtifacts.push_back({
+          .mArtifact = std::move(result.mArtifact),
+          .mFlags = flags,
+          .mAction = GetPlannedAction(flags, options),
+        });
+        break;
+      }
+      case NotFound:
+        break;
+      case Failed:
+      case TimedOut:
+        ret.mIncompleteChecks.push_back(result.mName);
+        break;
+    }
+  }
+  return ret;
+}
+
+// Finish deleting anything that was moved aside by a previous run
+void StartReaping() {
+  auto& reaper = TombstoneReaper::Get();
+  auto& folders = KnownFolders::Get();
+  for (auto&& location: FilesystemLocations) {
+    const auto root = folders.GetRoot(location.mRoot);
+    if (!root.empty()) {
+      reaper.ReapLeftovers((root / location.mChild).parent_path());
+    }
+  }
+}
+
+// Owns everything that running steps use. Timed out and cancelled steps may
+// still be running in the background when `RunPlan()` returns, so in that
+// case, this is deliberately never freed.
+struct HeadlessRun {
+  explicit HeadlessRun(Plan plan) : mPlan(std::move(plan)) {
+    for (auto&& step: mPlan.GetSteps()) {
+      auto& progress
+        = mProgress.emplace_back(std::make_unique<Progress>(&mOverall));
+      progress->AddToTotal(mPlan.GetEstimate(step));
+      mProgressPointers.push_back(progress.get());
+    }
+  }
+
+  Plan mPlan;
+  Progress mOverall;
+  // Heap-allocated as `Progress` is not movable
+  std::vector<std::unique_ptr<Progress>> mProgress;
+  std::vector<Progress*> mProgressPointers;
+};
+
+std::string_view GetKindName(const Artifact::Kind kind) {
+  switch (kind) {
+    case Artifact::Kind::Software:
+      return "software";
+    case Artifact::Kind::UserSettings:
+      return "userSettings";
+    case Artifact::Kind::Logs:
+      return "logs";
+    case Artifact::Kind::TemporaryFiles:
+      return "temporaryFiles";
+  }
+  std::unreachable();
+}
+
+std::string_view GetActionName(const std::optional<Action> action) {
+  if (!action) {
+    return "none";
+  }
+  switch (*action) {
+    case Action::Ignore:
+      return "none";
+    case Action::Repair:
+      return "repair";
+    case Action::Remove:
+      return "remove";
+  }
+  std::unreachable();
+}
+
+std::string_view GetActionName(const Plan::Action action) {
+  switch (action) {
+    case Plan::Action::Repair:
+      return "repair";
+    case Plan::Action::Remove:
+      return "remove";
+    case Plan::Action::Backup:
+      return "backup";
+  }
+  std::unreachable();
+}
+
+std::string_view GetOutcomeName(const ActionScheduler::Outcome outcome) {
+  switch (outcome) {
+    case ActionScheduler::Outcome::Succeeded:
+      return "succeeded";
+    case ActionScheduler::Outcome::Failed:
+      return "failed";
+    case ActionScheduler::Outcome::TimedOut:
+      return "timedOut";
+    case ActionScheduler::Outcome::Cancelled:
+      return "cancelled";
+  }
+  std::unreachable();
+}
+
+std::string GetErrorMessage(const std::exception_ptr& error) {
+  if (!error) {
+    return {};
+  }
+  try {
+    std::rethrow_exception(error);
+  } catch (const std::exception& e) {
+    return e.what();
+  } catch (...) {
+    return "Unknown error";
+  }
+}
+
+void WriteJSON(
+  std::ostream& out,
+  const Discovery& discovery,
+  const Plan& plan,
+  std::span<const ActionScheduler::Result> results) {
+  out << std::format(
+    R"({{"schemaVersion":{},"freshStartVersion":)", ScanReportSchemaVersion);
+  WriteJSONString(out, Config::Version::Readable);
+  out << R"(,"artifacts":[)";
+  for (auto&& [i, it]: std::views::enumerate(discovery.mArtifacts)) {
+    const auto& artifact = *it.mArtifact;
+    out << (i ? "," : "") << R"({"title":)";
+    WriteJSONString(out, artifact.GetTitle());
+    out << std::format(
+      R"(,"kind":"{}","present":{},"outdated":{},"action":"{}")",
+      GetKindName(artifact.GetKind()),
+      it.mFlags.mIsPresent ? "true" : "false",
+      it.mFlags.mIsOutdated ? "true" : "false",
+      GetActionName(it.mAction));
+    out << R"(,"earliestVersion":)";
+    WriteJSONString(out, artifact.GetEarliestVersion().mName);
+    out << R"(,"removedVersion":)";
+    if (const auto removed = artifact.GetRemovedVersion()) {
+      WriteJSONString(out, removed->mName);
+    } else {
+      out << "null";
+    }
+    out << '}';
+  }
+  out << R"(],"incompleteChecks":[)";
+  for (auto&& [i, name]: std::views::enumerate(discovery.mIncompleteChecks)) {
+    out << (i ? "," : "");
+    WriteJSONString(out, name);
+  }
+  out << R"(],"steps":[)";
+  for (auto&& [i, step]: std::views::enumerate(plan.GetSteps())) {
+    out << (i ? "," : "") << R"({"title":)";
+    WriteJSONString(out, step.mTitle);
+    out << std::format(
+      R"(,"action":"{}","operations":[)", GetActionName(step.mAction));
+    for (auto&& [j, operation]:
+         std::views::enumerate(plan.GetOperations(step))) {
+      out << (j ? "," : "");
+      WriteJSONString(out, Describe(operation));
+    }
+    out << ']';
+    if (static_cast<std::size_t>(i) < results.size()) {
+      const auto& result = results[i];
+      out << std::format(
+        R"(,"outcome":"{}")", GetOutcomeName(result.mOutcome));
+      if (result.mError) {
+        out << R"(,"error":)";
+        WriteJSONString(out, GetErrorMessage(result.mError));
+      }
+    }
+    out << '}';
+  }
+  out << "]}" << std::endl;
+}
+
+void WriteDiscovery(std::ostream& out, const Discovery& discovery) {
+  if (discovery.mArtifacts.empty()) {
+    out << "Couldn't find anything from OpenKneeboard.\n";
+  }
+  for (auto&& it: discovery.mArtifacts) {
+    out << std::format(
+      "{}: {}{}\n",
+      it.mArtifact->GetTitle(),
+      it.mFlags.mIsPresent ? GetActionName(it.mAction) : "not present",
+      it.mFlags.mIsOutdated ? " (obsolete)" : "");
+  }
+  for (auto&& name: discovery.mIncompleteChecks) {
+    out << std::format("{}: check did not finish\n", name);
+  }
+}
+
+void WritePlan(std::ostream& out, const Plan& plan, const bool apply) {
+  if (plan.GetSteps().empty()) {
+    out << "\nNothing to do.\n";
+    return;
+  }
+  out << (apply ? "\nChanges:\n" : "\nChanges that would be made:\n");
+  for (auto&& step: plan.GetSteps()) {
+    out << std::format("- {} ({})\n", step.mTitle, GetActionName(step.mAction));
+    for (auto&& operation: plan.GetOperations(step)) {
+      out << std::format("    {}\n", Describe(operation));
+    }
+  }
+}
+
+// Reports the folders first, so that it's clear what's being replaced
+int RunRestore(
+  const std::filesystem::path& archive,
+  const bool json,
+  std::ostream& out,
+  const std::stop_token stopToken) {
+  std::vector<std::filesystem::path> roots;
+  std::string error;
+  try {
+    roots = BackupArchive::GetRoots(archive);
+    if (!json) {
+      out << "Restoring:\n";
+      for (auto&& root: roots) {
+        out << std::format("- {}\n", ToUTF8(root.wstring())) << std::flush;
+      }
+    }
+    BackupArchive {{.mStopToken = stopToken}}.Restore(archive);
+  } catch (const std::exception& e) {
+    error = e.what();
+  }
+
+  std::string_view outcome = "succeeded";
+  if (!error.empty()) {
+    outcome = "failed";
+  } else if (stopToken.stop_requested()) {
+    outcome = "cancelled";
+  }
+
+  if (json) {
+    out << R"({"archive":)";
+    WriteJSONString(out, ToUTF8(archive.wstring()));
+    out << R"(,"roots":[)";
+    for (auto&& [i, root]: std::views::enumerate(roots)) {
+      out << (i ? "," : "");
+      WriteJSONString(out, ToUTF8(root.wstring()));
+    }
+    out << std::format(R"(],"outcome":"{}")", outcome);
+    if (!error.empty()) {
+      out << R"(,"error":)";
+      WriteJSONString(out, error);
+    }
+    out << '}' << std::endl;
+  } else if (!error.empty()) {
+    out << std::format("Failed: {}\n", error);
+  } else if (stopToken.stop_requested()) {
+    out << "Cancelled; some files may not have been restored.\n";
+  } else {
+    out << "Restored.\n";
+  }
+  return outcome == "succeeded" ? HeadlessExitCode::Success
+                                : HeadlessExitCode::Incomplete;
+}
+}// namespace
+
+std::optional<HeadlessOptions> ParseHeadlessArguments(
+  std::span<const std::wstring_view> args) {
+  HeadlessOptions ret;
+  bool isHeadless = false;
+  bool scanOnly = false;
+  // Any option that only makes sense when cleaning up
+  bool haveCleanupOption = false;
+  std::optional<CleanupMode> mode;
+
+  for (auto&& arg: args) {
+    if (arg.starts_with(Instrumentation::CommandLineSwitch)) {
+      continue;
+    }
+    isHeadless = true;
+    if (arg == L"--help" || arg == L"-h" || arg == L"/?") {
+      ret.mShowUsage = true;
+    } else if (arg == L"--scan") {
+      scanOnly = true;
+      haveCleanupOption = true;
+    } else if (arg == L"--json") {
+      ret.mJSON = true;
+    } else if (arg == L"--remove-settings") {
+      ret.mCleanup.mRemoveSettings = true;
+      haveCleanupOption = true;
+    } else if (arg == L"--no-backup") {
+      ret.mCleanup.mBackUpSettings = false;
+      haveCleanupOption = true;
+    } else if (arg.starts_with(ModePrefix)) {
+      haveCleanupOption = true;
+      const auto value = arg.substr(ModePrefix.size());
+      if (value == L"repair") {
+        mode = CleanupMode::Repair;
+      } else if (value == L"remove-all") {
+        mode = CleanupMode::RemoveAll;
+      } else {
+        throw std::invalid_argument(
+          std::format("Unknown mode '{}'", ToUTF8(value)));
+      }
+    } else if (arg.starts_with(BackupFolderPrefix)) {
+      haveCleanupOption = true;
+      const std::filesystem::path folder {
+        arg.substr(BackupFolderPrefix.size())};
+      if (!folder.is_absolute()) {
+        throw std::invalid_argument("--backup-folder must be an absolute path");
+      }
+      ret.mCleanup.mBackupFolder = folder;
+    } else if (arg.starts_with(RestorePrefix)) {
+      const std::filesystem::path archive {arg.substr(RestorePrefix.size())};
+      if (archive.empty()) {
+        throw std::invalid_argument("--restore requires a backup file");
+      }
+      ret.mRestoreArchive = archive;
+    } else {
+      throw std::invalid_argument(
+        std::format("Unknown argument '{}'", ToUTF8(arg)));
+    }
+  }
+
+  if (!isHeadless) {
+    return std::nullopt;
+  }
+  if (ret.mRestoreArchive && haveCleanupOption) {
+    throw std::invalid_argument(
+      "--restore can't be combined with cleanup options");
+  }
+  if (ret.mCleanup.mRemoveSettings && mode != CleanupMode::RemoveAll) {
+    throw std::invalid_argument(
+      "--remove-settings requires --mode=remove-all");
+  }
+  ret.mCleanup.mMode = mode.value_or(CleanupMode::Repair);
+  // Without a mode, there's nothing the user has asked us to change
+  ret.mApply = mode.has_value() && !scanOnly;
+  return ret;
+}
+
+std::string GetHeadlessUsage() {
+  return
+    "Usage: OpenKneeboard-Fresh-Start [options]\n"
+    "\n"
+    "With no options, the window is shown. Otherwise:\n"
+    "\n"
+    "  --scan                 Only report what was found, and what would be\n"
+    "                         done; this is the default without --mode\n"
+    "  --mode=repair          Remove outdated components, and repair modern\n"
+    "                         ones\n"
+    "  --mode=remove-all      Remove everything except settings\n"
+    "  --remove-settings      With --mode=remove-all, also delete settings\n"
+    "  --no-backup            Don't back up settings before deleting them\n"
+    "  --backup-folder=PATH   Where to save the settings backup; defaults to\n"
+    "                         Documents\n"
+    "  --restore=ARCHIVE      Put back the settings from a backup instead of\n"
+    "                         cleaning up, replacing any existing files\n"
+    "  --json                 Write a JSON report instead of text\n"
+    "\n"
+    "Exit codes: 0 on success; 1 if a check or change failed, timed out, or\n"
+    "was cancelled; 2 for invalid options.\n"
+    "\n"
+    "From a command prompt, use `start /wait` to wait for the exit code.\n";
+}
+
+int RunHeadless(
+  const HeadlessOptions& options,
+  std::ostream& out,
+  std::stop_token stopToken) {
+  if (options.mShowUsage) {
+    out << GetHeadlessUsage();
+    return HeadlessExitCode::Success;
+  }
+  if (options.mRestoreArchive) {
+    return RunRestore(*options.mRestoreArchive, options.mJSON, out, stopToken);
+  }
+
+  const auto discovery = Discover(options.mCleanup);
+  StartReaping();
+  if (!options.mJSON) {
+    WriteDiscovery(out, discovery);
+  }
+
+  std::vector<PlannedArtifact> planned;
+  for (auto&& it: discovery.mArtifacts) {
+    if (it.mAction) {
+      planned.push_back({
+        .mArtifact = it.mArtifact.get(),
+        .mIsUserSettings = it.mFlags.mIsUserSettings,
+        .mAction = *it.mAction,
+      });
+    }
+  }
+  auto run = std::make_unique<HeadlessRun>(
+    BuildPlan(planned, options.mCleanup));
+  const auto& plan = run->mPlan;
+  if (!options.mJSON) {
+    WritePlan(out, plan, options.mApply);
+  }
+
+  std::vector<ActionScheduler::Result> results;
+  if (options.mApply) {
+    const auto steps = plan.GetSteps();
+    run->mOverall.Start();
+    results = RunPlan(
+      ArtifactRegistry,
+      plan,
+      run->mProgressPointers,
+      /* journal = */ nullptr,
+      [&options, &out, steps](const auto index, const auto event) {
+        if (options.mJSON) {
+          return;
+        }
+        const auto& title = steps[index].mTitle;
+        switch (event) {
+          case ActionScheduler::Event::Started:
+            out << std::format("Started: {}\n", title) << std::flush;
+            break;
+          case ActionScheduler::Event::Finished:
+            out << std::format("Finished: {}\n", title) << std::flush;
+            break;
+          case ActionScheduler::Event::TimedOut:
+            out << std::format("Timed out: {}\n", title) << std::flush;
+            break;
+          case ActionScheduler::Event::Cancelled:
+            out << std::format("Cancelled: {}\n", title) << std::flush;
+            break;
+        }
+      },
+      stopToken);
+    // Removed folders are deleted in the background; unlike the GUI, there's
+    // no window to leave open while that finishes
+    TombstoneReaper::Get().WaitUntilIdle(stopToken);
+  }
+
+  if (options.mJSON) {
+    WriteJSON(out, discovery, plan, results);
+  } else {
+    for (auto&& [i, result]: std::views::enumerate(results)) {
+      if (result.mOutcome == ActionScheduler::Outcome::Failed) {
+        out << std::format(
+          "Failed: {}: {}\n",
+          plan.GetSteps()[i].mTitle,
+          GetErrorMessage(result.mError));
+      }
+    }
+  }
+
+  const auto allReturned = std::ranges::all_of(results, [](const auto& it) {
+    using enum ActionScheduler::Outcome;
+    return it.mOutcome == Succeeded || it.mOutcome == Failed;
+  });
+  const auto allSucceeded = std::ranges::all_of(results, [](const auto& it) {
+    return it.mOutcome == ActionScheduler::Outcome::Succeeded;
+  });
+  if (!allReturned) {
+    // See `HeadlessRun`
+    std::ignore = run.release();
+  }
+  if (allSucceeded && discovery.mIncompleteChecks.empty()) {
+    return HeadlessExitCode::Success;
+  }
+  return HeadlessExitCode::Incomplete;
+}
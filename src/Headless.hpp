@@ -0,0 +1,56 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+
+#include "Decisions.hpp"
+
+// Runs from a console without creating a window or renderer, e.g. when
+// deploying to many machines. Discovery, decisions, and the plan are the
+// same as in the GUI; see `Decisions.hpp` and `PlanRunner.hpp`.
+
+struct HeadlessOptions {
+  // If false, only report what was found, and what would be done
+  bool mApply {false};
+  CleanupOptions mCleanup;
+  // If set, puts back the settings in this backup instead of cleaning up;
+  // see `BackupArchive`
+  std::optional<std::filesystem::path> mRestoreArchive;
+  // A single JSON document, instead of text
+  bool mJSON {false};
+  bool mShowUsage {false};
+};
+
+namespace HeadlessExitCode {
+constexpr int Success = 0;
+// A check or step failed, timed out, or was cancelled
+constexpr int Incomplete = 1;
+constexpr int InvalidArguments = 2;
+}// namespace HeadlessExitCode
+
+// `args` excludes the program name. Returns nullopt if there are no
+// arguments other than `Instrumentation::CommandLineSwitch`, i.e. the GUI
+// should be shown.
+//
+// Throws `std::invalid_argument` for unknown or conflicting arguments.
+[[nodiscard]] std::optional<HeadlessOptions> ParseHeadlessArguments(
+  std::span<const std::wstring_view> args);
+
+[[nodiscard]] std::string GetHeadlessUsage();
+
+// Blocks until everything has been discovered, and if `mApply` is set,
+// until the plan has been run and removed folders have been deleted; or,
+// with `mRestoreArchive`, until the backup has been restored.
+//
+// Returns a `HeadlessExitCode`.
+[[nodiscard]] int RunHeadless(
+  const HeadlessOptions&,
+  std::ostream& out,
+  std::stop_token stopToken = {});
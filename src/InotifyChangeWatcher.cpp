@@ -0,0 +1,191 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ChangeWatcher.hpp"
+
+namespace {
+
+// Linux implementation, mostly so that change detection can be exercised
+// without Windows.
+//
+// inotify watches are never recursive, so recursive watches add one watch per
+// directory, and follow directories as they are created.
+class InotifyChangeWatcher final : public ChangeWatcher {
+ public:
+  InotifyChangeWatcher(Callback callback, std::chrono::milliseconds quietPeriod)
+    : ChangeWatcher(std::move(callback), quietPeriod),
+      mInotify(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)),
+      mWake(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+    mThread = std::jthread {&InotifyChangeWatcher::WatchThread, this};
+  }
+
+  ~InotifyChangeWatcher() override {
+    StopDebouncing();
+    {
+      std::unique_lock lock(mMutex);
+      mStopping = true;
+    }
+    const std::uint64_t one = 1;
+    (void)write(mWake, &one, sizeof(one));
+    mThread.join();
+    close(mWake);
+    close(mInotify);
+  }
+
+  void WatchFolder(
+    Tag tag,
+    const std::filesystem::path& path,
+    bool recursive) override {
+    std::unique_lock lock(mMutex);
+    AddWatch(tag, path, recursive);
+    if (!recursive) {
+      return;
+    }
+    std::error_code ec;
+    std::filesystem::recursive_directory_iterator it {path, ec};
+    for (; !ec && it != std::filesystem::recursive_directory_iterator {};
+         it.increment(ec)) {
+      std::error_code typeEC;
+      if (it->is_directory(typeEC)) {
+        AddWatch(tag, it->path(), true);
+      }
+    }
+  }
+
+  void WatchRegistryKey(Tag, RegistryHive, std::wstring_view) override {
+  }
+
+  void Unwatch(Tag tag) override {
+    std::unique_lock lock(mMutex);
+    for (auto it = mWatches.begin(); it != mWatches.end();) {
+      std::erase_if(
+        it->second.mTags, [tag](const auto& t) { return t.mTag == tag; });
+      if (!it->second.mTags.empty()) {
+        ++it;
+        continue;
+      }
+      inotify_rm_watch(mInotify, it->first);
+      it = mWatches.erase(it);
+    }
+  }
+
+ private:
+  struct TagState {
+    Tag mTag {};
+    bool mRecursive {false};
+  };
+  struct WatchState {
+    std::filesystem::path mPath;
+    // inotify returns the same descriptor for the same path, so several
+    // tags can share one watch
+    std::vector<TagState> mTags;
+  };
+
+  int mInotify {-1};
+  int mWake {-1};
+
+  std::mutex mMutex;
+  std::unordered_map<int, WatchState> mWatches;
+  bool mStopping {false};
+  std::jthread mThread;
+
+  // Caller must hold mMutex
+  void AddWatch(Tag tag, const std::filesystem::path& path, bool recursive) {
+    constexpr std::uint32_t Mask = IN_CREATE | IN_DELETE | IN_MODIFY
+      | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF
+      | IN_ONLYDIR;
+    const auto wd = inotify_add_watch(mInotify, path.c_str(), Mask);
+    if (wd < 0) {
+      return;
+    }
+    auto& watch = mWatches[wd];
+    watch.mPath = path;
+    if (
+      std::ranges::find(watch.mTags, tag, &TagState::mTag)
+      == watch.mTags.end()) {
+      watch.mTags.push_back({tag, recursive});
+    }
+  }
+
+  void WatchThread() {
+    // Large enough for several events; each has a variable-length name
+    alignas(inotify_event) std::array<char, 16 * 1024> buffer {};
+    while (true) {
+      std::array fds {
+        pollfd {.fd = mInotify, .events = POLLIN},
+        pollfd {.fd = mWake, .events = POLLIN},
+      };
+      if (poll(fds.data(), fds.size(), -1) < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return;
+      }
+
+      std::unique_lock lock(mMutex);
+      if (mStopping) {
+        return;
+      }
+      if (!(fds[0].revents & POLLIN)) {
+        continue;
+      }
+
+      while (true) {
+        const auto length = read(mInotify, buffer.data(), buffer.size());
+        if (length <= 0) {
+          break;
+        }
+        for (ssize_t offset = 0; offset < length;) {
+          const auto event
+            = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+          offset += sizeof(inotify_event) + event->len;
+          OnEvent(*event);
+        }
+      }
+    }
+  }
+
+  // Caller must hold mMutex
+  void OnEvent(const inotify_event& event) {
+    const auto it = mWatches.find(event.wd);
+    if (it == mWatches.end()) {
+      return;
+    }
+    // Copy: adding watches below may rehash `mWatches`
+    const auto path = it->second.mPath;
+    const auto tags = it->second.mTags;
+    for (auto&& [tag, recursive]: tags) {
+      Notify(tag);
+      if (recursive && (event.mask & IN_ISDIR) && (event.mask & IN_CREATE)
+          && event.len > 0) {
+        AddWatch(tag, path / event.name, true);
+      }
+    }
+    if (event.mask & IN_IGNORED) {
+      mWatches.erase(event.wd);
+    }
+  }
+};
+
+}// namespace
+
+std::unique_ptr<ChangeWatcher> ChangeWatcher::Create(
+  Callback callback,
+  std::chrono::milliseconds quietPeriod) {
+  return std::make_unique<InotifyChangeWatcher>(
+    std::move(callback), quietPeriod);
+}
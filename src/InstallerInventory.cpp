@@ -0,0 +1,71 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "InstallerInventory.hpp"
+
+#include <algorithm>
+#include <thread>
+
+InstallerInventory::InstallerInventory(std::unique_ptr<Backend> backend)
+  : mBackend(std::move(backend)) {}
+
+InstallerInventory::~InstallerInventory() = default;
+
+std::shared_ptr<const std::vector<InstallerInventory::MSIProduct>>
+InstallerInventory::GetMSIProducts() {
+  std::unique_lock lock(mMSIMutex);
+  if (!mMSIProducts) {
+    auto products = mBackend->GetMSIProducts(MSIUpgradeCode);
+    std::ranges::sort(products, {}, &MSIProduct::mSortableVersion);
+    mMSIProducts = std::make_shared<const std::vector<MSIProduct>>(
+      std::move(products));
+  }
+  return mMSIProducts;
+}
+
+std::shared_ptr<const std::vector<InstallerInventory::MSIXPackage>>
+InstallerInventory::GetMSIXPackages() {
+  std::unique_lock lock(mMSIXMutex);
+  if (!mMSIXPackages) {
+    mMSIXPackages = std::make_shared<const std::vector<MSIXPackage>>(
+      mBackend->GetMSIXPackages(MSIXPackageName));
+  }
+  return mMSIXPackages;
+}
+
+void InstallerInventory::Invalidate() {
+  {
+    std::unique_lock lock(mMSIMutex);
+    mMSIProducts.reset();
+  }
+  std::unique_lock lock(mMSIXMutex);
+  mMSIXPackages.reset();
+}
+
+std::vector<InstallerInventory::MSIProduct>
+FakeInstallerBackend::GetMSIProducts(std::wstring_view upgradeCode) {
+  ++mMSIQueryCount;
+  std::this_thread::sleep_for(mLatency);
+
+  std::vector<InstallerInventory::MSIProduct> ret;
+  for (auto&& it: mMSIProducts) {
+    if (it.mUpgradeCode == upgradeCode) {
+      ret.push_back(it.mProduct);
+    }
+  }
+  return ret;
+}
+
+std::vector<InstallerInventory::MSIXPackage>
+FakeInstallerBackend::GetMSIXPackages(std::wstring_view name) {
+  ++mMSIXQueryCount;
+  std::this_thread::sleep_for(mLatency);
+
+  std::vector<InstallerInventory::MSIXPackage> ret;
+  for (auto&& it: mMSIXPackages) {
+    if (std::wstring_view {it.mFullName}.contains(name)) {
+      ret.push_back(it);
+    }
+  }
+  return ret;
+}
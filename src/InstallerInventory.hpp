@@ -0,0 +1,112 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A snapshot of OpenKneeboard's MSI and MSIX installations.
+//
+// Enumerating installed products is slow, so each kind is enumerated at most
+// once, and the filtered result is shared by every installer-backed artifact.
+class InstallerInventory {
+ public:
+  static constexpr std::wstring_view MSIUpgradeCode {
+    L"{843c9331-0610-4ab1-9cf9-5305c896fb5b}"};
+  static constexpr std::wstring_view MSIXPackageName {
+    L"FredEmmott.Self.OpenKneeboard"};
+
+  struct MSIProduct {
+    std::wstring mProductCode;
+    // MSIINSTALLCONTEXT
+    uint32_t mContext {};
+    std::wstring mVersionString;
+    // 8 bits: major
+    // 8 bits: minor
+    // 16 bits: patch
+    uint32_t mSortableVersion {};
+
+    bool operator==(const MSIProduct&) const noexcept = default;
+  };
+
+  struct MSIXPackage {
+    std::wstring mFullName;
+    uint16_t mMajor {};
+    uint16_t mMinor {};
+    uint16_t mBuild {};
+    uint16_t mRevision {};
+
+    bool operator==(const MSIXPackage&) const noexcept = default;
+  };
+
+  class Backend {
+   public:
+    virtual ~Backend() = default;
+    [[nodiscard]] virtual std::vector<MSIProduct> GetMSIProducts(
+      std::wstring_view upgradeCode)
+      = 0;
+    // Returns packages with a name containing `name`
+    [[nodiscard]] virtual std::vector<MSIXPackage> GetMSIXPackages(
+      std::wstring_view name)
+      = 0;
+  };
+
+  InstallerInventory() = delete;
+  explicit InstallerInventory(std::unique_ptr<Backend> backend);
+  ~InstallerInventory();
+
+  InstallerInventory(const InstallerInventory&) = delete;
+  InstallerInventory& operator=(const InstallerInventory&) = delete;
+
+  // Uses the native backend
+  static InstallerInventory& Get();
+
+  // Thread-safe; concurrent callers wait for the same enumeration.
+  [[nodiscard]] std::shared_ptr<const std::vector<MSIProduct>>
+  GetMSIProducts();
+  [[nodiscard]] std::shared_ptr<const std::vector<MSIXPackage>>
+  GetMSIXPackages();
+
+  // Discard the snapshot, e.g. after an installer has run
+  void Invalidate();
+
+ private:
+  std::unique_ptr<Backend> mBackend;
+
+  std::mutex mMSIMutex;
+  std::shared_ptr<const std::vector<MSIProduct>> mMSIProducts;
+
+  std::mutex mMSIXMutex;
+  std::shared_ptr<const std::vector<MSIXPackage>> mMSIXPackages;
+};
+
+// In-memory backend, for exercising the inventory without Windows Installer
+class FakeInstallerBackend final : public InstallerInventory::Backend {
+ public:
+  FakeInstallerBackend() = default;
+  ~FakeInstallerBackend() override = default;
+
+  [[nodiscard]] std::vector<InstallerInventory::MSIProduct> GetMSIProducts(
+    std::wstring_view upgradeCode) override;
+  [[nodiscard]] std::vector<InstallerInventory::MSIXPackage> GetMSIXPackages(
+    std::wstring_view name) override;
+
+  struct MSIProduct {
+    std::wstring mUpgradeCode;
+    InstallerInventory::MSIProduct mProduct;
+  };
+  std::vector<MSIProduct> mMSIProducts;
+  std::vector<InstallerInventory::MSIXPackage> mMSIXPackages;
+
+  // Simulated cost of each enumeration
+  std::chrono::microseconds mLatency {};
+
+  std::atomic<std::size_t> mMSIQueryCount {};
+  std::atomic<std::size_t> mMSIXQueryCount {};
+};
@@ -0,0 +1,232 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "Instrumentation.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "JSON.hpp"
+
+using namespace std::string_view_literals;
+
+namespace Instrumentation {
+
+namespace detail {
+std::atomic<bool> gEnabled {false};
+}
+
+namespace {
+using clock = std::chrono::steady_clock;
+
+constexpr std::array CounterNames {
+  "FilesVisited"sv,
+  "RegistryValuesRead"sv,
+  "KnownFolderLookups"sv,
+  "InstallerQueries"sv,
+};
+constexpr auto CounterCount = CounterNames.size();
+static_assert(
+  CounterCount == std::to_underlying(Counter::InstallerQueries) + 1);
+
+std::array<std::atomic<uint64_t>, CounterCount> gCounters {};
+
+struct CompleteEvent {
+  std::string mCategory;
+  std::string mName;
+  uint32_t mThread {};
+  clock::time_point mStart;
+  clock::duration mDuration {};
+};
+
+struct CounterSample {
+  clock::time_point mTime;
+  std::array<uint64_t, CounterCount> mValues {};
+};
+
+std::mutex gMutex;
+clock::time_point gEpoch = clock::now();
+std::vector<CompleteEvent> gEvents;
+std::vector<CounterSample> gCounterSamples;
+
+uint32_t GetThreadID() {
+  static std::atomic<uint32_t> sNext {1};
+  thread_local const auto id = sNext++;
+  return id;
+}
+
+CounterSample SampleCounters() {
+  CounterSample ret {.mTime = clock::now()};
+  for (std::size_t i = 0; i < CounterCount; ++i) {
+    ret.mValues[i] = gCounters[i].load(std::memory_order_relaxed);
+  }
+  return ret;
+}
+
+int64_t ToMicroseconds(clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+    .count();
+}
+
+std::filesystem::path GetPathFromCommandLine(std::wstring_view commandLine) {
+  const auto offset = commandLine.find(CommandLineSwitch);
+  if (offset == std::wstring_view::npos) {
+    return {};
+  }
+  auto value = commandLine.substr(offset + CommandLineSwitch.size());
+  if (value.starts_with(L'"')) {
+    value.remove_prefix(1);
+    return std::filesystem::path {value.substr(0, value.find(L'"'))};
+  }
+  return std::filesystem::path {value.substr(0, value.find(L' '))};
+}
+
+std::filesystem::path GetPathFromEnvironment() {
+  const std::string name {EnvironmentVariable};
+#ifdef _WIN32
+  char* buffer {nullptr};
+  std::size_t length {};
+  if (_dupenv_s(&buffer, &length, name.c_str()) != 0 || !buffer) {
+    return {};
+  }
+  const std::unique_ptr<char, decltype(&std::free)> owned {
+    buffer, &std::free};
+  return std::filesystem::path {std::string_view {buffer}};
+#else
+  const auto value = std::getenv(name.c_str());
+  if (!value) {
+    return {};
+  }
+  return std::filesystem::path {std::string_view {value}};
+#endif
+}
+
+}// namespace
+
+namespace detail {
+void Increment(Counter counter, uint64_t by) {
+  gCounters.at(std::to_underlying(counter))
+    .fetch_add(by, std::memory_order_relaxed);
+}
+}// namespace detail
+
+void Enable() {
+  std::unique_lock lock(gMutex);
+  if (detail::gEnabled.exchange(true)) {
+    return;
+  }
+  gEpoch = clock::now();
+}
+
+std::filesystem::path EnableFromEnvironment(std::wstring_view commandLine) {
+  auto path = GetPathFromCommandLine(commandLine);
+  if (path.empty()) {
+    path = GetPathFromEnvironment();
+  }
+  if (!path.empty()) {
+    Enable();
+  }
+  return path;
+}
+
+uint64_t GetCount(Counter counter) {
+  return gCounters.at(std::to_underlying(counter))
+    .load(std::memory_order_relaxed);
+}
+
+ScopedTimer::ScopedTimer(
+  std::string_view category,
+  std::string_view name) noexcept
+  : mCategory(category),
+    mName(name) {
+  if (IsEnabled()) [[unlikely]] {
+    mStart = clock::now();
+  }
+}
+
+ScopedTimer::~ScopedTimer() {
+  if (mStart == clock::time_point {}) [[likely]] {
+    return;
+  }
+  const auto duration = clock::now() - mStart;
+  const auto thread = GetThreadID();
+  const auto counters = SampleCounters();
+
+  std::unique_lock lock(gMutex);
+  gEvents.push_back({
+    .mCategory = std::string {mCategory},
+    .mName = std::string {mName},
+    .mThread = thread,
+    .mStart = mStart,
+    .mDuration = duration,
+  });
+  gCounterSamples.push_back(counters);
+}
+
+void WriteChromeTrace(std::ostream& out) {
+  std::unique_lock lock(gMutex);
+  gCounterSamples.push_back(SampleCounters());
+
+  out << R"({"displayTimeUnit":"ms","traceEvents":[)";
+  bool first = true;
+  const auto separator = [&first, &out] {
+    if (!std::exchange(first, false)) {
+      out << ",\n";
+    }
+  };
+
+  for (auto&& event: gEvents) {
+    separator();
+    out << R"({"ph":"X","pid":1,"name":)";
+    WriteJSONString(out, event.mName);
+    out << R"(,"cat":)";
+    WriteJSONString(out, event.mCategory);
+    out << std::format(
+      R"(,"tid":{},"ts":{},"dur":{}}})",
+      event.mThread,
+      ToMicroseconds(event.mStart - gEpoch),
+      ToMicroseconds(event.mDuration));
+  }
+
+  for (auto&& sample: gCounterSamples) {
+    separator();
+    out << std::format(
+      R"({{"ph":"C","pid":1,"name":"Counters","ts":{},"args":{{)",
+      ToMicroseconds(sample.mTime - gEpoch));
+    for (std::size_t i = 0; i < CounterCount; ++i) {
+      out << std::format(
+        R"({}"{}":{})", i ? "," : "", CounterNames[i], sample.mValues[i]);
+    }
+    out << "}}";
+  }
+  out << "]}\n";
+}
+
+bool WriteChromeTrace(const std::filesystem::path& path) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    return false;
+  }
+  WriteChromeTrace(out);
+  return out.good();
+}
+
+void Reset() {
+  std::unique_lock lock(gMutex);
+  gEvents.clear();
+  gCounterSamples.clear();
+  for (auto&& counter: gCounters) {
+    counter.store(0, std::memory_order_relaxed);
+  }
+  gEpoch = clock::now();
+}
+
+}// namespace Instrumentation
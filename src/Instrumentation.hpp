@@ -0,0 +1,77 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <string_view>
+
+// Lightweight tracing, exported in the Chrome trace event format; load the
+// output in `about:tracing` or https://ui.perfetto.dev
+//
+// Everything is a no-op unless `Enable()` has been called; when disabled, the
+// cost is a single relaxed atomic load.
+namespace Instrumentation {
+
+enum class Counter {
+  FilesVisited,
+  RegistryValuesRead,
+  KnownFolderLookups,
+  InstallerQueries,
+};
+
+// Environment variable containing a path to write the trace to
+constexpr std::string_view EnvironmentVariable {"OKB_FRESH_START_TRACE"};
+// Command line switch; `--trace=PATH`
+constexpr std::wstring_view CommandLineSwitch {L"--trace="};
+
+namespace detail {
+extern std::atomic<bool> gEnabled;
+void Increment(Counter, uint64_t);
+}// namespace detail
+
+[[nodiscard]] inline bool IsEnabled() noexcept {
+  return detail::gEnabled.load(std::memory_order_relaxed);
+}
+
+void Enable();
+// Enables tracing if requested by the environment or command line.
+//
+// Returns the path that the trace should be written to, if any.
+std::filesystem::path EnableFromEnvironment(std::wstring_view commandLine);
+
+inline void Increment(Counter counter, uint64_t by = 1) {
+  if (IsEnabled()) [[unlikely]] {
+    detail::Increment(counter, by);
+  }
+}
+
+[[nodiscard]] uint64_t GetCount(Counter);
+
+// Records a complete ('X') event covering the lifetime of this object.
+//
+// The strings must outlive the timer.
+class ScopedTimer {
+ public:
+  ScopedTimer() = delete;
+  ScopedTimer(std::string_view category, std::string_view name) noexcept;
+  ~ScopedTimer();
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  std::string_view mCategory;
+  std::string_view mName;
+  std::chrono::steady_clock::time_point mStart {};
+};
+
+void WriteChromeTrace(std::ostream&);
+bool WriteChromeTrace(const std::filesystem::path&);
+// Discard all recorded events and counter values
+void Reset();
+
+}// namespace Instrumentation
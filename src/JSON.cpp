@@ -0,0 +1,287 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "JSON.hpp"
+
+#include <format>
+#include <limits>
+#include <tuple>
+
+namespace {
+void AppendUTF8(std::string& out, const std::uint32_t codePoint) {
+  if (codePoint < 0x80) {
+    out.push_back(static_cast<char>(codePoint));
+  } else if (codePoint < 0x800) {
+    out.push_back(static_cast<char>(0xc0 | (codePoint >> 6)));
+    out.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+  } else if (codePoint < 0x10000) {
+    out.push_back(static_cast<char>(0xe0 | (codePoint >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+  } else {
+    out.push_back(static_cast<char>(0xf0 | (codePoint >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+  }
+}
+}// namespace
+
+void WriteJSONString(std::ostream& out, const std::string_view value) {
+  out << '"';
+  for (const char c: value) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\r':
+        out << "\\r";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          out << std::format("\\u{:04x}", static_cast<unsigned int>(c));
+        } else {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+}
+
+JSONReader::JSONReader(const std::string_view document)
+  : mDocument(document) {}
+
+void JSONReader::Fail(const std::string_view what) const {
+  throw JSONError(std::format("{} at offset {}", what, mOffset));
+}
+
+void JSONReader::SkipWhitespace() noexcept {
+  while (mOffset < mDocument.size()) {
+    switch (mDocument[mOffset]) {
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\r':
+        ++mOffset;
+        continue;
+      default:
+        return;
+    }
+  }
+}
+
+char JSONReader::Peek() {
+  SkipWhitespace();
+  if (mOffset >= mDocument.size()) {
+    Fail("Unexpected end of document");
+  }
+  return mDocument[mOffset];
+}
+
+void JSONReader::Expect(const char c) {
+  if (Peek() != c) {
+    Fail(std::format("Expected '{}'", c));
+  }
+  ++mOffset;
+}
+
+bool JSONReader::TryConsume(const char c) {
+  if (Peek() != c) {
+    return false;
+  }
+  ++mOffset;
+  return true;
+}
+
+void JSONReader::ExpectLiteral(const std::string_view literal) {
+  SkipWhitespace();
+  if (!mDocument.substr(mOffset).starts_with(literal)) {
+    Fail(std::format("Expected '{}'", literal));
+  }
+  mOffset += literal.size();
+}
+
+void JSONReader::EnterContainer(const char open) {
+  if (mDepth == MaxDepth) {
+    Fail("Too deeply nested");
+  }
+  Expect(open);
+  ++mDepth;
+}
+
+std::uint32_t JSONReader::ReadHex4() {
+  if (mDocument.size() - mOffset < 4) {
+    Fail("Truncated escape");
+  }
+  std::uint32_t ret = 0;
+  for (int i = 0; i < 4; ++i) {
+    const auto c = mDocument[mOffset++];
+    ret <<= 4;
+    if (c >= '0' && c <= '9') {
+      ret |= static_cast<std::uint32_t>(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      ret |= static_cast<std::uint32_t>(c - 'a' + 10);
+    } else if (c >= 'A' && c <= 'F') {
+      ret |= static_cast<std::uint32_t>(c - 'A' + 10);
+    } else {
+      Fail("Invalid escape");
+    }
+  }
+  return ret;
+}
+
+std::string JSONReader::ReadString() {
+  Expect('"');
+  std::string ret;
+  while (true) {
+    // Copy runs of plain characters at once; escapes are rare
+    const auto end = mDocument.find_first_of("\"\\", mOffset);
+    if (end == std::string_view::npos) {
+      mOffset = mDocument.size();
+      Fail("Unterminated string");
+    }
+    ret.append(mDocument.substr(mOffset, end - mOffset));
+    mOffset = end + 1;
+    if (mDocument[end] == '"') {
+      return ret;
+    }
+    if (mOffset >= mDocument.size()) {
+      Fail("Unterminated string");
+    }
+    switch (const auto c = mDocument[mOffset++]) {
+      case '"':
+      case '\\':
+      case '/':
+        ret.push_back(c);
+        break;
+      case 'b':
+        ret.push_back('\b');
+        break;
+      case 'f':
+        ret.push_back('\f');
+        break;
+      case 'n':
+        ret.push_back('\n');
+        break;
+      case 'r':
+        ret.push_back('\r');
+        break;
+      case 't':
+        ret.push_back('\t');
+        break;
+      case 'u': {
+        auto codePoint = ReadHex4();
+        if (codePoint >= 0xd800 && codePoint < 0xdc00) {
+          ExpectLiteral("\\u");
+          const auto low = ReadHex4();
+          if (low < 0xdc00 || low >= 0xe000) {
+            Fail("Invalid surrogate pair");
+          }
+          codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+        } else if (codePoint >= 0xdc00 && codePoint < 0xe000) {
+          Fail("Invalid surrogate pair");
+        }
+        AppendUTF8(ret, codePoint);
+        break;
+      }
+      default:
+        Fail("Invalid escape");
+    }
+  }
+}
+
+bool JSONReader::ReadBool() {
+  if (Peek() == 't') {
+    ExpectLiteral("true");
+    return true;
+  }
+  ExpectLiteral("false");
+  return false;
+}
+
+std::int64_t JSONReader::ReadInteger() {
+  const bool negative = TryConsume('-');
+  std::uint64_t value = 0;
+  const auto start = mOffset;
+  while (mOffset < mDocument.size() && mDocument[mOffset] >= '0'
+         && mDocument[mOffset] <= '9') {
+    const auto digit = static_cast<std::uint64_t>(mDocument[mOffset] - '0');
+    if (value > (std::numeric_limits<std::int64_t>::max() - digit) / 10) {
+      Fail("Integer out of range");
+    }
+    value = (value * 10) + digit;
+    ++mOffset;
+  }
+  if (mOffset == start) {
+    Fail("Expected an integer");
+  }
+  if (
+    mOffset < mDocument.size()
+    && (mDocument[mOffset] == '.' || mDocument[mOffset] == 'e'
+        || mDocument[mOffset] == 'E')) {
+    Fail("Expected an integer");
+  }
+  const auto ret = static_cast<std::int64_t>(value);
+  return negative ? -ret : ret;
+}
+
+bool JSONReader::TryReadNull() {
+  if (Peek() != 'n') {
+    return false;
+  }
+  ExpectLiteral("null");
+  return true;
+}
+
+void JSONReader::Skip() {
+  switch (Peek()) {
+    case '{':
+      ReadObject([this](std::string_view) { Skip(); });
+      return;
+    case '[':
+      ReadArray([this] { Skip(); });
+      return;
+    case '"':
+      std::ignore = ReadString();
+      return;
+    case 't':
+    case 'f':
+      std::ignore = ReadBool();
+      return;
+    case 'n':
+      ExpectLiteral("null");
+      return;
+    default:
+      break;
+  }
+  // A number; only its shape is checked
+  const auto start = mOffset;
+  while (mOffset < mDocument.size()) {
+    const auto c = mDocument[mOffset];
+    if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e'
+        || c == 'E') {
+      ++mOffset;
+      continue;
+    }
+    break;
+  }
+  if (mOffset == start) {
+    Fail("Expected a value");
+  }
+}
+
+void JSONReader::ExpectEnd() {
+  SkipWhitespace();
+  if (mOffset != mDocument.size()) {
+    Fail("Unexpected data after document");
+  }
+}
@@ -0,0 +1,93 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Minimal JSON support for the formats we write ourselves, e.g. traces and
+// scan reports; not a general-purpose library.
+
+// Writes `value`, which must be UTF-8, as a quoted and escaped JSON string
+void WriteJSONString(std::ostream&, std::string_view value);
+
+class JSONError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+// A pull parser: the caller reads values in the order it expects them, so
+// nothing is allocated for values it skips.
+//
+// Every method throws `JSONError` if the document is malformed, or the next
+// value isn't of the requested type.
+class JSONReader {
+ public:
+  JSONReader() = delete;
+  explicit JSONReader(std::string_view document);
+
+  // `onMember(key)` is called for each member, and must read or skip its
+  // value
+  template <class F>
+  void ReadObject(F&& onMember) {
+    EnterContainer('{');
+    if (TryConsume('}')) {
+      --mDepth;
+      return;
+    }
+    do {
+      const auto key = ReadString();
+      Expect(':');
+      onMember(std::string_view {key});
+    } while (TryConsume(','));
+    Expect('}');
+    --mDepth;
+  }
+
+  // `onElement()` is called for each element, and must read or skip it
+  template <class F>
+  void ReadArray(F&& onElement) {
+    EnterContainer('[');
+    if (TryConsume(']')) {
+      --mDepth;
+      return;
+    }
+    do {
+      onElement();
+    } while (TryConsume(','));
+    Expect(']');
+    --mDepth;
+  }
+
+  [[nodiscard]] std::string ReadString();
+  [[nodiscard]] bool ReadBool();
+  // Fractions and exponents are rejected
+  [[nodiscard]] std::int64_t ReadInteger();
+  // Consumes `null` if it's next
+  [[nodiscard]] bool TryReadNull();
+  // Any value, including nested objects and arrays
+  void Skip();
+  // Only whitespace may follow the document
+  void ExpectEnd();
+
+ private:
+  // Bounds recursion in `Skip()`, and in callers' nested containers
+  static constexpr std::size_t MaxDepth = 64;
+
+  std::string_view mDocument;
+  std::size_t mOffset {};
+  std::size_t mDepth {};
+
+  [[noreturn]] void Fail(std::string_view what) const;
+  void SkipWhitespace() noexcept;
+  [[nodiscard]] char Peek();
+  void Expect(char);
+  [[nodiscard]] bool TryConsume(char);
+  void ExpectLiteral(std::string_view);
+  void EnterContainer(char open);
+  [[nodiscard]] std::uint32_t ReadHex4();
+};
@@ -0,0 +1,96 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "KnownFolders.hpp"
+
+#include <utility>
+
+#include "FileSystem.hpp"
+
+namespace {
+bool Exists(const std::filesystem::path& path, std::error_code& ec) {
+  return RetryIfInUse(
+    [&path](auto& error) { return FileSystem::Get().Exists(path, error); },
+    ec);
+}
+}// namespace
+
+KnownFolders::KnownFolders(std::function<Roots()> resolver)
+  : mRoots(std::move(resolver)) {}
+
+KnownFolders::KnownFolders(Roots roots)
+  : mRoots([roots = std::move(roots)] { return roots; }) {}
+
+KnownFolders::~KnownFolders() = default;
+
+std::filesystem::path KnownFolders::GetRoot(KnownFolder folder) const {
+  switch (folder) {
+    case KnownFolder::Documents:
+      return mRoots->mDocuments;
+    case KnownFolder::LocalAppData:
+      return mRoots->mLocalAppData;
+    case KnownFolder::ProgramData:
+      return mRoots->mProgramData;
+    case KnownFolder::SavedGames:
+      return mRoots->mSavedGames;
+    case KnownFolder::Temp:
+      return mRoots->mTemp;
+  }
+  std::unreachable();
+}
+
+std::filesystem::path KnownFolders::GetPath(const Location& location) const {
+  const auto root = GetRoot(location.mRoot);
+  if (root.empty()) {
+    return {};
+  }
+  return root / location.mChild;
+}
+
+std::filesystem::path KnownFolders::FindChild(const Location& location) {
+  const auto path = GetPath(location);
+  if (path.empty()) {
+    return {};
+  }
+
+  std::unique_lock lock(mMutex);
+  auto it = mExists.find(path.wstring());
+  if (it == mExists.end()) {
+    CheckExpected();
+    it = mExists.find(path.wstring());
+  }
+  if (it == mExists.end()) {
+    std::error_code ec;
+    const auto exists = Exists(path, ec);
+    if (ec) {
+      return {};
+    }
+    it = mExists.emplace(path.wstring(), exists).first;
+  }
+  return it->second ? path : std::filesystem::path {};
+}
+
+void KnownFolders::Expect(std::span<const Location> locations) {
+  std::unique_lock lock(mMutex);
+  mExpected.insert(mExpected.end(), locations.begin(), locations.end());
+}
+
+void KnownFolders::Invalidate() {
+  std::unique_lock lock(mMutex);
+  mExists.clear();
+}
+
+void KnownFolders::CheckExpected() {
+  for (auto&& location: mExpected) {
+    const auto path = GetPath(location);
+    if (path.empty() || mExists.contains(path.wstring())) {
+      continue;
+    }
+    // Errors aren't cached, so they're retried by the next lookup; they're
+    // often brief, e.g. while an antivirus scanner has the folder open
+    std::error_code ec;
+    if (const auto exists = Exists(path, ec); !ec) {
+      mExists.emplace(path.wstring(), exists);
+    }
+  }
+}
@@ -0,0 +1,78 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Lazy.hpp"
+
+enum class KnownFolder {
+  Documents,
+  LocalAppData,
+  ProgramData,
+  SavedGames,
+  Temp,
+};
+
+// Resolves the folders that OpenKneeboard uses, and caches whether the
+// children we're interested in exist.
+//
+// Each root is resolved at most once. Locations registered with `Expect()`
+// are checked together on the first lookup that misses the cache, so
+// concurrent discovery probes share one pass over the filesystem.
+class KnownFolders {
+ public:
+  struct Roots {
+    std::filesystem::path mDocuments;
+    std::filesystem::path mLocalAppData;
+    std::filesystem::path mProgramData;
+    std::filesystem::path mSavedGames;
+    std::filesystem::path mTemp;
+  };
+
+  struct Location {
+    KnownFolder mRoot {};
+    std::wstring_view mChild;
+  };
+
+  KnownFolders() = delete;
+  // Resolved lazily, on first use
+  explicit KnownFolders(std::function<Roots()> resolver);
+  // Fixed roots, e.g. a temporary directory for testing
+  explicit KnownFolders(Roots roots);
+  ~KnownFolders();
+
+  KnownFolders(const KnownFolders&) = delete;
+  KnownFolders& operator=(const KnownFolders&) = delete;
+
+  // Uses the real folders for the current user
+  static KnownFolders& Get();
+
+  // Empty if the folder could not be resolved
+  [[nodiscard]] std::filesystem::path GetRoot(KnownFolder) const;
+  // Full path if it exists, otherwise empty
+  [[nodiscard]] std::filesystem::path FindChild(const Location&);
+
+  void Expect(std::span<const Location>);
+  // Forget which paths exist, e.g. after changes have been made
+  void Invalidate();
+
+ private:
+  Lazy<Roots> mRoots;
+
+  std::mutex mMutex;
+  std::vector<Location> mExpected;
+  // Keyed by full path
+  std::unordered_map<std::wstring, bool> mExists;
+
+  [[nodiscard]] std::filesystem::path GetPath(const Location&) const;
+  // Caller must hold mMutex
+  void CheckExpected();
+};
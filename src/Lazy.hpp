@@ -0,0 +1,42 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <optional>
+
+// A value that is computed the first time it is needed, then kept.
+//
+// Used for data that is only needed to show details, so that discovery only
+// needs to do the work required to detect an artifact.
+template <class T>
+class Lazy {
+ public:
+  Lazy() = delete;
+  explicit Lazy(std::function<T()> factory) : mFactory(std::move(factory)) {}
+
+  Lazy(const Lazy&) = delete;
+  Lazy& operator=(const Lazy&) = delete;
+
+  [[nodiscard]] const T& Get() const {
+    std::call_once(mOnce, [this] {
+      mValue.emplace(std::invoke(mFactory));
+      mFactory = {};
+    });
+    return *mValue;
+  }
+
+  const T& operator*() const {
+    return Get();
+  }
+
+  const T* operator->() const {
+    return &Get();
+  }
+
+ private:
+  mutable std::once_flag mOnce;
+  mutable std::function<T()> mFactory;
+  mutable std::optional<T> mValue;
+};
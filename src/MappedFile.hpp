@@ -0,0 +1,95 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <utility>
+
+// A read-only file that can be mapped into memory, so that its contents can
+// be used straight from the OS cache instead of being copied into our own
+// buffers; implemented per platform.
+//
+// Other processes may still read, write, or delete the file while it's open.
+class MappedFile {
+ public:
+  // Part of the file; unmapped when destroyed
+  class View {
+   public:
+    View() = default;
+    ~View() {
+      Reset();
+    }
+    View(View&& other) noexcept
+      : mBase(std::exchange(other.mBase, nullptr)),
+        mMappedSize(std::exchange(other.mMappedSize, 0)),
+        mData(std::exchange(other.mData, {})) {}
+    View& operator=(View&& other) noexcept {
+      if (this != &other) {
+        Reset();
+        mBase = std::exchange(other.mBase, nullptr);
+        mMappedSize = std::exchange(other.mMappedSize, 0);
+        mData = std::exchange(other.mData, {});
+      }
+      return *this;
+    }
+    View(const View&) = delete;
+    View& operator=(const View&) = delete;
+
+    [[nodiscard]] std::span<const std::byte> GetData() const noexcept {
+      return mData;
+    }
+    // Asks the OS to start reading the data in the background
+    void Prefetch() const noexcept;
+
+   private:
+    friend class MappedFile;
+
+    // Mappings must start on a platform-specific boundary, so may start
+    // before `mData`
+    void* mBase {nullptr};
+    std::size_t mMappedSize {};
+    std::span<const std::byte> mData;
+
+    void Reset() noexcept;
+  };
+
+  MappedFile() = delete;
+  ~MappedFile();
+  MappedFile(MappedFile&&) noexcept;
+  MappedFile& operator=(MappedFile&&) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // nullopt on failure
+  [[nodiscard]] static std::optional<MappedFile> Open(
+    const std::filesystem::path&,
+    std::error_code&);
+
+  // When the file was opened
+  [[nodiscard]] std::uint64_t GetSize() const noexcept;
+
+  // `offset` doesn't need to be aligned; `size` must not be zero
+  [[nodiscard]] View Map(
+    std::uint64_t offset,
+    std::size_t size,
+    std::error_code&) const;
+
+  // Copies into `buffer`, which is cheaper than mapping for small files.
+  // Returns the number of bytes read, which is only less than the buffer
+  // size at the end of the file.
+  [[nodiscard]] std::size_t
+  Read(std::uint64_t offset, std::span<std::byte> buffer, std::error_code&)
+    const;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> mImpl;
+
+  explicit MappedFile(std::unique_ptr<Impl>);
+};
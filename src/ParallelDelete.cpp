@@ -0,0 +1,284 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "ParallelDelete.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <variant>
+
+#include "FileSystem.hpp"
+#include "Instrumentation.hpp"
+
+namespace {
+
+struct Folder {
+  Folder(std::filesystem::path path, std::shared_ptr<Folder> parent)
+    : mPath(std::move(path)),
+      mParent(std::move(parent)) {}
+
+  std::filesystem::path mPath;
+  std::shared_ptr<Folder> mParent;
+  // Starts at one for the listing; each subfolder and each queued batch of
+  // files adds one. When this reaches zero, the folder is empty.
+  std::atomic<std::size_t> mPending {1};
+};
+
+struct ListFolder {
+  std::shared_ptr<Folder> mFolder;
+};
+
+struct File {
+  std::filesystem::path mPath;
+  // For progress
+  std::uintmax_t mSize {};
+};
+
+struct RemoveFiles {
+  std::shared_ptr<Folder> mFolder;
+  std::vector<File> mFiles;
+};
+
+// Something else removed it first, e.g. the program that created it
+bool IsNotFound(const std::error_code& ec) {
+  return ec == std::errc::no_such_file_or_directory;
+}
+
+bool RemoveOne(
+  FileSystem& fileSystem,
+  const std::filesystem::path& path,
+  std::error_code& ec) {
+  return RetryIfInUse(
+    [&](auto& error) { return fileSystem.Remove(path, error); }, ec);
+}
+
+DirectoryEntry GetEntry(
+  FileSystem& fileSystem,
+  const std::filesystem::path& path,
+  std::error_code& ec) {
+  return RetryIfInUse(
+    [&](auto& error) { return fileSystem.GetDirectoryEntry(path, error); },
+    ec);
+}
+
+std::vector<DirectoryEntry> List(
+  FileSystem& fileSystem,
+  const std::filesystem::path& path,
+  const ListingDetail detail,
+  std::error_code& ec) {
+  return RetryIfInUse(
+    [&](auto& error) { return fileSystem.ListDirectory(path, error, detail); },
+    ec);
+}
+
+using Task = std::variant<ListFolder, RemoveFiles>;
+
+class Engine {
+ public:
+  Engine(const ParallelDelete::Options& options, Progress* progress)
+    : mOptions(options),
+      mProgress(progress) {}
+
+  void Push(Task&& task) {
+    std::unique_lock lock(mMutex);
+    ++mOutstanding;
+    mTasks.push_back(std::move(task));
+    mChanged.notify_one();
+  }
+
+  void Worker() {
+    std::unique_lock lock(mMutex);
+    while (true) {
+      mChanged.wait(
+        lock, [this] { return !mTasks.empty() || mOutstanding == 0; });
+      if (mTasks.empty()) {
+        return;
+      }
+      // Depth-first, to limit how many paths are queued at once
+      auto task = std::move(mTasks.back());
+      mTasks.pop_back();
+      lock.unlock();
+
+      // Abandoned tasks don't queue anything else, so this drains quickly
+      if (!mOptions.mStopToken.stop_requested()) {
+        std::visit([this](auto& it) { Process(it); }, task);
+      }
+
+      lock.lock();
+      if (--mOutstanding == 0) {
+        mChanged.notify_all();
+      }
+    }
+  }
+
+  ParallelDelete::Result TakeResult() {
+    return {
+      .mRemovedCount = mRemovedCount.load(),
+      .mErrors = std::move(mErrors),
+    };
+  }
+
+ private:
+  ParallelDelete::Options mOptions;
+  Progress* mProgress {nullptr};
+  FileSystem& mFileSystem {FileSystem::Get()};
+
+  std::mutex mMutex;
+  std::condition_variable mChanged;
+  std::vector<Task> mTasks;
+  std::size_t mOutstanding {};
+
+  std::atomic<std::uintmax_t> mRemovedCount {};
+  std::mutex mErrorsMutex;
+  std::vector<ParallelDelete::Error> mErrors;
+
+  void RecordError(const std::filesystem::path& path, std::error_code ec) {
+    std::unique_lock lock(mErrorsMutex);
+    mErrors.push_back({path, ec});
+  }
+
+  void Remove(const std::filesystem::path& path, std::uintmax_t size = 0) {
+    std::error_code ec;
+    if (RemoveOne(mFileSystem, path, ec)) {
+      ++mRemovedCount;
+      if (mProgress) {
+        mProgress->Add({.mBytes = size, .mFiles = 1});
+      }
+    } else if (ec && !IsNotFound(ec)) {
+      RecordError(path, ec);
+    }
+  }
+
+  // Drop one pending item; remove the folder, and possibly its parents, if
+  // they're now empty
+  void Release(std::shared_ptr<Folder> folder) {
+    while (folder && folder->mPending.fetch_sub(1) == 1) {
+      Remove(folder->mPath);
+      folder = folder->mParent;
+    }
+  }
+
+  void Process(ListFolder& task) {
+    const auto& folder = task.mFolder;
+    std::vector<File> batch;
+
+    // Sizes are only needed for progress
+    const auto detail
+      = mProgress ? ListingDetail::Full : ListingDetail::TypeOnly;
+    std::error_code ec;
+    auto entries = List(mFileSystem, folder->mPath, detail, ec);
+    if (ec && !IsNotFound(ec)) {
+      RecordError(folder->mPath, ec);
+    }
+    for (auto&& it: entries) {
+      if (mOptions.mStopToken.stop_requested()) {
+        return;
+      }
+      // Links and junctions are removed rather than followed
+      if (it.mIsDirectory) {
+        ++folder->mPending;
+        Push(
+          ListFolder {std::make_shared<Folder>(std::move(it.mPath), folder)});
+        continue;
+      }
+
+      batch.push_back({std::move(it.mPath), it.mSize});
+      if (batch.size() >= mOptions.mBatchSize) {
+        ++folder->mPending;
+        Push(RemoveFiles {folder, std::exchange(batch, {})});
+      }
+    }
+
+    // Not worth queueing the last partial batch
+    for (auto&& [path, size]: batch) {
+      Remove(path, size);
+    }
+    Release(folder);
+  }
+
+  void Process(RemoveFiles& task) {
+    for (auto&& [path, size]: task.mFiles) {
+      Remove(path, size);
+    }
+    Release(task.mFolder);
+  }
+};
+
+}// namespace
+
+ParallelDelete::ParallelDelete(const Options& options) : mOptions(options) {}
+
+ParallelDelete::Result ParallelDelete::Remove(
+  const std::filesystem::path& root,
+  Progress* progress) const {
+  const Instrumentation::ScopedTimer timer {"Remove", "ParallelDelete"};
+
+  auto& fileSystem = FileSystem::Get();
+  std::error_code ec;
+  const auto entry = GetEntry(fileSystem, root, ec);
+  if (IsNotFound(ec)) {
+    return {};
+  }
+  if (ec) {
+    return {.mErrors = {{root, ec}}};
+  }
+  if (!entry.mIsDirectory) {
+    if (RemoveOne(fileSystem, root, ec)) {
+      if (progress) {
+        progress->Add({.mBytes = entry.mSize, .mFiles = 1});
+      }
+      return {.mRemovedCount = 1};
+    }
+    if (!ec || IsNotFound(ec)) {
+      return {};
+    }
+    return {.mErrors = {{root, ec}}};
+  }
+
+  Engine engine {mOptions, progress};
+  engine.Push(ListFolder {std::make_shared<Folder>(root, nullptr)});
+  {
+    // The calling thread is one of the workers
+    std::vector<std::jthread> threads;
+    const auto threadCount = std::max<std::size_t>(mOptions.mThreadCount, 1);
+    threads.reserve(threadCount - 1);
+    for (std::size_t i = 1; i < threadCount; ++i) {
+      threads.emplace_back(&Engine::Worker, &engine);
+    }
+    engine.Worker();
+  }
+  return engine.TakeResult();
+}
+
+WorkAmount ParallelDelete::Measure(const std::filesystem::path& root) {
+  const Instrumentation::ScopedTimer timer {"Measure", "ParallelDelete"};
+
+  auto& fileSystem = FileSystem::Get();
+  std::error_code ec;
+  const auto entry = GetEntry(fileSystem, root, ec);
+  if (ec) {
+    return {};
+  }
+  if (!entry.mIsDirectory) {
+    return {.mBytes = entry.mSize, .mFiles = 1};
+  }
+  WorkAmount ret {.mFiles = 1};
+
+  // Errors are ignored: this is only an estimate
+  std::vector<std::filesystem::path> pending {root};
+  while (!pending.empty()) {
+    const auto folder = std::move(pending.back());
+    pending.pop_back();
+    for (auto&& it: List(fileSystem, folder, ListingDetail::Full, ec)) {
+      ret += {.mBytes = it.mSize, .mFiles = 1};
+      if (it.mIsDirectory) {
+        pending.push_back(std::move(it.mPath));
+      }
+    }
+  }
+  return ret;
+}
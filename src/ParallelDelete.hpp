@@ -0,0 +1,62 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <stop_token>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "Progress.hpp"
+
+// Recursively deletes a file or folder, like `std::filesystem::remove_all()`,
+// but using several threads.
+//
+// Folders are listed in parallel, files are removed in batches as they are
+// found, and each folder is removed as soon as everything inside it has
+// been. Failures don't stop the deletion; they are collected instead.
+//
+// Sharing violations are retried, and anything that something else removes
+// first is skipped; see `FileSystem`.
+class ParallelDelete {
+ public:
+  struct Options {
+    std::size_t mThreadCount {std::thread::hardware_concurrency()};
+    // Files in a single folder are split into batches of this size, so that
+    // large flat folders (e.g. logs) are also deleted in parallel
+    std::size_t mBatchSize {256};
+    // If stopped, `Remove()` returns soon, leaving anything not yet removed
+    std::stop_token mStopToken;
+  };
+
+  struct Error {
+    std::filesystem::path mPath;
+    std::error_code mError;
+  };
+
+  struct Result {
+    // Files and folders, including the root
+    std::uintmax_t mRemovedCount {};
+    std::vector<Error> mErrors;
+  };
+
+  ParallelDelete() = default;
+  explicit ParallelDelete(const Options& options);
+
+  // Removing something that doesn't exist, or stops existing while this is
+  // running, is not an error.
+  //
+  // If `progress` is provided, each removed file and folder is added to it.
+  [[nodiscard]] Result Remove(
+    const std::filesystem::path& root,
+    Progress* progress = nullptr) const;
+
+  // A quick single-threaded pre-scan, counting what `Remove()` would, for
+  // progress totals
+  [[nodiscard]] static WorkAmount Measure(const std::filesystem::path& root);
+
+ private:
+  Options mOptions;
+};
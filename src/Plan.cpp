@@ -0,0 +1,319 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "Plan.hpp"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace {
+// Format:
+//
+// - `Magic`, then the version as a varint
+// - the step count, then for each step: title, action, operation count
+// - the operations, in order; each is its kind and target, then registry
+//   fields for registry operations, or the source count and sources for
+//   backups, then the estimate
+//
+// Integers are unsigned LEB128 varints; strings are a varint byte count,
+// followed by UTF-8.
+constexpr std::array Magic {
+  std::byte {'O'},
+  std::byte {'K'},
+  std::byte {'B'},
+  std::byte {'P'},
+  std::byte {'L'},
+  std::byte {'A'},
+  std::byte {'N'},
+  std::byte {'\n'},
+};
+constexpr std::uint64_t FormatVersion = 1;
+
+using Kind = PlannedOperation::Kind;
+
+bool IsRegistryOperation(const Kind kind) {
+  return kind == Kind::DeleteRegistryValue || kind == Kind::SetRegistryDWORD;
+}
+
+std::string ToUTF8(const std::wstring& value) {
+  const auto ret = std::filesystem::path {value}.u8string();
+  return {ret.begin(), ret.end()};
+}
+
+std::wstring FromUTF8(const std::string_view value) {
+  return std::filesystem::path {std::u8string {value.begin(), value.end()}}
+    .wstring();
+}
+
+class Writer {
+ public:
+  void WriteBytes(std::span<const std::byte> bytes) {
+    mBuffer.insert(mBuffer.end(), bytes.begin(), bytes.end());
+  }
+
+  void WriteInteger(std::uint64_t value) {
+    do {
+      auto byte = static_cast<std::uint8_t>(value & 0x7f);
+      value >>= 7;
+      if (value) {
+        byte |= 0x80;
+      }
+      mBuffer.push_back(std::byte {byte});
+    } while (value);
+  }
+
+  void WriteString(const std::string_view value) {
+    WriteInteger(value.size());
+    WriteBytes(std::as_bytes(std::span {value}));
+  }
+
+  void WriteString(const std::wstring& value) {
+    WriteString(ToUTF8(value));
+  }
+
+  std::vector<std::byte> Take() && {
+    return std::move(mBuffer);
+  }
+
+ private:
+  std::vector<std::byte> mBuffer;
+};
+
+class Reader {
+ public:
+  explicit Reader(std::span<const std::byte> data) : mData(data) {}
+
+  std::span<const std::byte> ReadBytes(const std::size_t count) {
+    if (count > mData.size()) {
+      throw std::runtime_error("Plan is truncated");
+    }
+    const auto ret = mData.first(count);
+    mData = mData.subspan(count);
+    return ret;
+  }
+
+  std::uint64_t ReadInteger() {
+    std::uint64_t ret = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      const auto byte = std::to_integer<std::uint8_t>(ReadBytes(1).front());
+      ret |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return ret;
+      }
+    }
+    throw std::runtime_error("Plan contains an invalid integer");
+  }
+
+  // Also checks that the value fits in `T`, or is a valid enum value
+  template <class T>
+  T ReadInteger(const std::uint64_t max) {
+    const auto value = ReadInteger();
+    if (value > max) {
+      throw std::runtime_error("Plan contains an out-of-range value");
+    }
+    return static_cast<T>(value);
+  }
+
+  // Counts are also limited by the remaining size, so that corrupt data
+  // can't make us allocate huge amounts of memory
+  std::size_t ReadCount() {
+    return ReadInteger<std::size_t>(mData.size());
+  }
+
+  std::string ReadString() {
+    const auto bytes = ReadBytes(ReadCount());
+    return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+  }
+
+  std::wstring ReadWideString() {
+    return FromUTF8(ReadString());
+  }
+
+  [[nodiscard]] bool IsAtEnd() const noexcept {
+    return mData.empty();
+  }
+
+ private:
+  std::span<const std::byte> mData;
+};
+
+template <class T>
+constexpr auto MaxValue(const T last) {
+  return static_cast<std::uint64_t>(std::to_underlying(last));
+}
+
+}// namespace
+
+void Plan::Builder::AddStep(
+  std::string title,
+  const Action action,
+  std::vector<PlannedOperation> operations) {
+  mSteps.push_back({
+    .mTitle = std::move(title),
+    .mAction = action,
+    .mFirstOperation = mOperations.size(),
+    .mOperationCount = operations.size(),
+  });
+  mOperations.insert(
+    mOperations.end(),
+    std::make_move_iterator(operations.begin()),
+    std::make_move_iterator(operations.end()));
+}
+
+Plan Plan::Builder::Build() && {
+  Plan ret;
+  ret.mSteps = std::move(mSteps);
+  ret.mOperations = std::move(mOperations);
+  return ret;
+}
+
+WorkAmount Plan::GetEstimate(const Step& step) const {
+  WorkAmount ret;
+  for (auto&& it: GetOperations(step)) {
+    ret += it.mEstimate;
+  }
+  return ret;
+}
+
+std::vector<std::byte> Plan::Serialize() const {
+  Writer writer;
+  writer.WriteBytes(Magic);
+  writer.WriteInteger(FormatVersion);
+
+  writer.WriteInteger(mSteps.size());
+  for (auto&& step: mSteps) {
+    writer.WriteString(step.mTitle);
+    writer.WriteInteger(std::to_underlying(step.mAction));
+    writer.WriteInteger(step.mOperationCount);
+  }
+
+  for (auto&& it: mOperations) {
+    writer.WriteInteger(std::to_underlying(it.mKind));
+    writer.WriteString(it.mTarget);
+    if (IsRegistryOperation(it.mKind)) {
+      writer.WriteInteger(std::to_underlying(it.mHive));
+      writer.WriteInteger(std::to_underlying(it.mView));
+      writer.WriteString(it.mValueName);
+      writer.WriteInteger(it.mData);
+    }
+    if (it.mKind == Kind::BackupPaths) {
+      writer.WriteInteger(it.mSources.size());
+      for (auto&& source: it.mSources) {
+        writer.WriteString(source);
+      }
+    }
+    writer.WriteInteger(it.mEstimate.mBytes);
+    writer.WriteInteger(it.mEstimate.mFiles);
+  }
+  return std::move(writer).Take();
+}
+
+Plan Plan::Deserialize(const std::span<const std::byte> data) {
+  Reader reader {data};
+  if (!std::ranges::equal(reader.ReadBytes(Magic.size()), Magic)) {
+    throw std::runtime_error("Not a plan");
+  }
+  if (const auto version = reader.ReadInteger(); version != FormatVersion) {
+    throw std::runtime_error(
+      std::format("Unsupported plan version {}", version));
+  }
+
+  Plan ret;
+  std::size_t operationCount = 0;
+  ret.mSteps.resize(reader.ReadCount());
+  for (auto&& step: ret.mSteps) {
+    step.mTitle = reader.ReadString();
+    step.mAction = reader.ReadInteger<Action>(MaxValue(Action::Backup));
+    step.mFirstOperation = operationCount;
+    step.mOperationCount = reader.ReadCount();
+    operationCount += step.mOperationCount;
+  }
+
+  if (operationCount > data.size()) {
+    throw std::runtime_error("Plan is truncated");
+  }
+  ret.mOperations.resize(operationCount);
+  for (auto&& it: ret.mOperations) {
+    it.mKind = reader.ReadInteger<Kind>(MaxValue(Kind::BackupPaths));
+    it.mTarget = reader.ReadWideString();
+    if (IsRegistryOperation(it.mKind)) {
+      it.mHive
+        = reader.ReadInteger<RegistryHive>(MaxValue(RegistryHive::LocalMachine));
+      it.mView
+        = reader.ReadInteger<RegistryView>(MaxValue(RegistryView::Bits32));
+      it.mValueName = reader.ReadWideString();
+      it.mData = reader.ReadInteger<std::uint32_t>(
+        std::numeric_limits<std::uint32_t>::max());
+    }
+    if (it.mKind == Kind::BackupPaths) {
+      it.mSources.resize(reader.ReadCount());
+      for (auto&& source: it.mSources) {
+        source = reader.ReadWideString();
+      }
+    }
+    it.mEstimate.mBytes = reader.ReadInteger();
+    it.mEstimate.mFiles = reader.ReadInteger();
+  }
+
+  if (!reader.IsAtEnd()) {
+    throw std::runtime_error("Plan has trailing data");
+  }
+  return ret;
+}
+
+std::string Describe(const PlannedOperation& it) {
+  const auto target = ToUTF8(it.mTarget);
+  const auto registryValue = [&] {
+    const auto hive
+      = it.mHive == RegistryHive::LocalMachine ? "HKLM" : "HKCU";
+    const auto view = [&] {
+      switch (it.mView) {
+        case RegistryView::Default:
+          return "";
+        case RegistryView::Bits64:
+          return " (64-bit)";
+        case RegistryView::Bits32:
+          return " (32-bit)";
+      }
+      std::unreachable();
+    }();
+    return std::format("{}\\{}\\{}{}", hive, target, ToUTF8(it.mValueName), view);
+  };
+
+  switch (it.mKind) {
+    case Kind::RemovePath: {
+      if (it.mEstimate == WorkAmount {}) {
+        return std::format("Remove {}", target);
+      }
+      return std::format(
+        "Remove {} ({}, {} files)",
+        target,
+        FormatBytes(it.mEstimate.mBytes),
+        it.mEstimate.mFiles);
+    }
+    case Kind::DeleteRegistryValue:
+      return std::format("Delete {}", registryValue());
+    case Kind::SetRegistryDWORD:
+      return std::format("Set {} to {}", registryValue(), it.mData);
+    case Kind::UninstallMSIProduct:
+      return std::format("Uninstall MSI product {}", target);
+    case Kind::RepairMSIProduct:
+      return std::format("Repair MSI product {}", target);
+    case Kind::RemoveMSIXPackage:
+      return std::format("Remove MSIX package {}", target);
+    case Kind::BackupPaths: {
+      std::string sources;
+      for (auto&& source: it.mSources) {
+        sources += sources.empty() ? "" : ", ";
+        sources += ToUTF8(source);
+      }
+      return std::format("Back up {} to {}", sources, target);
+    }
+  }
+  std::unreachable();
+}
@@ -0,0 +1,191 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "ChangeSource.hpp"
+#include "Progress.hpp"
+#include "Registry.hpp"
+
+// A single concrete change to the system; see `Plan`
+struct PlannedOperation {
+  enum class Kind : std::uint8_t {
+    // A file or folder, recursively; removing something that doesn't exist
+    // is not an error
+    RemovePath,
+    DeleteRegistryValue,
+    SetRegistryDWORD,
+    UninstallMSIProduct,
+    RepairMSIProduct,
+    RemoveMSIXPackage,
+    // Copies `mSources` into a new archive at `mTarget`; see `BackupArchive`
+    BackupPaths,
+  };
+  Kind mKind {};
+  // A path, registry subkey, MSI product code, MSIX package full name, or
+  // backup archive
+  std::wstring mTarget;
+
+  // Only used by registry operations
+  RegistryHive mHive {};
+  RegistryView mView {};
+  std::wstring mValueName;
+  std::uint32_t mData {};
+
+  // Only used by `Kind::BackupPaths`
+  std::vector<std::wstring> mSources;
+
+  // What applying this is expected to report to its `Progress`; empty if
+  // unknown, or if it doesn't touch files
+  WorkAmount mEstimate;
+
+  bool operator==(const PlannedOperation&) const = default;
+
+  static PlannedOperation RemovePath(
+    const std::filesystem::path& path,
+    const WorkAmount& estimate = {}) {
+    return {
+      .mKind = Kind::RemovePath,
+      .mTarget = path.wstring(),
+      .mEstimate = estimate,
+    };
+  }
+
+  static PlannedOperation DeleteRegistryValue(
+    RegistryHive hive,
+    RegistryView view,
+    std::wstring subKey,
+    std::wstring valueName) {
+    return {
+      .mKind = Kind::DeleteRegistryValue,
+      .mTarget = std::move(subKey),
+      .mHive = hive,
+      .mView = view,
+      .mValueName = std::move(valueName),
+    };
+  }
+
+  static PlannedOperation SetRegistryDWORD(
+    RegistryHive hive,
+    RegistryView view,
+    std::wstring subKey,
+    std::wstring valueName,
+    std::uint32_t data) {
+    return {
+      .mKind = Kind::SetRegistryDWORD,
+      .mTarget = std::move(subKey),
+      .mHive = hive,
+      .mView = view,
+      .mValueName = std::move(valueName),
+      .mData = data,
+    };
+  }
+
+  static PlannedOperation UninstallMSIProduct(std::wstring productCode) {
+    return {.mKind = Kind::UninstallMSIProduct, .mTarget = productCode};
+  }
+
+  static PlannedOperation RepairMSIProduct(std::wstring productCode) {
+    return {.mKind = Kind::RepairMSIProduct, .mTarget = productCode};
+  }
+
+  static PlannedOperation RemoveMSIXPackage(std::wstring packageFullName) {
+    return {.mKind = Kind::RemoveMSIXPackage, .mTarget = packageFullName};
+  }
+
+  static PlannedOperation BackupPaths(
+    const std::filesystem::path& archive,
+    std::span<const std::filesystem::path> sources,
+    const WorkAmount& estimate = {}) {
+    PlannedOperation ret {
+      .mKind = Kind::BackupPaths,
+      .mTarget = archive.wstring(),
+      .mEstimate = estimate,
+    };
+    for (auto&& it: sources) {
+      ret.mSources.push_back(it.wstring());
+    }
+    return ret;
+  }
+};
+
+// Everything a cleanup run will do, decided before anything is changed.
+//
+// Plans are immutable, and contain no references to artifacts: they can be
+// saved, inspected, and applied later by `PlanApplier.hpp` without
+// discovering anything again, and a finished run can be checked against
+// its plan.
+//
+// Each step corresponds to an artifact, and owns a contiguous range of the
+// flat operation list, which is applied in order.
+class Plan {
+ public:
+  enum class Action : std::uint8_t {
+    Remove,
+    Repair,
+    // Not an artifact; see `PlannedOperation::Kind::BackupPaths`
+    Backup,
+  };
+
+  struct Step {
+    // The artifact's title, as in `ArtifactRegistry`, unless this is a
+    // backup
+    std::string mTitle;
+    Action mAction {};
+    std::size_t mFirstOperation {};
+    std::size_t mOperationCount {};
+
+    bool operator==(const Step&) const = default;
+  };
+
+  class Builder {
+   public:
+    void AddStep(
+      std::string title,
+      Action action,
+      std::vector<PlannedOperation> operations);
+    [[nodiscard]] Plan Build() &&;
+
+   private:
+    std::vector<Step> mSteps;
+    std::vector<PlannedOperation> mOperations;
+  };
+
+  Plan() = default;
+
+  [[nodiscard]] std::span<const Step> GetSteps() const noexcept {
+    return mSteps;
+  }
+  [[nodiscard]] std::span<const PlannedOperation> GetOperations()
+    const noexcept {
+    return mOperations;
+  }
+  [[nodiscard]] std::span<const PlannedOperation> GetOperations(
+    const Step& step) const {
+    return GetOperations().subspan(
+      step.mFirstOperation, step.mOperationCount);
+  }
+  // Sum of the operations' estimates
+  [[nodiscard]] WorkAmount GetEstimate(const Step&) const;
+
+  // A compact binary encoding; strings are stored as UTF-8
+  [[nodiscard]] std::vector<std::byte> Serialize() const;
+  // Throws `std::runtime_error` if the data is truncated, corrupt, or from
+  // an unsupported version
+  [[nodiscard]] static Plan Deserialize(std::span<const std::byte>);
+
+  bool operator==(const Plan&) const = default;
+
+ private:
+  std::vector<Step> mSteps;
+  std::vector<PlannedOperation> mOperations;
+};
+
+// One line for people, e.g. "Remove C:\foo (1.2 GB, 34 files)"
+[[nodiscard]] std::string Describe(const PlannedOperation&);
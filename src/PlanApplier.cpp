@@ -0,0 +1,204 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "PlanApplier.hpp"
+
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <utility>
+
+#include "BackupArchive.hpp"
+#include "FileSystem.hpp"
+#include "Instrumentation.hpp"
+#include "ParallelDelete.hpp"
+#include "ThreadPool.hpp"
+#include "TombstoneReaper.hpp"
+
+namespace {
+Task<> RemovePath(
+  const std::filesystem::path path,
+  Progress& progress,
+  const std::stop_token stopToken) {
+  co_await ThreadPool::GetShared().Schedule();
+
+  // Folders are usually renamed out of the way, then deleted in the
+  // background; single files aren't worth it
+  std::error_code ec;
+  const auto entry = RetryIfInUse(
+    [&path](auto& error) {
+      return FileSystem::Get().GetDirectoryEntry(path, error);
+    },
+    ec);
+  if (entry.mIsDirectory && TombstoneReaper::Get().Bury(path)) {
+    co_return;
+  }
+
+  // Probably in use; remove as much as we can
+  const auto result
+    = ParallelDelete {{.mStopToken = stopToken}}.Remove(path, &progress);
+  Instrumentation::Increment(
+    Instrumentation::Counter::FilesVisited, result.mRemovedCount);
+  if (result.mErrors.empty() || stopToken.stop_requested()) {
+    co_return;
+  }
+  // Everything that could be removed has been; report the first failure
+  const auto& [errorPath, error] = result.mErrors.front();
+  throw std::filesystem::filesystem_error(
+    std::format(
+      "Failed to remove {} of the items in the folder",
+      result.mErrors.size()),
+    errorPath,
+    error);
+}
+
+Task<> BackupPaths(
+  const PlannedOperation& operation,
+  Progress& progress,
+  const std::stop_token stopToken) {
+  co_await ThreadPool::GetShared().Schedule();
+
+  const std::filesystem::path archive {operation.mTarget};
+  if (!archive.is_absolute()) {
+    throw std::filesystem::filesystem_error(
+      "Backup location is not a full path",
+      archive,
+      std::make_error_code(std::errc::invalid_argument));
+  }
+  const std::vector<std::filesystem::path> sources {
+    operation.mSources.begin(), operation.mSources.end()};
+  std::filesystem::create_directories(archive.parent_path());
+  // False if stopped, in which case no archive is left behind
+  (void)BackupArchive {{.mStopToken = stopToken}}.Create(
+    archive, sources, &progress);
+}
+
+RegistryValueLocation GetRegistryValueLocation(
+  const PlannedOperation& operation) {
+  return {
+    .mHive = operation.mHive,
+    .mView = operation.mView,
+    .mSubKey = operation.mTarget,
+    .mValueName = operation.mValueName,
+  };
+}
+
+// Returns false if this isn't a registry operation
+bool AddToBatch(RegistryBatch& batch, const PlannedOperation& operation) {
+  switch (operation.mKind) {
+    case PlannedOperation::Kind::DeleteRegistryValue:
+      batch.DeleteValue(GetRegistryValueLocation(operation));
+      return true;
+    case PlannedOperation::Kind::SetRegistryDWORD:
+      batch.SetDWORD(GetRegistryValueLocation(operation), operation.mData);
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Registry changes are quick enough to do inline
+Task<> ApplyBatch(Registry& registry, const RegistryBatch batch) {
+  registry.Apply(batch);
+  co_return;
+}
+}// namespace
+
+Task<> ApplyStep(
+  const Plan& plan,
+  const Plan::Step& step,
+  Progress& progress,
+  const std::stop_token stopToken,
+  Registry& registry) {
+  const Instrumentation::ScopedTimer timer {"Apply", step.mTitle};
+  std::exception_ptr firstError;
+
+  RegistryBatch batch;
+  const auto applyBatch = [&] {
+    if (batch.IsEmpty()) {
+      return;
+    }
+    try {
+      registry.Apply(batch);
+    } catch (...) {
+      if (!firstError) {
+        firstError = std::current_exception();
+      }
+    }
+    batch = {};
+  };
+
+  for (auto&& it: plan.GetOperations(step)) {
+    if (stopToken.stop_requested()) {
+      co_return;
+    }
+    if (AddToBatch(batch, it)) {
+      continue;
+    }
+    applyBatch();
+    try {
+      co_await ApplyOperation(it, progress, stopToken, registry);
+    } catch (...) {
+      if (!firstError) {
+        firstError = std::current_exception();
+      }
+    }
+  }
+  if (!stopToken.stop_requested()) {
+    applyBatch();
+  }
+  if (firstError) {
+    std::rethrow_exception(firstError);
+  }
+}
+
+Task<> ApplyOperation(
+  const PlannedOperation& operation,
+  Progress& progress,
+  const std::stop_token stopToken,
+  Registry& registry) {
+  if (operation.mKind == PlannedOperation::Kind::RemovePath) {
+    return RemovePath(operation.mTarget, progress, stopToken);
+  }
+  if (operation.mKind == PlannedOperation::Kind::BackupPaths) {
+    return BackupPaths(operation, progress, stopToken);
+  }
+  if (RegistryBatch batch; AddToBatch(batch, operation)) {
+    return ApplyBatch(registry, std::move(batch));
+  }
+  return PlanApplierDetail::ApplySystemOperation(operation, stopToken);
+}
+
+bool IsApplied(const PlannedOperation& operation, const Registry& registry) {
+  switch (operation.mKind) {
+    case PlannedOperation::Kind::RemovePath: {
+      std::error_code ec;
+      return std::filesystem::symlink_status(operation.mTarget, ec).type()
+        == std::filesystem::file_type::not_found;
+    }
+    case PlannedOperation::Kind::BackupPaths: {
+      std::error_code ec;
+      return std::filesystem::is_regular_file(operation.mTarget, ec);
+    }
+    case PlannedOperation::Kind::DeleteRegistryValue:
+      return !registry.HasValue(GetRegistryValueLocation(operation));
+    case PlannedOperation::Kind::SetRegistryDWORD:
+      return registry.GetDWORD(GetRegistryValueLocation(operation))
+        == operation.mData;
+    default:
+      return PlanApplierDetail::IsSystemOperationApplied(operation);
+  }
+}
+
+std::vector<std::size_t> FindUnappliedOperations(
+  const Plan& plan,
+  const Registry& registry) {
+  std::vector<std::size_t> ret;
+  const auto operations = plan.GetOperations();
+  for (std::size_t i = 0; i < operations.size(); ++i) {
+    if (!IsApplied(operations[i], registry)) {
+      ret.push_back(i);
+    }
+  }
+  return ret;
+}
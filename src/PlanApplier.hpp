@@ -0,0 +1,55 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <stop_token>
+#include <vector>
+
+#include "Plan.hpp"
+#include "Progress.hpp"
+#include "Registry.hpp"
+#include "Task.hpp"
+
+// Applies a step of a `Plan`, without looking at any artifacts again.
+//
+// Every operation is attempted, even if an earlier one failed; the first
+// failure is then rethrown. If `stopToken` is stopped, the remaining
+// operations are skipped.
+//
+// Consecutive registry operations are applied as one `RegistryBatch`, so
+// either all of them take effect, or none do.
+//
+// The plan and registry must outlive the task.
+[[nodiscard]] Task<> ApplyStep(
+  const Plan& plan,
+  const Plan::Step& step,
+  Progress& progress,
+  std::stop_token stopToken,
+  Registry& registry = Registry::Get());
+
+// Removing or backing up files adds them to `progress`; other operations only
+// report failures, by throwing
+[[nodiscard]] Task<> ApplyOperation(
+  const PlannedOperation& operation,
+  Progress& progress,
+  std::stop_token stopToken,
+  Registry& registry = Registry::Get());
+
+// Whether the operation's effect is currently in place, e.g. after a run
+[[nodiscard]] bool IsApplied(
+  const PlannedOperation&,
+  const Registry& registry = Registry::Get());
+
+// Indices of the operations in `plan` whose effects are not in place
+[[nodiscard]] std::vector<std::size_t> FindUnappliedOperations(
+  const Plan&,
+  const Registry& registry = Registry::Get());
+
+namespace PlanApplierDetail {
+// Windows Installer and MSIX operations; implemented per platform
+[[nodiscard]] Task<> ApplySystemOperation(
+  const PlannedOperation&,
+  std::stop_token);
+[[nodiscard]] bool IsSystemOperationApplied(const PlannedOperation&);
+}// namespace PlanApplierDetail
@@ -0,0 +1,176 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "PlanRunner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "PlanApplier.hpp"
+
+namespace {
+const ArtifactDescriptor* FindDescriptor(
+  const std::span<const ArtifactDescriptor> artifactTypes,
+  const std::string_view title) {
+  const auto it = std::ranges::find(
+    artifactTypes, title, [](const auto& descriptor) {
+      return descriptor.mMetadata.mTitle;
+    });
+  if (it == artifactTypes.end()) {
+    return nullptr;
+  }
+  return &*it;
+}
+
+// Set once the settings backup has finished; shared with every action
+using BackupState = std::shared_ptr<std::atomic<bool>>;
+
+Task<> BackUpSettings(
+  const Plan& plan,
+  const Plan::Step& step,
+  Progress& progress,
+  const BackupState backedUp,
+  const std::stop_token stop) {
+  co_await ApplyStep(plan, step, progress, stop);
+  // If stopped, there's no archive
+  if (!stop.stop_requested()) {
+    *backedUp = true;
+  }
+}
+
+Task<> RemoveBackedUpSettings(
+  const Plan& plan,
+  const Plan::Step& step,
+  Progress& progress,
+  const BackupState backedUp,
+  const std::stop_token stop) {
+  if (!*backedUp) {
+    throw std::runtime_error("Not deleted, as the settings backup failed");
+  }
+  co_await ApplyStep(plan, step, progress, stop);
+}
+
+// Records the step in the journal, so that if we're interrupted, the next
+// launch can resume the run
+Task<> RunJournaled(
+  const std::function<Task<>(std::stop_token)> run,
+  RunJournal& journal,
+  const std::size_t step,
+  const std::stop_token stop) {
+  journal.MarkStarted(step);
+  co_await run(stop);
+  // Stopped steps may not have done everything
+  if (!stop.stop_requested()) {
+    journal.MarkSucceeded(step);
+  }
+}
+}// namespace
+
+bool IsKnownStep(
+  const std::span<const ArtifactDescriptor> artifactTypes,
+  const Plan::Step& step) {
+  return step.mAction == Plan::Action::Backup
+    || FindDescriptor(artifactTypes, step.mTitle);
+}
+
+std::vector<ActionScheduler::Result> RunPlan(
+  const std::span<const ArtifactDescriptor> artifactTypes,
+  const Plan& plan,
+  std::span<Progress* const> progress,
+  RunJournal* journal,
+  const ActionScheduler::Callback& callback,
+  std::stop_token stopToken) {
+  const auto steps = plan.GetSteps();
+  if (progress.size() != steps.size()) {
+    throw std::logic_error("Need exactly one progress per step");
+  }
+
+  const auto backedUp = std::make_shared<std::atomic<bool>>(false);
+  const auto backup
+    = std::ranges::find(steps, Plan::Action::Backup, &Plan::Step::mAction);
+
+  // Actions and plan steps have the same indices
+  std::vector<ActionScheduler::Action> actions;
+  actions.reserve(steps.size());
+  for (std::size_t i = 0; i < steps.size(); ++i) {
+    const auto& step = steps[i];
+    auto& stepProgress = *progress[i];
+    ActionScheduler::Action action {.mName = step.mTitle};
+
+    if (step.mAction == Plan::Action::Backup) {
+      // No timeout: it takes as long as the settings are large
+      action.mRun = [&plan, &step, &stepProgress, backedUp](
+                      std::stop_token stop) {
+        return BackUpSettings(
+          plan, step, stepProgress, backedUp, std::move(stop));
+      };
+    } else {
+      const auto descriptor = FindDescriptor(artifactTypes, step.mTitle);
+      if (!descriptor) {
+        throw std::logic_error(
+          std::format("Plan contains unknown artifact '{}'", step.mTitle));
+      }
+      const auto needsBackup = backup != steps.end()
+        && step.mAction == Plan::Action::Remove
+        && descriptor->mMetadata.mKind == Artifact::Kind::UserSettings;
+      action.mRun = [&plan, &step, &stepProgress, backedUp, needsBackup](
+                      std::stop_token stop) {
+        if (needsBackup) {
+          return RemoveBackedUpSettings(
+            plan, step, stepProgress, backedUp, std::move(stop));
+        }
+        return ApplyStep(plan, step, stepProgress, std::move(stop));
+      };
+      action.mResources
+        = ActionScheduler::MakeResourceSet(descriptor->mExclusiveResources);
+      action.mTimeout = descriptor->mActionTimeout;
+      if (needsBackup) {
+        action.mDependencies.push_back(
+          static_cast<std::size_t>(backup - steps.begin()));
+      }
+      // Dependencies only matter if they're also being acted on
+      for (auto&& title: descriptor->mRunsAfter) {
+        const auto it = std::ranges::find(steps, title, &Plan::Step::mTitle);
+        if (it != steps.end()) {
+          action.mDependencies.push_back(
+            static_cast<std::size_t>(it - steps.begin()));
+        }
+      }
+    }
+
+    if (journal) {
+      action.mRun = [run = std::move(action.mRun), journal, i](
+                      std::stop_token stop) {
+        return RunJournaled(run, *journal, i, std::move(stop));
+      };
+    }
+    actions.push_back(std::move(action));
+  }
+
+  ActionScheduler scheduler {std::move(actions)};
+  return scheduler.Run(
+    [progress, &callback](const auto index, const auto event) {
+      auto& it = *progress[index];
+      switch (event) {
+        case ActionScheduler::Event::Started:
+          it.Start();
+          break;
+        case ActionScheduler::Event::Finished:
+          it.Complete();
+          break;
+        case ActionScheduler::Event::TimedOut:
+        case ActionScheduler::Event::Cancelled:
+          it.Stop();
+          break;
+      }
+      if (callback) {
+        callback(index, event);
+      }
+    },
+    std::move(stopToken));
+}
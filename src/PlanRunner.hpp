@@ -0,0 +1,46 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <span>
+#include <stop_token>
+#include <vector>
+
+#include "ActionScheduler.hpp"
+#include "ArtifactDescriptor.hpp"
+#include "Plan.hpp"
+#include "Progress.hpp"
+#include "RunJournal.hpp"
+
+// Runs every step of a `Plan` with an `ActionScheduler`; shared by the GUI
+// and the headless mode.
+//
+// Independent steps run concurrently; ordering and exclusivity are declared
+// by each artifact type's descriptor, usually from `ArtifactRegistry`. If the
+// plan backs up settings, settings are only deleted once the backup has
+// succeeded.
+
+// Whether `RunPlan()` knows how to run the step; artifacts may be renamed by
+// newer versions
+[[nodiscard]] bool IsKnownStep(
+  std::span<const ArtifactDescriptor> artifactTypes,
+  const Plan::Step&);
+
+// `progress` is indexed like `plan.GetSteps()`; each is started, completed,
+// or stopped along with its step, before `callback` is invoked. If `journal`
+// is non-null, each step is recorded in it.
+//
+// Blocks until every step has finished, timed out, or been cancelled; see
+// `ActionScheduler::Run()`. Steps left running in the background still use
+// the plan, progress, and journal, so they must outlive the process's use of
+// them.
+//
+// Throws `std::logic_error` if a step isn't `IsKnownStep()`, or `progress`
+// is the wrong size.
+[[nodiscard]] std::vector<ActionScheduler::Result> RunPlan(
+  std::span<const ArtifactDescriptor> artifactTypes,
+  const Plan& plan,
+  std::span<Progress* const> progress,
+  RunJournal* journal,
+  const ActionScheduler::Callback& callback = {},
+  std::stop_token stopToken = {});
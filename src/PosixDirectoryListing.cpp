@@ -0,0 +1,91 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <memory>
+#include <string_view>
+
+#include "DirectoryListing.hpp"
+
+namespace {
+DirectoryEntry MakeEntry(std::filesystem::path path, const struct stat& st) {
+  DirectoryEntry ret {
+    .mPath = std::move(path),
+    .mIsDirectory = S_ISDIR(st.st_mode),
+    .mIsLink = S_ISLNK(st.st_mode),
+  };
+  if (ret.mIsDirectory) {
+    return ret;
+  }
+  // POSIX defines `st_blocks` in 512-byte units, regardless of block size
+  ret.mAllocatedBytes = static_cast<std::uint64_t>(st.st_blocks) * 512;
+  if (!S_ISREG(st.st_mode)) {
+    return ret;
+  }
+  ret.mSize = static_cast<std::uint64_t>(st.st_size);
+  if (st.st_nlink > 1) {
+    ret.mHardLinkID = FileID {
+      static_cast<std::uint64_t>(st.st_dev),
+      static_cast<std::uint64_t>(st.st_ino),
+    };
+  }
+  return ret;
+}
+
+std::error_code LastError() {
+  return {errno, std::generic_category()};
+}
+}// namespace
+
+std::vector<DirectoryEntry> ListDirectory(
+  const std::filesystem::path& path,
+  std::error_code& ec,
+  const ListingDetail detail) {
+  ec.clear();
+  const std::unique_ptr<DIR, decltype([](DIR* it) { closedir(it); })> dir {
+    opendir(path.c_str())};
+  if (!dir) {
+    ec = LastError();
+    return {};
+  }
+
+  std::vector<DirectoryEntry> ret;
+  const auto fd = dirfd(dir.get());
+  while (const auto it = readdir(dir.get())) {
+    const std::string_view name {it->d_name};
+    if (name == "." || name == "..") {
+      continue;
+    }
+    // Some filesystems don't fill in the type, so need the `stat()` anyway
+    if (detail == ListingDetail::TypeOnly && it->d_type != DT_UNKNOWN) {
+      ret.push_back({
+        .mPath = path / name,
+        .mIsDirectory = it->d_type == DT_DIR,
+        .mIsLink = it->d_type == DT_LNK,
+      });
+      continue;
+    }
+    struct stat st {};
+    if (fstatat(fd, it->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+      // Probably removed since listing
+      continue;
+    }
+    ret.push_back(MakeEntry(path / name, st));
+  }
+  return ret;
+}
+
+DirectoryEntry GetDirectoryEntry(
+  const std::filesystem::path& path,
+  std::error_code& ec) {
+  ec.clear();
+  struct stat st {};
+  if (lstat(path.c_str(), &st) != 0) {
+    ec = LastError();
+    return {.mPath = path};
+  }
+  return MakeEntry(path, st);
+}
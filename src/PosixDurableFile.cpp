@@ -0,0 +1,98 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <utility>
+
+#include "DurableFile.hpp"
+
+namespace {
+std::error_code LastError() {
+  return {errno, std::system_category()};
+}
+
+// Makes a new or renamed file's directory entry durable, not just its
+// contents
+void SyncParent(const std::filesystem::path& path) {
+  const auto parent = path.parent_path().empty() ? std::filesystem::path {"."}
+                                                 : path.parent_path();
+  const auto fd = open(parent.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd == -1) {
+    throw std::filesystem::filesystem_error(
+      "Failed to open folder", parent, LastError());
+  }
+  const auto result = fsync(fd);
+  const auto error = LastError();
+  close(fd);
+  if (result != 0) {
+    throw std::filesystem::filesystem_error(
+      "Failed to flush folder", parent, error);
+  }
+}
+}// namespace
+
+struct DurableFile::Impl {
+  int mFD {-1};
+  std::filesystem::path mPath;
+
+  ~Impl() {
+    if (mFD != -1) {
+      close(mFD);
+    }
+  }
+};
+
+DurableFile::DurableFile(std::unique_ptr<Impl> impl)
+  : mImpl(std::move(impl)) {}
+DurableFile::~DurableFile() = default;
+DurableFile::DurableFile(DurableFile&&) noexcept = default;
+DurableFile& DurableFile::operator=(DurableFile&&) noexcept = default;
+
+DurableFile DurableFile::Create(const std::filesystem::path& path) {
+  auto impl = std::make_unique<Impl>();
+  impl->mPath = path;
+  impl->mFD = open(
+    path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0600);
+  if (impl->mFD == -1) {
+    throw std::filesystem::filesystem_error(
+      "Failed to create file", path, LastError());
+  }
+  SyncParent(path);
+  return DurableFile {std::move(impl)};
+}
+
+void DurableFile::Append(const std::span<const std::byte> data) {
+  Write(data);
+  Flush();
+}
+
+void DurableFile::Write(std::span<const std::byte> data) {
+  while (!data.empty()) {
+    const auto written = write(mImpl->mFD, data.data(), data.size());
+    if (written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::filesystem::filesystem_error(
+        "Failed to write file", mImpl->mPath, LastError());
+    }
+    data = data.subspan(static_cast<std::size_t>(written));
+  }
+}
+
+void DurableFile::Flush() {
+  if (fdatasync(mImpl->mFD) != 0) {
+    throw std::filesystem::filesystem_error(
+      "Failed to flush file", mImpl->mPath, LastError());
+  }
+}
+
+void DurableFile::Rename(
+  const std::filesystem::path& from,
+  const std::filesystem::path& to) {
+  std::filesystem::rename(from, to);
+  SyncParent(to);
+}
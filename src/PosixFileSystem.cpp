@@ -0,0 +1,21 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <cerrno>
+
+#include "FileSystem.hpp"
+
+// There are no mandatory locks here; `EBUSY` and `ETXTBSY` are the nearest
+// equivalents
+bool IsSharingViolation(const std::error_code& ec) {
+  return ec == std::errc::device_or_resource_busy
+    || ec == std::errc::text_file_busy;
+}
+
+std::error_code MakeSharingViolationError() {
+  return {EBUSY, std::generic_category()};
+}
+
+std::error_code MakeAccessDeniedError() {
+  return {EACCES, std::generic_category()};
+}
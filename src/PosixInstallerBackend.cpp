@@ -0,0 +1,13 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <memory>
+
+#include "InstallerInventory.hpp"
+
+// There's no Windows Installer or MSIX here, so nothing is ever installed
+InstallerInventory& InstallerInventory::Get() {
+  static InstallerInventory sInstance {
+    std::make_unique<FakeInstallerBackend>()};
+  return sInstance;
+}
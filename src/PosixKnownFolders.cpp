@@ -0,0 +1,48 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <cstdlib>
+#include <filesystem>
+
+#include "Instrumentation.hpp"
+#include "KnownFolders.hpp"
+
+namespace {
+
+std::filesystem::path GetEnvironmentPath(const char* name) {
+  Instrumentation::Increment(Instrumentation::Counter::KnownFolderLookups);
+  const auto value = std::getenv(name);
+  if (!(value && *value)) {
+    return {};
+  }
+  return std::filesystem::path {value};
+}
+
+// Follows the XDG base directory spec where there's an equivalent; there's
+// no machine-wide equivalent of ProgramData that we could clean up, so it's
+// left unresolved
+KnownFolders::Roots ResolveRoots() {
+  const Instrumentation::ScopedTimer timer {"Discovery", "KnownFolders"};
+  const auto home = GetEnvironmentPath("HOME");
+  const auto inHome = [&home](const std::filesystem::path& child) {
+    return home.empty() ? std::filesystem::path {} : home / child;
+  };
+  auto localAppData = GetEnvironmentPath("XDG_DATA_HOME");
+  if (localAppData.empty()) {
+    localAppData = inHome(".local/share");
+  }
+  std::error_code ec;
+  return {
+    .mDocuments = inHome("Documents"),
+    .mLocalAppData = std::move(localAppData),
+    .mSavedGames = inHome("Saved Games"),
+    .mTemp = std::filesystem::temp_directory_path(ec),
+  };
+}
+
+}// namespace
+
+KnownFolders& KnownFolders::Get() {
+  static KnownFolders sInstance {&ResolveRoots};
+  return sInstance;
+}
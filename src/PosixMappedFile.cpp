@@ -0,0 +1,129 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <utility>
+
+#include "MappedFile.hpp"
+
+namespace {
+std::error_code LastError() {
+  return {errno, std::system_category()};
+}
+}// namespace
+
+struct MappedFile::Impl {
+  int mFD {-1};
+  std::uint64_t mSize {};
+
+  ~Impl() {
+    if (mFD != -1) {
+      close(mFD);
+    }
+  }
+};
+
+MappedFile::MappedFile(std::unique_ptr<Impl> impl) : mImpl(std::move(impl)) {}
+MappedFile::~MappedFile() = default;
+MappedFile::MappedFile(MappedFile&&) noexcept = default;
+MappedFile& MappedFile::operator=(MappedFile&&) noexcept = default;
+
+std::optional<MappedFile> MappedFile::Open(
+  const std::filesystem::path& path,
+  std::error_code& ec) {
+  auto impl = std::make_unique<Impl>();
+  impl->mFD = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (impl->mFD == -1) {
+    ec = LastError();
+    return std::nullopt;
+  }
+  struct stat info {};
+  if (fstat(impl->mFD, &info) != 0) {
+    ec = LastError();
+    return std::nullopt;
+  }
+  impl->mSize = static_cast<std::uint64_t>(info.st_size);
+  posix_fadvise(impl->mFD, 0, 0, POSIX_FADV_SEQUENTIAL);
+  ec.clear();
+  return MappedFile {std::move(impl)};
+}
+
+std::uint64_t MappedFile::GetSize() const noexcept {
+  return mImpl->mSize;
+}
+
+MappedFile::View MappedFile::Map(
+  const std::uint64_t offset,
+  const std::size_t size,
+  std::error_code& ec) const {
+  static const auto pageSize
+    = static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+  const auto alignedOffset = offset - (offset % pageSize);
+  const auto padding = static_cast<std::size_t>(offset - alignedOffset);
+
+  View ret;
+  ret.mMappedSize = size + padding;
+  const auto base = mmap(
+    nullptr,
+    ret.mMappedSize,
+    PROT_READ,
+    MAP_SHARED,
+    mImpl->mFD,
+    static_cast<off_t>(alignedOffset));
+  if (base == MAP_FAILED) {
+    ec = LastError();
+    return {};
+  }
+  madvise(base, ret.mMappedSize, MADV_SEQUENTIAL);
+  ret.mBase = base;
+  ret.mData = {static_cast<const std::byte*>(base) + padding, size};
+  ec.clear();
+  return ret;
+}
+
+std::size_t MappedFile::Read(
+  std::uint64_t offset,
+  std::span<std::byte> buffer,
+  std::error_code& ec) const {
+  std::size_t ret = 0;
+  while (ret < buffer.size()) {
+    const auto count = pread(
+      mImpl->mFD,
+      buffer.data() + ret,
+      buffer.size() - ret,
+      static_cast<off_t>(offset + ret));
+    if (count == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ec = LastError();
+      return ret;
+    }
+    if (count == 0) {
+      break;
+    }
+    ret += static_cast<std::size_t>(count);
+  }
+  ec.clear();
+  return ret;
+}
+
+void MappedFile::View::Prefetch() const noexcept {
+  if (mBase) {
+    madvise(mBase, mMappedSize, MADV_WILLNEED);
+  }
+}
+
+void MappedFile::View::Reset() noexcept {
+  if (mBase) {
+    munmap(mBase, mMappedSize);
+  }
+  mBase = nullptr;
+  mMappedSize = 0;
+  mData = {};
+}
@@ -0,0 +1,21 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <stdexcept>
+
+#include "PlanApplier.hpp"
+
+// There's no Windows Installer or MSIX here; plans containing them can still
+// be inspected, but not applied
+
+Task<> PlanApplierDetail::ApplySystemOperation(
+  const PlannedOperation& operation,
+  std::stop_token) {
+  throw std::runtime_error(
+    "Operation is not supported on this platform: " + Describe(operation));
+  co_return;
+}
+
+bool PlanApplierDetail::IsSystemOperationApplied(const PlannedOperation&) {
+  return false;
+}
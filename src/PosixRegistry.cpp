@@ -0,0 +1,11 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "Registry.hpp"
+
+// There's no registry here: nothing can be found in it, and there are no keys
+// to set values in
+Registry& Registry::Get() {
+  static FakeRegistry sInstance;
+  return sInstance;
+}
@@ -0,0 +1,12 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "ThreadPriority.hpp"
+
+void LowerCurrentThreadPriority() {
+  // On Linux, this only affects the calling thread
+  setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), 19);
+}
@@ -0,0 +1,209 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "Progress.hpp"
+
+#include <algorithm>
+#include <array>
+#include <format>
+
+namespace {
+constexpr std::uint64_t Remainder(std::uint64_t a, std::uint64_t b) {
+  return a > b ? a - b : 0;
+}
+
+// Rates are too noisy to be useful before this
+constexpr auto MinimumElapsedForEstimate = std::chrono::seconds(1);
+
+double PerSecond(std::uint64_t amount, Progress::Clock::duration elapsed) {
+  const auto seconds = std::chrono::duration<double>(elapsed).count();
+  if (seconds <= 0) {
+    return 0;
+  }
+  return amount / seconds;
+}
+}// namespace
+
+Progress::Progress(Progress* parent) : mParent(parent) {}
+
+void Progress::AddToTotal(const WorkAmount& amount) {
+  mBytesTotal += amount.mBytes;
+  mFilesTotal += amount.mFiles;
+  if (mParent) {
+    mParent->AddToTotal(amount);
+  }
+}
+
+void Progress::Start(Clock::time_point now) {
+  auto expected = Clock::rep {};
+  mStartTime.compare_exchange_strong(expected, now.time_since_epoch().count());
+  if (mParent) {
+    mParent->Start(now);
+  }
+}
+
+void Progress::Add(const WorkAmount& amount) {
+  mBytesDone += amount.mBytes;
+  mFilesDone += amount.mFiles;
+  if (mParent) {
+    mParent->Add(amount);
+  }
+}
+
+void Progress::Complete(Clock::time_point now) {
+  Start(now);
+
+  // Reconcile the estimate with what actually happened
+  const WorkAmount done {mBytesDone.load(), mFilesDone.load()};
+  const WorkAmount total {mBytesTotal.load(), mFilesTotal.load()};
+  AddToTotal({
+    Remainder(done.mBytes, total.mBytes),
+    Remainder(done.mFiles, total.mFiles),
+  });
+  Add({
+    Remainder(total.mBytes, done.mBytes),
+    Remainder(total.mFiles, done.mFiles),
+  });
+
+  mEndTime.store(now.time_since_epoch().count());
+}
+
+void Progress::Stop(Clock::time_point now) {
+  auto expected = Clock::rep {};
+  mStartTime.compare_exchange_strong(expected, now.time_since_epoch().count());
+  mIsStopped.store(true);
+  mEndTime.store(now.time_since_epoch().count());
+}
+
+Progress::Snapshot Progress::GetSnapshot(Clock::time_point now) const {
+  Snapshot ret {
+    .mDone = {mBytesDone.load(), mFilesDone.load()},
+    .mTotal = {mBytesTotal.load(), mFilesTotal.load()},
+  };
+  const auto start = mStartTime.load();
+  const auto end = mEndTime.load();
+  const auto isEnded = end != 0;
+  ret.mIsStarted = start != 0;
+  ret.mIsStopped = isEnded && mIsStopped.load();
+  ret.mIsComplete = isEnded && !ret.mIsStopped;
+  if (ret.mIsStarted) {
+    const auto until = isEnded ? end : now.time_since_epoch().count();
+    ret.mElapsed = Clock::duration {std::max<Clock::rep>(until - start, 0)};
+  }
+  return ret;
+}
+
+std::optional<double> Progress::Snapshot::GetFraction() const {
+  if (mIsComplete) {
+    return 1.0;
+  }
+  if (mTotal.mBytes) {
+    return std::min(1.0, static_cast<double>(mDone.mBytes) / mTotal.mBytes);
+  }
+  if (mTotal.mFiles) {
+    return std::min(1.0, static_cast<double>(mDone.mFiles) / mTotal.mFiles);
+  }
+  return std::nullopt;
+}
+
+double Progress::Snapshot::GetBytesPerSecond() const {
+  return PerSecond(mDone.mBytes, mElapsed);
+}
+
+double Progress::Snapshot::GetFilesPerSecond() const {
+  return PerSecond(mDone.mFiles, mElapsed);
+}
+
+std::optional<Progress::Clock::duration> Progress::Snapshot::GetRemaining()
+  const {
+  if (mIsComplete) {
+    return Clock::duration::zero();
+  }
+  if (mIsStopped || !mIsStarted || mElapsed < MinimumElapsedForEstimate) {
+    return std::nullopt;
+  }
+
+  const auto useBytes = mTotal.mBytes != 0;
+  const auto done = useBytes ? mDone.mBytes : mDone.mFiles;
+  const auto total = useBytes ? mTotal.mBytes : mTotal.mFiles;
+  // If we've already done more than the total, it was an underestimate, so
+  // we have no idea
+  if (done == 0 || done >= total) {
+    return std::nullopt;
+  }
+  const auto perSecond = useBytes ? GetBytesPerSecond() : GetFilesPerSecond();
+  return std::chrono::duration_cast<Clock::duration>(
+    std::chrono::duration<double>((total - done) / perSecond));
+}
+
+std::string FormatBytes(std::uint64_t bytes) {
+  constexpr std::array units {"KB", "MB", "GB", "TB"};
+  if (bytes < 1024) {
+    return std::format("{} B", bytes);
+  }
+  auto value = bytes / 1024.0;
+  std::size_t unit = 0;
+  while (value >= 1024 && unit + 1 < units.size()) {
+    value /= 1024;
+    ++unit;
+  }
+  return std::format("{:.1f} {}", value, units[unit]);
+}
+
+std::string FormatDuration(Progress::Clock::duration duration) {
+  using namespace std::chrono;
+  const auto seconds = ceil<std::chrono::seconds>(duration).count();
+  if (seconds < 60) {
+    return std::format("{} s", seconds);
+  }
+  if (seconds < 60 * 60) {
+    return std::format("{} min {} s", seconds / 60, seconds % 60);
+  }
+  return std::format("{} h {} min", seconds / 3600, (seconds % 3600) / 60);
+}
+
+std::string FormatProgress(const Progress::Snapshot& snapshot) {
+  const auto& [done, total, elapsed, isStarted, isComplete, isStopped]
+    = snapshot;
+  // Operations that don't touch files, e.g. uninstallers
+  if (total == WorkAmount {} && done == WorkAmount {}) {
+    return {};
+  }
+
+  const auto useBytes = total.mBytes || done.mBytes;
+  const auto format = [useBytes](const WorkAmount& amount) {
+    if (useBytes) {
+      return FormatBytes(amount.mBytes);
+    }
+    return std::format(
+      "{} {}", amount.mFiles, amount.mFiles == 1 ? "file" : "files");
+  };
+
+  if (isComplete) {
+    return std::format("{} in {}", format(done), FormatDuration(elapsed));
+  }
+  if (!isStarted) {
+    return format(total);
+  }
+
+  // The total may be unknown if there was no pre-scan
+  auto ret = (total == WorkAmount {})
+    ? format(done)
+    : std::format("{} of {}", format(done), format(total));
+  if (isStopped) {
+    return std::format("{}, stopped after {}", ret, FormatDuration(elapsed));
+  }
+  if (elapsed >= MinimumElapsedForEstimate && done != WorkAmount {}) {
+    if (useBytes) {
+      ret += std::format(
+        ", {}/s",
+        FormatBytes(static_cast<std::uint64_t>(snapshot.GetBytesPerSecond())));
+    } else {
+      ret += std::format(", {:.0f} files/s", snapshot.GetFilesPerSecond());
+    }
+  }
+  if (const auto remaining = snapshot.GetRemaining()) {
+    ret += std::format(", {} left", FormatDuration(*remaining));
+  }
+  return ret;
+}
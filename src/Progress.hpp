@@ -0,0 +1,93 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// An amount of work, either done or to do
+struct WorkAmount {
+  std::uint64_t mBytes {};
+  // Files and folders
+  std::uint64_t mFiles {};
+
+  WorkAmount& operator+=(const WorkAmount& other) noexcept {
+    mBytes += other.mBytes;
+    mFiles += other.mFiles;
+    return *this;
+  }
+
+  bool operator==(const WorkAmount&) const noexcept = default;
+};
+
+// Thread-safe progress of a single operation, e.g. removing an artifact.
+//
+// The total is normally set from a pre-scan before the work starts; if it
+// isn't known, or turns out to be an underestimate, the operation is still
+// shown as in progress until `Complete()` is called.
+//
+// If there is a parent, all work and totals are also added to it, so that
+// an overall `Progress` can be shared by several operations.
+class Progress {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Snapshot {
+    WorkAmount mDone;
+    WorkAmount mTotal;
+    Clock::duration mElapsed {};
+    bool mIsStarted {false};
+    bool mIsComplete {false};
+    // Ended early, e.g. cancelled or timed out
+    bool mIsStopped {false};
+
+    // Between 0 and 1; `nullopt` if there's no known total
+    [[nodiscard]] std::optional<double> GetFraction() const;
+    // Since starting; measured in bytes if there are any, otherwise files
+    [[nodiscard]] double GetBytesPerSecond() const;
+    [[nodiscard]] double GetFilesPerSecond() const;
+    // `nullopt` until there's enough progress to estimate
+    [[nodiscard]] std::optional<Clock::duration> GetRemaining() const;
+  };
+
+  Progress() = default;
+  explicit Progress(Progress* parent);
+  Progress(const Progress&) = delete;
+  Progress& operator=(const Progress&) = delete;
+
+  void AddToTotal(const WorkAmount&);
+  void Start(Clock::time_point now = Clock::now());
+  void Add(const WorkAmount&);
+  // Marks everything as done, even if the total was an estimate
+  void Complete(Clock::time_point now = Clock::now());
+  // Marks the operation as over without everything being done, e.g. if it
+  // was cancelled. Does not affect the parent.
+  void Stop(Clock::time_point now = Clock::now());
+
+  [[nodiscard]] Snapshot GetSnapshot(
+    Clock::time_point now = Clock::now()) const;
+
+ private:
+  Progress* mParent {nullptr};
+
+  std::atomic<std::uint64_t> mBytesDone {};
+  std::atomic<std::uint64_t> mFilesDone {};
+  std::atomic<std::uint64_t> mBytesTotal {};
+  std::atomic<std::uint64_t> mFilesTotal {};
+  // `Clock::rep` of the start and end times; 0 if not yet reached
+  std::atomic<Clock::rep> mStartTime {};
+  std::atomic<Clock::rep> mEndTime {};
+  std::atomic<bool> mIsStopped {false};
+};
+
+// e.g. "1.5 GB"
+[[nodiscard]] std::string FormatBytes(std::uint64_t bytes);
+// e.g. "3 min 20 s"
+[[nodiscard]] std::string FormatDuration(Progress::Clock::duration);
+// A one-line summary for the UI, e.g.
+// "1.2 GB of 3.4 GB, 45.0 MB/s, 20 s left"; empty if there's nothing worth
+// showing
+[[nodiscard]] std::string FormatProgress(const Progress::Snapshot&);
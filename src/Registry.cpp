@@ -0,0 +1,128 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "Registry.hpp"
+
+#include <cwctype>
+#include <ranges>
+#include <system_error>
+#include <utility>
+
+namespace {
+std::wstring FoldCase(std::wstring_view value) {
+  std::wstring ret {value};
+  for (auto& c: ret) {
+    c = static_cast<wchar_t>(std::towlower(c));
+  }
+  return ret;
+}
+
+// We're a 64-bit process
+RegistryView GetEffectiveView(const RegistryView view) {
+  return view == RegistryView::Default ? RegistryView::Bits64 : view;
+}
+}// namespace
+
+FakeRegistry::KeyID FakeRegistry::GetKeyID(
+  const RegistryHive hive,
+  const RegistryView view,
+  const std::wstring_view subKey) {
+  return {hive, GetEffectiveView(view), FoldCase(subKey)};
+}
+
+FakeRegistry::ValueID FakeRegistry::GetValueID(
+  const RegistryValueLocation& value) {
+  return {
+    value.mHive,
+    GetEffectiveView(value.mView),
+    FoldCase(value.mSubKey),
+    FoldCase(value.mValueName),
+  };
+}
+
+void FakeRegistry::CreateKey(
+  const RegistryHive hive,
+  const RegistryView view,
+  const std::wstring_view subKey) {
+  std::unique_lock lock(mMutex);
+  mKeys.insert(GetKeyID(hive, view, subKey));
+}
+
+void FakeRegistry::SetDWORD(
+  const RegistryValueLocation& value,
+  const std::uint32_t data) {
+  std::unique_lock lock(mMutex);
+  mKeys.insert(GetKeyID(value.mHive, value.mView, value.mSubKey));
+  mValues.insert_or_assign(GetValueID(value), data);
+}
+
+bool FakeRegistry::HasValue(const RegistryValueLocation& value) const {
+  std::unique_lock lock(mMutex);
+  return mValues.contains(GetValueID(value));
+}
+
+std::optional<std::uint32_t> FakeRegistry::GetDWORD(
+  const RegistryValueLocation& value) const {
+  std::unique_lock lock(mMutex);
+  const auto it = mValues.find(GetValueID(value));
+  if (it == mValues.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+std::size_t FakeRegistry::GetValueCount() const {
+  std::unique_lock lock(mMutex);
+  return mValues.size();
+}
+
+void FakeRegistry::Apply(const RegistryBatch& batch) {
+  std::unique_lock lock(mMutex);
+  const auto failAt = std::exchange(mFailAtEdit, std::nullopt);
+
+  // What each changed value was before, most recent last
+  std::vector<std::tuple<ValueID, std::optional<std::uint32_t>>> undo;
+  const auto fail = [&](const std::errc error, const char* what) {
+    for (auto&& [id, previous]: std::views::reverse(undo)) {
+      if (previous) {
+        mValues.insert_or_assign(id, *previous);
+      } else {
+        mValues.erase(id);
+      }
+    }
+    throw std::system_error(std::make_error_code(error), what);
+  };
+
+  const auto edits = batch.GetEdits();
+  for (std::size_t i = 0; i < edits.size(); ++i) {
+    if (i == failAt) {
+      fail(std::errc::io_error, "Injected registry failure");
+    }
+    const auto& edit = edits[i];
+    auto id = GetValueID(edit.mValue);
+    const auto it = mValues.find(id);
+    switch (edit.mKind) {
+      case RegistryBatch::Edit::Kind::DeleteValue:
+        if (it != mValues.end()) {
+          undo.emplace_back(std::move(id), it->second);
+          mValues.erase(it);
+        }
+        break;
+      case RegistryBatch::Edit::Kind::SetDWORD: {
+        if (!mKeys.contains(GetKeyID(
+              edit.mValue.mHive, edit.mValue.mView, edit.mValue.mSubKey))) {
+          fail(
+            std::errc::no_such_file_or_directory,
+            "Registry key does not exist");
+        }
+        std::optional<std::uint32_t> previous;
+        if (it != mValues.end()) {
+          previous = it->second;
+        }
+        mValues.insert_or_assign(id, edit.mData);
+        undo.emplace_back(std::move(id), previous);
+        break;
+      }
+    }
+  }
+}
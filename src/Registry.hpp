@@ -0,0 +1,123 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "ChangeSource.hpp"
+
+// Which registry view to use on 64-bit Windows
+enum class RegistryView : std::uint8_t {
+  Default,
+  Bits64,
+  Bits32,
+};
+
+struct RegistryValueLocation {
+  RegistryHive mHive {};
+  RegistryView mView {};
+  std::wstring mSubKey;
+  std::wstring mValueName;
+
+  bool operator==(const RegistryValueLocation&) const = default;
+};
+
+// Registry changes that are applied together; see `Registry::Apply()`
+class RegistryBatch {
+ public:
+  struct Edit {
+    enum class Kind : std::uint8_t {
+      // Deleting a value that doesn't exist is not an error
+      DeleteValue,
+      // The key must already exist
+      SetDWORD,
+    };
+    Kind mKind {};
+    RegistryValueLocation mValue;
+    std::uint32_t mData {};
+  };
+
+  void DeleteValue(RegistryValueLocation value) {
+    mEdits.push_back({.mKind = Edit::Kind::DeleteValue, .mValue = value});
+  }
+  void SetDWORD(RegistryValueLocation value, std::uint32_t data) {
+    mEdits.push_back(
+      {.mKind = Edit::Kind::SetDWORD, .mValue = value, .mData = data});
+  }
+
+  [[nodiscard]] std::span<const Edit> GetEdits() const noexcept {
+    return mEdits;
+  }
+  [[nodiscard]] bool IsEmpty() const noexcept {
+    return mEdits.empty();
+  }
+
+ private:
+  std::vector<Edit> mEdits;
+};
+
+class Registry {
+ public:
+  virtual ~Registry() = default;
+
+  // The real registry; on Windows, batches are applied in a kernel
+  // transaction
+  static Registry& Get();
+
+  [[nodiscard]] virtual bool HasValue(const RegistryValueLocation&) const = 0;
+  // nullopt if the value doesn't exist, or isn't a DWORD
+  [[nodiscard]] virtual std::optional<std::uint32_t> GetDWORD(
+    const RegistryValueLocation&) const
+    = 0;
+
+  // All or nothing: if any edit fails, none of them are kept, and a
+  // `std::system_error` is thrown
+  virtual void Apply(const RegistryBatch&) = 0;
+};
+
+// In-memory registry, for exercising batches and rollback without Windows.
+//
+// Like the real registry, names are case-insensitive; `RegistryView::Default`
+// is the 64-bit view. Only DWORD values are stored.
+class FakeRegistry final : public Registry {
+ public:
+  FakeRegistry() = default;
+  ~FakeRegistry() override = default;
+
+  void CreateKey(RegistryHive, RegistryView, std::wstring_view subKey);
+  // Also creates the key
+  void SetDWORD(const RegistryValueLocation&, std::uint32_t data);
+
+  [[nodiscard]] bool HasValue(const RegistryValueLocation&) const override;
+  [[nodiscard]] std::optional<std::uint32_t> GetDWORD(
+    const RegistryValueLocation&) const override;
+  void Apply(const RegistryBatch&) override;
+
+  [[nodiscard]] std::size_t GetValueCount() const;
+
+  // If set, the edit with this index in the next batch fails, as if the
+  // registry had returned an error
+  std::optional<std::size_t> mFailAtEdit;
+
+ private:
+  // Hive, effective view, and case-folded names
+  using KeyID = std::tuple<RegistryHive, RegistryView, std::wstring>;
+  using ValueID
+    = std::tuple<RegistryHive, RegistryView, std::wstring, std::wstring>;
+
+  mutable std::mutex mMutex;
+  std::set<KeyID> mKeys;
+  std::map<ValueID, std::uint32_t> mValues;
+
+  static KeyID GetKeyID(RegistryHive, RegistryView, std::wstring_view subKey);
+  static ValueID GetValueID(const RegistryValueLocation&);
+};
@@ -0,0 +1,44 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "ArtifactRegistry.hpp"
+#include "DiscoveryScheduler.hpp"
+
+// Discovers an artifact type from `ArtifactRegistry`
+class RegistryProbe final : public ArtifactProbe {
+ public:
+  explicit RegistryProbe(const ArtifactDescriptor& descriptor)
+    : mDescriptor(descriptor) {}
+
+  [[nodiscard]] std::string_view GetName() const override {
+    return mDescriptor.mMetadata.mTitle;
+  }
+
+  [[nodiscard]] std::chrono::milliseconds GetDeadline() const override {
+    return mDescriptor.mDeadline;
+  }
+
+  [[nodiscard]] std::unique_ptr<Artifact> Run() override {
+    return mDescriptor.mCreate();
+  }
+
+ private:
+  const ArtifactDescriptor& mDescriptor;
+};
+
+// One probe per artifact type, in registry order
+[[nodiscard]] inline std::vector<std::unique_ptr<ArtifactProbe>>
+MakeRegistryProbes() {
+  std::vector<std::unique_ptr<ArtifactProbe>> ret;
+  ret.reserve(ArtifactRegistry.size());
+  for (auto&& descriptor: ArtifactRegistry) {
+    ret.push_back(std::make_unique<RegistryProbe>(descriptor));
+  }
+  return ret;
+}
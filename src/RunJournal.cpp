@@ -0,0 +1,282 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "RunJournal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include "PlanApplier.hpp"
+
+namespace {
+// Format:
+//
+// - `Magic`, then the version as a varint
+// - records, each a 4-byte payload size, then a 4-byte CRC-32 of the
+//   payload, both little-endian, then the payload
+//
+// Each payload starts with a `RecordKind`. The first record is always the
+// plan, followed by `Plan::Serialize()`; step records are followed by the
+// step index, as an unsigned LEB128 varint.
+constexpr std::array Magic {
+  std::byte {'O'},
+  std::byte {'K'},
+  std::byte {'B'},
+  std::byte {'J'},
+  std::byte {'R'},
+  std::byte {'N'},
+  std::byte {'L'},
+  std::byte {'\n'},
+};
+constexpr std::uint64_t FormatVersion = 1;
+
+enum class RecordKind : std::uint8_t {
+  Plan,
+  StepStarted,
+  StepSucceeded,
+};
+
+constexpr std::size_t RecordHeaderSize = 8;
+
+// IEEE 802.3, as used by zip and PNG
+constexpr auto CRCTable = [] {
+  std::array<std::uint32_t, 256> ret {};
+  for (std::uint32_t i = 0; i < ret.size(); ++i) {
+    auto value = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      value = (value & 1) ? (0xedb88320 ^ (value >> 1)) : (value >> 1);
+    }
+    ret[i] = value;
+  }
+  return ret;
+}();
+
+std::uint32_t CRC32(std::span<const std::byte> data) {
+  std::uint32_t ret = 0xffffffff;
+  for (auto&& byte: data) {
+    ret = CRCTable[(ret ^ std::to_integer<std::uint8_t>(byte)) & 0xff]
+      ^ (ret >> 8);
+  }
+  return ret ^ 0xffffffff;
+}
+
+void AppendInteger(std::vector<std::byte>& out, std::uint64_t value) {
+  do {
+    auto byte = static_cast<std::uint8_t>(value & 0x7f);
+    value >>= 7;
+    if (value) {
+      byte |= 0x80;
+    }
+    out.push_back(std::byte {byte});
+  } while (value);
+}
+
+void AppendUInt32(std::vector<std::byte>& out, const std::uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    out.push_back(std::byte {static_cast<std::uint8_t>(value >> shift)});
+  }
+}
+
+// nullopt if truncated or invalid; otherwise, advances `data`
+std::optional<std::uint64_t> ReadInteger(std::span<const std::byte>& data) {
+  std::uint64_t ret = 0;
+  for (int shift = 0; shift < 64 && !data.empty(); shift += 7) {
+    const auto byte = std::to_integer<std::uint8_t>(data.front());
+    data = data.subspan(1);
+    ret |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return ret;
+    }
+  }
+  return std::nullopt;
+}
+
+std::uint32_t ReadUInt32(std::span<const std::byte> data) {
+  std::uint32_t ret = 0;
+  for (int i = 0; i < 4; ++i) {
+    ret |= static_cast<std::uint32_t>(std::to_integer<std::uint8_t>(data[i]))
+      << (i * 8);
+  }
+  return ret;
+}
+
+std::vector<std::byte> MakeRecord(
+  const RecordKind kind,
+  std::span<const std::byte> data) {
+  std::vector<std::byte> payload;
+  payload.reserve(data.size() + 1);
+  payload.push_back(std::byte {std::to_underlying(kind)});
+  payload.insert(payload.end(), data.begin(), data.end());
+
+  std::vector<std::byte> ret;
+  ret.reserve(RecordHeaderSize + payload.size());
+  AppendUInt32(ret, static_cast<std::uint32_t>(payload.size()));
+  AppendUInt32(ret, CRC32(payload));
+  ret.insert(ret.end(), payload.begin(), payload.end());
+  return ret;
+}
+
+class RecordReader {
+ public:
+  explicit RecordReader(std::span<const std::byte> data) : mData(data) {}
+
+  // nullopt at the end, or if the next record is torn or corrupt; nothing
+  // after a damaged record can be trusted
+  std::optional<std::span<const std::byte>> Next() {
+    if (mData.size() < RecordHeaderSize) {
+      return std::nullopt;
+    }
+    const auto size = ReadUInt32(mData.first(4));
+    const auto crc = ReadUInt32(mData.subspan(4, 4));
+    if (size == 0 || size > mData.size() - RecordHeaderSize) {
+      return std::nullopt;
+    }
+    const auto payload = mData.subspan(RecordHeaderSize, size);
+    if (CRC32(payload) != crc) {
+      return std::nullopt;
+    }
+    mData = mData.subspan(RecordHeaderSize + size);
+    return payload;
+  }
+
+ private:
+  std::span<const std::byte> mData;
+};
+
+}// namespace
+
+RunJournal::RunJournal(const std::filesystem::path& path, const Plan& plan)
+  : mPath(path),
+    mStepCount(plan.GetSteps().size()) {
+  std::vector<std::byte> data {Magic.begin(), Magic.end()};
+  AppendInteger(data, FormatVersion);
+  const auto record = MakeRecord(RecordKind::Plan, plan.Serialize());
+  data.insert(data.end(), record.begin(), record.end());
+
+  auto file = DurableFile::Create(path);
+  file.Append(data);
+  mFile.emplace(std::move(file));
+}
+
+// If `Complete()` wasn't called, the run was interrupted, so the journal is
+// kept
+RunJournal::~RunJournal() = default;
+
+void RunJournal::MarkStarted(const std::size_t step) noexcept {
+  Append(std::to_underlying(RecordKind::StepStarted), step);
+}
+
+void RunJournal::MarkSucceeded(const std::size_t step) noexcept {
+  Append(std::to_underlying(RecordKind::StepSucceeded), step);
+}
+
+void RunJournal::Complete() noexcept {
+  std::unique_lock lock(mMutex);
+  mFile.reset();
+  std::error_code ec;
+  std::filesystem::remove(mPath, ec);
+}
+
+void RunJournal::Append(
+  const std::uint8_t kind,
+  const std::size_t step) noexcept {
+  std::unique_lock lock(mMutex);
+  if (!mFile || step >= mStepCount) {
+    return;
+  }
+  try {
+    std::vector<std::byte> data;
+    AppendInteger(data, step);
+    mFile->Append(MakeRecord(static_cast<RecordKind>(kind), data));
+  } catch (...) {
+    // A partial record would hide any later ones, so stop here
+    mFile.reset();
+  }
+}
+
+std::optional<RunJournal::Recovery> RunJournal::Recover(
+  const std::filesystem::path& path) {
+  std::ifstream file {path, std::ios::binary};
+  if (!file) {
+    return std::nullopt;
+  }
+  const std::vector<char> contents {
+    std::istreambuf_iterator<char> {file}, std::istreambuf_iterator<char> {}};
+  auto data = std::as_bytes(std::span {contents});
+
+  if (
+    data.size() < Magic.size()
+    || !std::ranges::equal(data.first(Magic.size()), Magic)) {
+    return std::nullopt;
+  }
+  data = data.subspan(Magic.size());
+  if (ReadInteger(data) != FormatVersion) {
+    return std::nullopt;
+  }
+
+  RecordReader reader {data};
+  const auto planRecord = reader.Next();
+  constexpr std::byte PlanKind {std::to_underlying(RecordKind::Plan)};
+  if (!planRecord || planRecord->front() != PlanKind) {
+    return std::nullopt;
+  }
+  Recovery ret;
+  try {
+    ret.mPlan = Plan::Deserialize(planRecord->subspan(1));
+  } catch (const std::runtime_error&) {
+    return std::nullopt;
+  }
+  ret.mStates.assign(ret.mPlan.GetSteps().size(), StepState::Pending);
+
+  while (const auto record = reader.Next()) {
+    auto payload = record->subspan(1);
+    const auto step = ReadInteger(payload);
+    if (!step || *step >= ret.mStates.size() || !payload.empty()) {
+      break;
+    }
+    auto& state = ret.mStates.at(static_cast<std::size_t>(*step));
+    const auto kind = static_cast<RecordKind>(
+      std::to_integer<std::uint8_t>(record->front()));
+    if (kind == RecordKind::StepStarted) {
+      state = std::max(state, StepState::Started);
+    } else if (kind == RecordKind::StepSucceeded) {
+      state = StepState::Succeeded;
+    } else {
+      break;
+    }
+  }
+  return ret;
+}
+
+Plan RunJournal::Recovery::GetRemainingPlan(const Registry& registry) const {
+  Plan::Builder builder;
+  const auto steps = mPlan.GetSteps();
+  for (std::size_t i = 0; i < steps.size(); ++i) {
+    const auto& step = steps[i];
+    const auto operations = mPlan.GetOperations(step);
+    std::vector<PlannedOperation> remaining;
+    switch (mStates.at(i)) {
+      case StepState::Succeeded:
+        continue;
+      case StepState::Pending:
+        remaining.assign(operations.begin(), operations.end());
+        break;
+      case StepState::Started:
+        std::ranges::copy_if(
+          operations,
+          std::back_inserter(remaining),
+          [&registry](const auto& it) { return !IsApplied(it, registry); });
+        if (remaining.empty()) {
+          continue;
+        }
+        break;
+    }
+    builder.AddStep(step.mTitle, step.mAction, std::move(remaining));
+  }
+  return std::move(builder).Build();
+}
@@ -0,0 +1,73 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "DurableFile.hpp"
+#include "Plan.hpp"
+#include "Registry.hpp"
+
+// Write-ahead journal of a cleanup run, so that if the process or machine
+// dies part-way through - e.g. an uninstaller restarts Windows - the next
+// launch can resume the run without discovering everything again.
+//
+// The plan is written first, then a record before each step starts, and
+// another after it succeeds; each record is on disk before it's used.
+// Records are checksummed, so if the last one was torn, or the file is
+// otherwise corrupt, everything before the damage is still used.
+class RunJournal {
+ public:
+  enum class StepState : std::uint8_t {
+    Pending,
+    Started,
+    Succeeded,
+  };
+
+  struct Recovery {
+    Plan mPlan;
+    // Indexed like `mPlan.GetSteps()`
+    std::vector<StepState> mStates;
+
+    // Every step that didn't succeed, in order. Steps that had started only
+    // keep the operations whose effects aren't already in place, and are
+    // dropped if there are none.
+    [[nodiscard]] Plan GetRemainingPlan(
+      const Registry& registry = Registry::Get()) const;
+  };
+
+  RunJournal() = delete;
+  // Replaces any existing journal, and returns once the plan is on disk.
+  // Throws `std::filesystem::filesystem_error`.
+  RunJournal(const std::filesystem::path&, const Plan&);
+  ~RunJournal();
+
+  RunJournal(const RunJournal&) = delete;
+  RunJournal& operator=(const RunJournal&) = delete;
+
+  // Thread-safe. Failures are ignored, as the run shouldn't fail just
+  // because it can't be resumed; a step that isn't recorded as succeeded
+  // is retried.
+  void MarkStarted(std::size_t step) noexcept;
+  void MarkSucceeded(std::size_t step) noexcept;
+  // The run is over, so there's nothing to resume; removes the journal
+  void Complete() noexcept;
+
+  // nullopt if there's no journal, or if even the plan can't be read
+  [[nodiscard]] static std::optional<Recovery> Recover(
+    const std::filesystem::path&);
+
+ private:
+  std::filesystem::path mPath;
+  std::mutex mMutex;
+  // Empty once complete, or after a write fails
+  std::optional<DurableFile> mFile;
+  std::size_t mStepCount {};
+
+  void Append(std::uint8_t kind, std::size_t step) noexcept;
+};
@@ -0,0 +1,84 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "ScanReport.hpp"
+
+#include <format>
+
+#include "JSON.hpp"
+
+namespace {
+ScanReport::FoundArtifact ReadArtifact(JSONReader& reader) {
+  ScanReport::FoundArtifact ret;
+  reader.ReadObject([&](const std::string_view key) {
+    if (key == "title") {
+      ret.mTitle = reader.ReadString();
+    } else if (key == "kind") {
+      ret.mKind = reader.ReadString();
+    } else if (key == "present") {
+      ret.mIsPresent = reader.ReadBool();
+    } else if (key == "outdated") {
+      ret.mIsOutdated = reader.ReadBool();
+    } else if (key == "earliestVersion") {
+      ret.mEarliestVersion = reader.ReadString();
+    } else if (key == "removedVersion") {
+      if (!reader.TryReadNull()) {
+        ret.mRemovedVersion = reader.ReadString();
+      }
+    } else if (key == "action") {
+      ret.mAction = reader.ReadString();
+    } else {
+      reader.Skip();
+    }
+  });
+  return ret;
+}
+
+ScanReport::Step ReadStep(JSONReader& reader) {
+  ScanReport::Step ret;
+  reader.ReadObject([&](const std::string_view key) {
+    if (key == "title") {
+      ret.mTitle = reader.ReadString();
+    } else if (key == "action") {
+      ret.mAction = reader.ReadString();
+    } else if (key == "outcome") {
+      ret.mOutcome = reader.ReadString();
+    } else {
+      reader.Skip();
+    }
+  });
+  return ret;
+}
+}// namespace
+
+ScanReport ScanReport::Parse(const std::string_view json) {
+  ScanReport ret;
+  JSONReader reader {json};
+  reader.ReadObject([&](const std::string_view key) {
+    if (key == "schemaVersion") {
+      ret.mSchemaVersion = reader.ReadInteger();
+    } else if (key == "freshStartVersion") {
+      ret.mFreshStartVersion = reader.ReadString();
+    } else if (key == "artifacts") {
+      reader.ReadArray(
+        [&] { ret.mArtifacts.push_back(ReadArtifact(reader)); });
+    } else if (key == "incompleteChecks") {
+      reader.ReadArray(
+        [&] { ret.mIncompleteChecks.push_back(reader.ReadString()); });
+    } else if (key == "steps") {
+      reader.ReadArray([&] { ret.mSteps.push_back(ReadStep(reader)); });
+    } else {
+      reader.Skip();
+    }
+  });
+  reader.ExpectEnd();
+
+  if (ret.mSchemaVersion < 1) {
+    throw JSONError("Missing or invalid schemaVersion");
+  }
+  if (ret.mSchemaVersion > ScanReportSchemaVersion) {
+    throw UnsupportedScanReportError(
+      std::format("Unsupported schema version {}", ret.mSchemaVersion));
+  }
+  return ret;
+}
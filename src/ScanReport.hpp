@@ -0,0 +1,53 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The report written by headless mode with `--json`, and read by
+// `fleet-inventory`.
+//
+// `ScanReportSchemaVersion` is increased whenever a field is removed or
+// changes meaning; fields can be added without changing it, as readers
+// skip fields they don't know.
+constexpr std::int64_t ScanReportSchemaVersion = 1;
+
+class UnsupportedScanReportError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+struct ScanReport {
+  struct FoundArtifact {
+    std::string mTitle;
+    // e.g. `software`, `userSettings`
+    std::string mKind;
+    bool mIsPresent {false};
+    bool mIsOutdated {false};
+    std::string mEarliestVersion;
+    // Empty if still used by current versions
+    std::string mRemovedVersion;
+    // `none`, `repair`, or `remove`
+    std::string mAction;
+  };
+  struct Step {
+    std::string mTitle;
+    std::string mAction;
+    // Empty if the plan wasn't applied, i.e. with `--scan`
+    std::string mOutcome;
+  };
+
+  std::int64_t mSchemaVersion {};
+  std::string mFreshStartVersion;
+  std::vector<FoundArtifact> mArtifacts;
+  std::vector<std::string> mIncompleteChecks;
+  std::vector<Step> mSteps;
+
+  // Throws `JSONError` if malformed, or `UnsupportedScanReportError` if
+  // from a newer schema
+  [[nodiscard]] static ScanReport Parse(std::string_view json);
+};
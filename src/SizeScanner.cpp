@@ -0,0 +1,149 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "SizeScanner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "FileSystem.hpp"
+#include "Instrumentation.hpp"
+
+namespace {
+
+class Walker {
+ public:
+  explicit Walker(const SizeScanner::Options& options) : mOptions(options) {}
+
+  void Push(std::filesystem::path folder) {
+    std::unique_lock lock(mMutex);
+    ++mOutstanding;
+    mFolders.push_back(std::move(folder));
+    mChanged.notify_one();
+  }
+
+  void Add(const DirectoryEntry& entry) {
+    Add(std::span {&entry, 1});
+  }
+
+  void Worker() {
+    std::unique_lock lock(mMutex);
+    while (true) {
+      mChanged.wait(
+        lock, [this] { return !mFolders.empty() || mOutstanding == 0; });
+      if (mFolders.empty()) {
+        return;
+      }
+      const auto folder = std::move(mFolders.back());
+      mFolders.pop_back();
+      lock.unlock();
+
+      if (!mOptions.mStopToken.stop_requested()) {
+        Process(folder);
+      }
+
+      lock.lock();
+      if (--mOutstanding == 0) {
+        mChanged.notify_all();
+      }
+    }
+  }
+
+  [[nodiscard]] DiskUsage GetResult() const {
+    return {mAllocatedBytes.load(), mFileCount.load()};
+  }
+
+ private:
+  SizeScanner::Options mOptions;
+  FileSystem& mFileSystem {FileSystem::Get()};
+
+  std::mutex mMutex;
+  std::condition_variable mChanged;
+  std::vector<std::filesystem::path> mFolders;
+  std::size_t mOutstanding {};
+
+  std::atomic<std::uint64_t> mAllocatedBytes {};
+  std::atomic<std::uint64_t> mFileCount {};
+
+  std::mutex mSeenMutex;
+  std::unordered_set<FileID> mSeen;
+
+  // Files only; takes the lock once for the whole batch
+  void Add(std::span<const DirectoryEntry> files) {
+    DiskUsage usage;
+    std::unique_lock lock(mSeenMutex, std::defer_lock);
+    for (auto&& it: files) {
+      if (it.mHardLinkID) {
+        if (!lock.owns_lock()) {
+          lock.lock();
+        }
+        if (!mSeen.insert(*it.mHardLinkID).second) {
+          continue;
+        }
+      }
+      usage += {it.mAllocatedBytes, 1};
+    }
+    mAllocatedBytes += usage.mAllocatedBytes;
+    mFileCount += usage.mFileCount;
+  }
+
+  void Process(const std::filesystem::path& folder) {
+    std::error_code ec;
+    auto entries = RetryIfInUse(
+      [&](auto& error) {
+        return mFileSystem.ListDirectory(folder, error, ListingDetail::Full);
+      },
+      ec);
+    Instrumentation::Increment(
+      Instrumentation::Counter::FilesVisited, entries.size());
+    const auto folders = std::ranges::partition(
+      entries, [](const auto& it) { return !it.mIsDirectory; });
+    for (auto&& it: folders) {
+      Push(std::move(it.mPath));
+    }
+    Add(std::span {entries.begin(), folders.begin()});
+  }
+};
+
+}// namespace
+
+SizeScanner::SizeScanner(const Options& options) : mOptions(options) {}
+
+DiskUsage SizeScanner::Scan(
+  std::span<const std::filesystem::path> roots) const {
+  const Instrumentation::ScopedTimer timer {"Measure", "SizeScanner"};
+
+  Walker walker {mOptions};
+  for (auto&& root: roots) {
+    std::error_code ec;
+    const auto entry = RetryIfInUse(
+      [&root](auto& error) {
+        return FileSystem::Get().GetDirectoryEntry(root, error);
+      },
+      ec);
+    if (ec) {
+      continue;
+    }
+    if (entry.mIsDirectory) {
+      walker.Push(root);
+    } else {
+      walker.Add(entry);
+    }
+  }
+
+  {
+    // The calling thread is one of the workers
+    std::vector<std::jthread> threads;
+    const auto threadCount = std::max<std::size_t>(mOptions.mThreadCount, 1);
+    threads.reserve(threadCount - 1);
+    for (std::size_t i = 1; i < threadCount; ++i) {
+      threads.emplace_back(&Walker::Worker, &walker);
+    }
+    walker.Worker();
+  }
+  return walker.GetResult();
+}
@@ -0,0 +1,45 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <stop_token>
+#include <thread>
+
+struct DiskUsage {
+  std::uint64_t mAllocatedBytes {};
+  // Not including folders
+  std::uint64_t mFileCount {};
+
+  DiskUsage& operator+=(const DiskUsage& other) noexcept {
+    mAllocatedBytes += other.mAllocatedBytes;
+    mFileCount += other.mFileCount;
+    return *this;
+  }
+};
+
+// Measures how much disk space files and folders use, listing folders in
+// parallel.
+//
+// Files with several hard links are only counted once, even if they're
+// reached through more than one root. Links and junctions are counted, but
+// not followed. Anything that can't be read is skipped.
+class SizeScanner {
+ public:
+  struct Options {
+    std::size_t mThreadCount {std::thread::hardware_concurrency()};
+    // If stopped, `Scan()` returns soon, with a partial result
+    std::stop_token mStopToken;
+  };
+
+  SizeScanner() = default;
+  explicit SizeScanner(const Options& options);
+
+  [[nodiscard]] DiskUsage Scan(
+    std::span<const std::filesystem::path> roots) const;
+
+ private:
+  Options mOptions;
+};
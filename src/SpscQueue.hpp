@@ -0,0 +1,54 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+// A bounded lock-free queue, with exactly one producer thread and one
+// consumer thread
+template <class T, std::size_t Capacity>
+  requires(std::has_single_bit(Capacity))
+class SpscQueue {
+ public:
+  SpscQueue() = default;
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  // Producer only; false if the queue is full
+  [[nodiscard]] bool TryPush(T value) {
+    const auto tail = mTail.load(std::memory_order_relaxed);
+    if (tail - mHead.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+    mSlots[tail % Capacity] = std::move(value);
+    mTail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only
+  [[nodiscard]] std::optional<T> TryPop() {
+    const auto head = mHead.load(std::memory_order_relaxed);
+    if (head == mTail.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    auto ret = std::move(mSlots[head % Capacity]);
+    mHead.store(head + 1, std::memory_order_release);
+    return ret;
+  }
+
+ private:
+  // Keep the indices on separate cache lines, so the producer and consumer
+  // don't contend
+  static constexpr std::size_t CacheLineSize = 64;
+
+  // Next slot to read; written by the consumer
+  alignas(CacheLineSize) std::atomic<std::size_t> mHead {0};
+  // Next slot to write; written by the producer
+  alignas(CacheLineSize) std::atomic<std::size_t> mTail {0};
+  alignas(CacheLineSize) std::array<T, Capacity> mSlots {};
+};
@@ -0,0 +1,140 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "SyntheticFootprint.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include "artifacts/LocalAppDataSettings.hpp"
+#include "artifacts/LogsFolder.hpp"
+#include "artifacts/ProgramData.hpp"
+#include "artifacts/SavedGamesSettings.hpp"
+#include "artifacts/TemporaryFilesFolder.hpp"
+
+namespace {
+// Roughly the size of a real settings file
+constexpr std::size_t SettingsFileSize = 2 * 1024;
+constexpr std::size_t SettingsFileCount = 8;
+constexpr std::size_t HookFileSize = 1024;
+constexpr std::size_t TempFileSize = 64 * 1024;
+
+// Not part of the footprint; only created so that there's something to skip
+void CreateOtherFile(const std::filesystem::path& path) {
+  std::ofstream file {path, std::ios::binary};
+  file << "not OpenKneeboard";
+  if (!file) {
+    throw std::filesystem::filesystem_error(
+      "Failed to create file",
+      path,
+      std::make_error_code(std::errc::io_error));
+  }
+}
+}// namespace
+
+SyntheticFootprint::SyntheticFootprint(
+  const std::filesystem::path& root,
+  const Options& options)
+  : mRoots {
+      .mDocuments = root / "Documents",
+      .mLocalAppData = root / "LocalAppData",
+      .mProgramData = root / "ProgramData",
+      .mSavedGames = root / "Saved Games",
+      .mTemp = root / "Temp",
+    } {
+  if (std::filesystem::exists(root)) {
+    throw std::filesystem::filesystem_error(
+      "Footprint folder already exists",
+      root,
+      std::make_error_code(std::errc::file_exists));
+  }
+  for (auto&& it: {
+         mRoots.mDocuments,
+         mRoots.mLocalAppData,
+         mRoots.mProgramData,
+         mRoots.mSavedGames,
+         mRoots.mTemp,
+       }) {
+    std::filesystem::create_directories(it);
+  }
+
+  const KnownFolders folders {mRoots};
+  const auto getPath = [&folders](const KnownFolders::Location& location) {
+    return folders.GetRoot(location.mRoot) / location.mChild;
+  };
+
+  for (auto&& location: {
+         ProgramData::Location,
+         SavedGamesSettings::Location,
+         LocalAppDataSettings::Location,
+       }) {
+    const auto folder = getPath(location);
+    CreateFolder(folder);
+    for (std::size_t i = 0; i < SettingsFileCount; ++i) {
+      CreateFile(folder / std::format("Settings{}.json", i), SettingsFileSize);
+    }
+  }
+
+  for (std::size_t i = 0; i < options.mGameFolderCount; ++i) {
+    if (i % 2) {
+      const auto game = mRoots.mSavedGames / std::format("Game {}", i);
+      std::filesystem::create_directories(game);
+      CreateOtherFile(game / "Save.dat");
+      continue;
+    }
+    const auto hooks
+      = mRoots.mSavedGames / std::format("DCS.{}", i) / "Scripts" / "Hooks";
+    std::filesystem::create_directories(hooks);
+    CreateOtherFile(hooks / "OtherHook.lua");
+    CreateFile(hooks / "OpenKneeboardDCSExt.lua", HookFileSize);
+  }
+
+  const auto logs = getPath(LogsFolder::Location);
+  CreateFolder(logs);
+  const auto logFolderCount = std::max<std::size_t>(options.mLogFolderCount, 1);
+  for (std::size_t i = 0; i < logFolderCount; ++i) {
+    CreateFolder(logs / std::format("{}", i));
+  }
+  for (std::size_t i = 0; i < options.mLogFileCount; ++i) {
+    CreateFile(
+      logs / std::format("{}", i % logFolderCount)
+        / std::format("OpenKneeboard-{}.log", i),
+      options.mLogFileSize);
+  }
+
+  auto temp = getPath(TemporaryFilesFolder::Location);
+  CreateFolder(temp);
+  for (std::size_t i = 0; i < options.mTempDepth; ++i) {
+    temp /= std::format("{}", i);
+    CreateFolder(temp);
+    CreateFile(temp / "Texture.bin", TempFileSize);
+  }
+}
+
+void SyntheticFootprint::CreateFolder(const std::filesystem::path& path) {
+  std::filesystem::create_directory(path);
+  mSize += {.mFiles = 1};
+}
+
+void SyntheticFootprint::CreateFile(
+  const std::filesystem::path& path,
+  const std::size_t size) {
+  std::ofstream file {path, std::ios::binary};
+  // Not sparse, so that removal has real blocks to free
+  const std::string chunk(4096, 'x');
+  for (std::size_t written = 0; written < size; written += chunk.size()) {
+    file.write(
+      chunk.data(),
+      static_cast<std::streamsize>(std::min(chunk.size(), size - written)));
+  }
+  if (!file) {
+    throw std::filesystem::filesystem_error(
+      "Failed to create file",
+      path,
+      std::make_error_code(std::errc::io_error));
+  }
+  mSize += {.mBytes = size, .mFiles = 1};
+}
@@ -0,0 +1,51 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+#include "KnownFolders.hpp"
+#include "Progress.hpp"
+
+// A made-up OpenKneeboard footprint, for measuring discovery and removal
+// on any machine, without a real installation; see `footprint-benchmark`.
+//
+// Everything is created in one folder, with a subfolder for each known
+// folder; use `GetRoots()` to find artifacts in it.
+class SyntheticFootprint {
+ public:
+  struct Options {
+    // Folders in 'Saved Games'; every other one looks like a DCS
+    // installation, with OpenKneeboard's hooks
+    std::size_t mGameFolderCount {20};
+    // Spread evenly across `mLogFolderCount` folders
+    std::size_t mLogFileCount {1000};
+    std::size_t mLogFolderCount {10};
+    std::size_t mLogFileSize {4 * 1024};
+    // Folders nested inside the temporary files folder, each with a file
+    std::size_t mTempDepth {50};
+  };
+
+  SyntheticFootprint() = delete;
+  // `root` must not exist yet.
+  //
+  // Throws `std::filesystem::filesystem_error` if anything can't be created.
+  SyntheticFootprint(const std::filesystem::path& root, const Options&);
+
+  [[nodiscard]] KnownFolders::Roots GetRoots() const {
+    return mRoots;
+  }
+  // Everything that removing every artifact should remove, i.e. not
+  // including the known folders themselves, or other games' files
+  [[nodiscard]] WorkAmount GetSize() const {
+    return mSize;
+  }
+
+ private:
+  KnownFolders::Roots mRoots;
+  WorkAmount mSize;
+
+  void CreateFolder(const std::filesystem::path&);
+  void CreateFile(const std::filesystem::path&, std::size_t size);
+};
@@ -0,0 +1,249 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <semaphore>
+#include <type_traits>
+#include <utility>
+
+// A lazily-started coroutine, producing a `T`.
+//
+// Nothing runs until the task is awaited, or passed to `StartTask()` or
+// `SyncWait()`. When the coroutine finishes, whatever was awaiting it is
+// resumed on the same thread; use `ThreadPool::Schedule()` to move blocking
+// work off the caller's thread.
+//
+// Exceptions are rethrown in the awaiter.
+template <class T = void>
+class Task;
+
+namespace TaskDetail {
+
+class PromiseBase {
+ public:
+  std::suspend_always initial_suspend() noexcept {
+    return {};
+  }
+
+  // Resume whatever was waiting for us, without growing the stack
+  auto final_suspend() noexcept {
+    struct Awaiter {
+      bool await_ready() noexcept {
+        return false;
+      }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<>) noexcept {
+        if (mContinuation) {
+          return mContinuation;
+        }
+        return std::noop_coroutine();
+      }
+      void await_resume() noexcept {}
+
+      std::coroutine_handle<> mContinuation;
+    };
+    return Awaiter {mContinuation};
+  }
+
+  void unhandled_exception() noexcept {
+    mException = std::current_exception();
+  }
+
+  void SetContinuation(std::coroutine_handle<> continuation) noexcept {
+    mContinuation = continuation;
+  }
+
+ protected:
+  std::coroutine_handle<> mContinuation;
+  std::exception_ptr mException;
+
+  void RethrowIfFailed() const {
+    if (mException) {
+      std::rethrow_exception(mException);
+    }
+  }
+};
+
+template <class T>
+class Promise final : public PromiseBase {
+ public:
+  Task<T> get_return_object() noexcept;
+
+  template <std::convertible_to<T> U>
+  void return_value(U&& value) {
+    mValue.emplace(std::forward<U>(value));
+  }
+
+  T TakeResult() {
+    this->RethrowIfFailed();
+    return std::move(*mValue);
+  }
+
+ private:
+  std::optional<T> mValue;
+};
+
+template <>
+class Promise<void> final : public PromiseBase {
+ public:
+  Task<void> get_return_object() noexcept;
+
+  void return_void() noexcept {}
+
+  void TakeResult() {
+    this->RethrowIfFailed();
+  }
+};
+
+// Fire-and-forget coroutine used by `StartTask()`; destroys itself when done
+struct Detached {
+  struct promise_type {
+    Detached get_return_object() noexcept {
+      return {};
+    }
+    std::suspend_never initial_suspend() noexcept {
+      return {};
+    }
+    std::suspend_never final_suspend() noexcept {
+      return {};
+    }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept {
+      std::terminate();
+    }
+  };
+};
+
+template <class T>
+struct ResultSlot {
+  std::optional<T> mValue;
+};
+template <>
+struct ResultSlot<void> {};
+
+template <class T>
+Task<> StoreResult(Task<T> task, ResultSlot<T>& slot);
+
+}// namespace TaskDetail
+
+template <class T>
+class [[nodiscard]] Task {
+ public:
+  using promise_type = TaskDetail::Promise<T>;
+  using Handle = std::coroutine_handle<promise_type>;
+
+  Task() = default;
+  explicit Task(Handle handle) noexcept : mHandle(handle) {}
+  Task(Task&& other) noexcept : mHandle(std::exchange(other.mHandle, {})) {}
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      mHandle = std::exchange(other.mHandle, {});
+    }
+    return *this;
+  }
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+
+  ~Task() {
+    Reset();
+  }
+
+  [[nodiscard]] bool IsValid() const noexcept {
+    return static_cast<bool>(mHandle);
+  }
+
+  // Starts the task, and resumes the awaiter when it's done
+  auto operator co_await() && noexcept {
+    struct Awaiter {
+      bool await_ready() noexcept {
+        return false;
+      }
+      std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<> awaiter) noexcept {
+        mHandle.promise().SetContinuation(awaiter);
+        return mHandle;
+      }
+      T await_resume() {
+        return mHandle.promise().TakeResult();
+      }
+
+      Handle mHandle;
+    };
+    return Awaiter {mHandle};
+  }
+
+ private:
+  Handle mHandle;
+
+  void Reset() noexcept {
+    if (mHandle) {
+      std::exchange(mHandle, {}).destroy();
+    }
+  }
+};
+
+template <class T>
+Task<T> TaskDetail::Promise<T>::get_return_object() noexcept {
+  return Task<T> {std::coroutine_handle<Promise>::from_promise(*this)};
+}
+
+inline Task<void> TaskDetail::Promise<void>::get_return_object() noexcept {
+  return Task<void> {std::coroutine_handle<Promise>::from_promise(*this)};
+}
+
+// Starts `task` without waiting for it; `onComplete` is invoked with the
+// exception, if any, on whichever thread finishes the task.
+//
+// If the task completes synchronously, `onComplete` is invoked before this
+// returns.
+template <class F>
+  requires std::invocable<F&, std::exception_ptr>
+void StartTask(Task<> task, F onComplete) {
+  // Not a lambda: coroutine lambdas don't keep their captures alive
+  struct Starter {
+    static TaskDetail::Detached Run(Task<> task, F onComplete) {
+      std::exception_ptr error;
+      try {
+        co_await std::move(task);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      onComplete(error);
+    }
+  };
+  Starter::Run(std::move(task), std::move(onComplete));
+}
+
+template <class T>
+Task<> TaskDetail::StoreResult(Task<T> task, ResultSlot<T>& slot) {
+  if constexpr (std::is_void_v<T>) {
+    co_await std::move(task);
+  } else {
+    slot.mValue.emplace(co_await std::move(task));
+  }
+}
+
+// Blocks the calling thread until `task` is done
+template <class T>
+T SyncWait(Task<T> task) {
+  TaskDetail::ResultSlot<T> slot;
+  std::exception_ptr error;
+  std::binary_semaphore done {0};
+  StartTask(
+    TaskDetail::StoreResult(std::move(task), slot),
+    [&](std::exception_ptr it) {
+      error = it;
+      done.release();
+    });
+  done.acquire();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  if constexpr (!std::is_void_v<T>) {
+    return std::move(*slot.mValue);
+  }
+}
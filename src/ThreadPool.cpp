@@ -0,0 +1,54 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <functional>
+
+ThreadPool::ThreadPool(const std::size_t threadCount) {
+  const auto count = std::max<std::size_t>(threadCount, 1);
+  mThreads.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    mThreads.emplace_back(std::bind_front(&ThreadPool::Run, this));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  for (auto&& it: mThreads) {
+    it.request_stop();
+  }
+  // `std::jthread` joins
+}
+
+ThreadPool& ThreadPool::GetShared() {
+  // Threads may block for a long time, so allow a few more than there are
+  // cores
+  static auto& sInstance = *new ThreadPool(
+    std::max(std::thread::hardware_concurrency(), 4u));
+  return sInstance;
+}
+
+void ThreadPool::Enqueue(std::coroutine_handle<> handle) {
+  {
+    std::unique_lock lock(mMutex);
+    mQueue.push_back(handle);
+  }
+  mChanged.notify_one();
+}
+
+void ThreadPool::Run(std::stop_token stopToken) {
+  std::unique_lock lock(mMutex);
+  while (true) {
+    // Drain the queue before stopping, so nothing is left suspended
+    mChanged.wait(lock, stopToken, [this] { return !mQueue.empty(); });
+    if (mQueue.empty()) {
+      return;
+    }
+    const auto handle = mQueue.front();
+    mQueue.pop_front();
+    lock.unlock();
+    handle.resume();
+    lock.lock();
+  }
+}
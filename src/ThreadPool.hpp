@@ -0,0 +1,75 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Task.hpp"
+
+// A fixed set of threads for resuming coroutines; see `Task`.
+//
+// Work is started in the order it was scheduled.
+class ThreadPool {
+ public:
+  explicit ThreadPool(
+    std::size_t threadCount = std::thread::hardware_concurrency());
+  // Waits for queued work to finish
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // For blocking work, e.g. filesystem or Windows Installer calls.
+  //
+  // Never destroyed, as threads may still be stuck in work that was
+  // abandoned, e.g. after a timeout.
+  static ThreadPool& GetShared();
+
+  // `co_await pool.Schedule()` resumes the coroutine on a pool thread
+  [[nodiscard]] auto Schedule() noexcept {
+    struct Awaiter {
+      bool await_ready() noexcept {
+        return false;
+      }
+      void await_suspend(std::coroutine_handle<> handle) {
+        mPool->Enqueue(handle);
+      }
+      void await_resume() noexcept {}
+
+      ThreadPool* mPool {nullptr};
+    };
+    return Awaiter {this};
+  }
+
+  [[nodiscard]] std::size_t GetThreadCount() const noexcept {
+    return mThreads.size();
+  }
+
+ private:
+  std::mutex mMutex;
+  std::condition_variable_any mChanged;
+  std::deque<std::coroutine_handle<>> mQueue;
+
+  // Last, so that they're stopped before anything else is destroyed
+  std::vector<std::jthread> mThreads;
+
+  void Enqueue(std::coroutine_handle<>);
+  void Run(std::stop_token);
+};
+
+// Runs `f` on the shared pool, for blocking work that has no native
+// asynchronous version
+template <class F>
+Task<std::invoke_result_t<F&>> RunBlocking(F f) {
+  co_await ThreadPool::GetShared().Schedule();
+  co_return f();
+}
@@ -0,0 +1,7 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+// Lower the CPU and, where supported, I/O priority of the calling thread, so
+// that background work doesn't compete with the UI or other applications
+void LowerCurrentThreadPriority();
@@ -0,0 +1,131 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "TombstoneReaper.hpp"
+
+#include <format>
+#include <random>
+#include <utility>
+
+#include "FileSystem.hpp"
+#include "Instrumentation.hpp"
+#include "ParallelDelete.hpp"
+#include "ThreadPriority.hpp"
+
+namespace {
+std::filesystem::path MakeTombstoneName(const std::filesystem::path& path) {
+  thread_local std::mt19937_64 random {std::random_device {}()};
+  auto ret = path.filename();
+  ret += std::format("-{:016x}", random());
+  return ret;
+}
+}// namespace
+
+TombstoneReaper::TombstoneReaper()
+  : mThread(std::bind_front(&TombstoneReaper::Run, this)) {}
+
+TombstoneReaper::~TombstoneReaper() = default;
+
+TombstoneReaper& TombstoneReaper::Get() {
+  static TombstoneReaper sInstance;
+  return sInstance;
+}
+
+bool TombstoneReaper::Bury(const std::filesystem::path& path) {
+  const Instrumentation::ScopedTimer timer {"Remove", "TombstoneReaper::Bury"};
+  auto& fileSystem = FileSystem::Get();
+  const auto folder = path.parent_path() / FolderName;
+  std::error_code ec;
+  fileSystem.CreateDirectory(folder, ec);
+  if (ec) {
+    return false;
+  }
+
+  // Not retried if it's in use: deleting in place is usually quicker than
+  // waiting
+  const auto tombstone = folder / MakeTombstoneName(path);
+  fileSystem.Rename(path, tombstone, ec);
+  if (ec) {
+    // Only succeeds if it's empty, i.e. we just created it
+    fileSystem.Remove(folder, ec);
+    return false;
+  }
+  Enqueue(tombstone);
+  return true;
+}
+
+void TombstoneReaper::ReapLeftovers(const std::filesystem::path& parent) {
+  std::error_code ec;
+  const auto tombstones = RetryIfInUse(
+    [folder = parent / FolderName](auto& error) {
+      return FileSystem::Get().ListDirectory(
+        folder, error, ListingDetail::TypeOnly);
+    },
+    ec);
+  for (auto&& it: tombstones) {
+    Enqueue(it.mPath);
+  }
+}
+
+bool TombstoneReaper::IsBusy() const {
+  std::unique_lock lock(mMutex);
+  return mIsReaping || !mQueue.empty();
+}
+
+void TombstoneReaper::WaitUntilIdle(const std::stop_token stop) const {
+  std::unique_lock lock(mMutex);
+  mIdle.wait(lock, stop, [this] { return !mIsReaping && mQueue.empty(); });
+}
+
+void TombstoneReaper::SetIdleCallback(std::function<void()> callback) {
+  std::unique_lock lock(mMutex);
+  mIdleCallback = std::move(callback);
+}
+
+void TombstoneReaper::Enqueue(std::filesystem::path path) {
+  std::unique_lock lock(mMutex);
+  mQueue.push_back(std::move(path));
+  mChanged.notify_one();
+}
+
+void TombstoneReaper::Run(std::stop_token stop) {
+  LowerCurrentThreadPriority();
+
+  // One thread; this is background work
+  const ParallelDelete deleter {{.mThreadCount = 1, .mStopToken = stop}};
+
+  std::unique_lock lock(mMutex);
+  while (mChanged.wait(lock, stop, [this] { return !mQueue.empty(); })) {
+    const auto tombstone = std::move(mQueue.front());
+    mQueue.pop_front();
+    mIsReaping = true;
+    lock.unlock();
+
+    // Failures are retried by `ReapLeftovers()` next time
+    const auto result = deleter.Remove(tombstone);
+    Instrumentation::Increment(
+      Instrumentation::Counter::FilesVisited, result.mRemovedCount);
+    if (result.mErrors.empty()) {
+      // Only succeeds if this was the last one
+      std::error_code ec;
+      RetryIfInUse(
+        [folder = tombstone.parent_path()](auto& error) {
+          return FileSystem::Get().Remove(folder, error);
+        },
+        ec);
+    }
+
+    lock.lock();
+    mIsReaping = false;
+    if (!mQueue.empty()) {
+      continue;
+    }
+    mIdle.notify_all();
+    if (mIdleCallback) {
+      const auto callback = mIdleCallback;
+      lock.unlock();
+      callback();
+      lock.lock();
+    }
+  }
+}
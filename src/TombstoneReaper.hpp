@@ -0,0 +1,61 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+// Makes removing a folder instant, by renaming it into a 'tombstone' folder
+// beside it, then deleting it on a low-priority background thread.
+//
+// The tombstone folder is a sibling of the buried folder, so the move stays
+// on the same volume, and the original path disappears at once.
+//
+// If the process exits first, deletion stops, and the rest is picked up by
+// `ReapLeftovers()` next time.
+class TombstoneReaper {
+ public:
+  // Created beside each buried folder
+  static constexpr std::wstring_view FolderName {
+    L"OpenKneeboard Fresh Start - Pending Deletion"};
+
+  TombstoneReaper();
+  ~TombstoneReaper();
+
+  TombstoneReaper(const TombstoneReaper&) = delete;
+  TombstoneReaper& operator=(const TombstoneReaper&) = delete;
+
+  static TombstoneReaper& Get();
+
+  // False if it couldn't be moved, e.g. because something inside it is in
+  // use; the caller should delete it in place instead
+  [[nodiscard]] bool Bury(const std::filesystem::path&);
+  // Queue tombstones left in `parent` by a previous run
+  void ReapLeftovers(const std::filesystem::path& parent);
+
+  [[nodiscard]] bool IsBusy() const;
+  // Blocks until nothing is queued or being deleted, or `stop` is requested
+  void WaitUntilIdle(std::stop_token stop = {}) const;
+
+  // Invoked on the reaper thread whenever the queue becomes empty
+  void SetIdleCallback(std::function<void()>);
+
+ private:
+  mutable std::mutex mMutex;
+  std::condition_variable_any mChanged;
+  mutable std::condition_variable_any mIdle;
+  std::deque<std::filesystem::path> mQueue;
+  bool mIsReaping {false};
+  std::function<void()> mIdleCallback;
+
+  // Last, so that it's stopped before anything else is destroyed
+  std::jthread mThread;
+
+  void Enqueue(std::filesystem::path);
+  void Run(std::stop_token);
+};
@@ -0,0 +1,189 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <Windows.h>
+#include <wil/registry.h>
+#include <wil/resource.h>
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ChangeWatcher.hpp"
+
+namespace {
+
+class Win32ChangeWatcher final : public ChangeWatcher {
+ public:
+  Win32ChangeWatcher(Callback callback, std::chrono::milliseconds quietPeriod)
+    : ChangeWatcher(std::move(callback), quietPeriod) {
+    mWake.create(wil::EventOptions::None);
+    mThread = std::jthread {&Win32ChangeWatcher::WatchThread, this};
+  }
+
+  ~Win32ChangeWatcher() override {
+    StopDebouncing();
+    {
+      std::unique_lock lock(mMutex);
+      mStopping = true;
+    }
+    mWake.SetEvent();
+    mThread.join();
+  }
+
+  void WatchFolder(
+    Tag tag,
+    const std::filesystem::path& path,
+    bool recursive) override {
+    wil::unique_hfind_change handle {FindFirstChangeNotificationW(
+      path.c_str(),
+      recursive,
+      FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME
+        | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE)};
+    if (!handle) {
+      return;
+    }
+    Add({.mTag = tag, .mFolder = std::move(handle)});
+  }
+
+  void WatchRegistryKey(Tag tag, RegistryHive hive, std::wstring_view subKey)
+    override {
+    const auto root = (hive == RegistryHive::LocalMachine) ? HKEY_LOCAL_MACHINE
+                                                           : HKEY_CURRENT_USER;
+    // HKLM has separate 32- and 64-bit views of SOFTWARE
+    for (auto view: {KEY_WOW64_64KEY, KEY_WOW64_32KEY}) {
+      Watch watch {.mTag = tag};
+      if (
+        RegOpenKeyExW(
+          root,
+          std::wstring {subKey}.c_str(),
+          0,
+          KEY_NOTIFY | view,
+          std::out_ptr(watch.mKey))
+        != ERROR_SUCCESS) {
+        continue;
+      }
+      watch.mKeyChanged.create(wil::EventOptions::None);
+      if (!ArmRegistryWatch(watch)) {
+        continue;
+      }
+      Add(std::move(watch));
+      if (hive == RegistryHive::CurrentUser) {
+        // HKCU isn't split by bitness
+        break;
+      }
+    }
+  }
+
+  void Unwatch(Tag tag) override {
+    {
+      std::unique_lock lock(mMutex);
+      // The watch thread may be waiting on these handles, so let it close
+      // them once it's awake
+      const auto [first, last] = std::ranges::partition(
+        mWatches, [tag](const auto& it) { return it.mTag != tag; });
+      std::ranges::move(first, last, std::back_inserter(mRetired));
+      mWatches.erase(first, last);
+    }
+    mWake.SetEvent();
+  }
+
+ private:
+  struct Watch {
+    Tag mTag {};
+    // Either a folder...
+    wil::unique_hfind_change mFolder;
+    // ... or a registry key
+    wil::unique_hkey mKey;
+    wil::unique_event mKeyChanged;
+
+    [[nodiscard]] HANDLE GetWaitHandle() const {
+      return mFolder ? mFolder.get() : mKeyChanged.get();
+    }
+  };
+
+  std::mutex mMutex;
+  std::vector<Watch> mWatches;
+  std::vector<Watch> mRetired;
+  bool mStopping {false};
+  wil::unique_event mWake;
+  std::jthread mThread;
+
+  static bool ArmRegistryWatch(const Watch& watch) {
+    // Thread-agnostic, as this is called from both the caller's thread and
+    // the watch thread
+    return RegNotifyChangeKeyValue(
+             watch.mKey.get(),
+             TRUE,
+             REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET
+               | REG_NOTIFY_THREAD_AGNOSTIC,
+             watch.mKeyChanged.get(),
+             TRUE)
+      == ERROR_SUCCESS;
+  }
+
+  void Add(Watch&& watch) {
+    {
+      std::unique_lock lock(mMutex);
+      mWatches.push_back(std::move(watch));
+    }
+    mWake.SetEvent();
+  }
+
+  void WatchThread() {
+    std::vector<HANDLE> handles;
+    while (true) {
+      {
+        std::unique_lock lock(mMutex);
+        if (mStopping) {
+          return;
+        }
+        mRetired.clear();
+        handles.clear();
+        handles.push_back(mWake.get());
+        for (auto&& watch: mWatches) {
+          if (handles.size() == MAXIMUM_WAIT_OBJECTS) {
+            break;
+          }
+          handles.push_back(watch.GetWaitHandle());
+        }
+      }
+
+      const auto result = WaitForMultipleObjects(
+        static_cast<DWORD>(handles.size()), handles.data(), FALSE, INFINITE);
+      if (result < WAIT_OBJECT_0 || result >= WAIT_OBJECT_0 + handles.size()) {
+        return;
+      }
+      const auto signalled = handles.at(result - WAIT_OBJECT_0);
+      if (signalled == mWake.get()) {
+        continue;
+      }
+
+      std::unique_lock lock(mMutex);
+      // The watch may have been removed while we were waiting
+      const auto it = std::ranges::find(
+        mWatches, signalled, [](const auto& it) { return it.GetWaitHandle(); });
+      if (it == mWatches.end()) {
+        continue;
+      }
+      Notify(it->mTag);
+      if (it->mFolder) {
+        FindNextChangeNotification(it->mFolder.get());
+      } else {
+        ArmRegistryWatch(*it);
+      }
+    }
+  }
+};
+
+}// namespace
+
+std::unique_ptr<ChangeWatcher> ChangeWatcher::Create(
+  Callback callback,
+  std::chrono::milliseconds quietPeriod) {
+  return std::make_unique<Win32ChangeWatcher>(
+    std::move(callback), quietPeriod);
+}
@@ -0,0 +1,136 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <Windows.h>
+#include <wil/resource.h>
+
+#include <string_view>
+
+#include "DirectoryListing.hpp"
+
+namespace {
+std::error_code LastError() {
+  return {static_cast<int>(GetLastError()), std::system_category()};
+}
+
+wil::unique_hfile Open(const std::filesystem::path& path, DWORD access) {
+  return wil::unique_hfile {CreateFileW(
+    path.c_str(),
+    access,
+    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+    nullptr,
+    OPEN_EXISTING,
+    // Needed to open folders; don't follow links or junctions
+    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT,
+    nullptr)};
+}
+
+bool IsDirectory(DWORD attributes) {
+  return (attributes & FILE_ATTRIBUTE_DIRECTORY)
+    && !(attributes & FILE_ATTRIBUTE_REPARSE_POINT);
+}
+
+bool IsLink(DWORD attributes) {
+  return attributes & FILE_ATTRIBUTE_REPARSE_POINT;
+}
+}// namespace
+
+// Everything is in the listing, so `ListingDetail` makes no difference
+std::vector<DirectoryEntry> ListDirectory(
+  const std::filesystem::path& path,
+  std::error_code& ec,
+  ListingDetail) {
+  ec.clear();
+  const auto dir = Open(path, FILE_LIST_DIRECTORY | FILE_READ_ATTRIBUTES);
+  if (!dir) {
+    ec = LastError();
+    return {};
+  }
+  BY_HANDLE_FILE_INFORMATION dirInfo {};
+  if (!GetFileInformationByHandle(dir.get(), &dirInfo)) {
+    ec = LastError();
+    return {};
+  }
+
+  // Unlike `FindFirstFile()`, this includes the allocation size and file ID
+  // for every entry, so we don't need to open each file.
+  //
+  // It doesn't include the link count, so every file is treated as possibly
+  // hard-linked.
+  std::vector<DirectoryEntry> ret;
+  std::vector<std::byte> buffer(64 * 1024);
+  auto infoClass = FileIdBothDirectoryRestartInfo;
+  while (GetFileInformationByHandleEx(
+    dir.get(), infoClass, buffer.data(), static_cast<DWORD>(buffer.size()))) {
+    infoClass = FileIdBothDirectoryInfo;
+    for (auto offset = 0uz;;) {
+      const auto& info
+        = *reinterpret_cast<const FILE_ID_BOTH_DIR_INFO*>(&buffer.at(offset));
+      const std::wstring_view name {
+        info.FileName, info.FileNameLength / sizeof(wchar_t)};
+      if (name != L"." && name != L"..") {
+        DirectoryEntry entry {
+          .mPath = path / name,
+          .mIsDirectory = IsDirectory(info.FileAttributes),
+          .mIsLink = IsLink(info.FileAttributes),
+        };
+        if (!entry.mIsDirectory) {
+          entry.mAllocatedBytes
+            = static_cast<std::uint64_t>(info.AllocationSize.QuadPart);
+          if (!IsLink(info.FileAttributes)) {
+            entry.mSize = static_cast<std::uint64_t>(info.EndOfFile.QuadPart);
+          }
+          entry.mHardLinkID = FileID {
+            dirInfo.dwVolumeSerialNumber,
+            static_cast<std::uint64_t>(info.FileId.QuadPart),
+          };
+        }
+        ret.push_back(std::move(entry));
+      }
+      if (info.NextEntryOffset == 0) {
+        break;
+      }
+      offset += info.NextEntryOffset;
+    }
+  }
+  if (GetLastError() != ERROR_NO_MORE_FILES) {
+    ec = LastError();
+  }
+  return ret;
+}
+
+DirectoryEntry GetDirectoryEntry(
+  const std::filesystem::path& path,
+  std::error_code& ec) {
+  ec.clear();
+  DirectoryEntry ret {.mPath = path};
+  const auto handle = Open(path, FILE_READ_ATTRIBUTES);
+  BY_HANDLE_FILE_INFORMATION info {};
+  FILE_STANDARD_INFO standard {};
+  if (
+    !handle || !GetFileInformationByHandle(handle.get(), &info)
+    || !GetFileInformationByHandleEx(
+      handle.get(), FileStandardInfo, &standard, sizeof(standard))) {
+    ec = LastError();
+    return ret;
+  }
+
+  ret.mIsDirectory = IsDirectory(info.dwFileAttributes);
+  ret.mIsLink = IsLink(info.dwFileAttributes);
+  if (ret.mIsDirectory) {
+    return ret;
+  }
+  ret.mAllocatedBytes
+    = static_cast<std::uint64_t>(standard.AllocationSize.QuadPart);
+  if (!IsLink(info.dwFileAttributes)) {
+    ret.mSize = static_cast<std::uint64_t>(standard.EndOfFile.QuadPart);
+  }
+  if (info.nNumberOfLinks > 1) {
+    ret.mHardLinkID = FileID {
+      info.dwVolumeSerialNumber,
+      (static_cast<std::uint64_t>(info.nFileIndexHigh) << 32)
+        | info.nFileIndexLow,
+    };
+  }
+  return ret;
+}
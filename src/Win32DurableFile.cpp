@@ -0,0 +1,88 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <Windows.h>
+#include <wil/resource.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "DurableFile.hpp"
+
+namespace {
+std::error_code LastError() {
+  return {static_cast<int>(GetLastError()), std::system_category()};
+}
+}// namespace
+
+struct DurableFile::Impl {
+  wil::unique_hfile mFile;
+  std::filesystem::path mPath;
+};
+
+DurableFile::DurableFile(std::unique_ptr<Impl> impl)
+  : mImpl(std::move(impl)) {}
+DurableFile::~DurableFile() = default;
+DurableFile::DurableFile(DurableFile&&) noexcept = default;
+DurableFile& DurableFile::operator=(DurableFile&&) noexcept = default;
+
+DurableFile DurableFile::Create(const std::filesystem::path& path) {
+  auto impl = std::make_unique<Impl>();
+  impl->mPath = path;
+  // Write-through skips the lazy writer, so `FlushFileBuffers()` has less to
+  // wait for
+  impl->mFile.reset(CreateFileW(
+    path.c_str(),
+    FILE_APPEND_DATA,
+    FILE_SHARE_READ | FILE_SHARE_DELETE,
+    nullptr,
+    CREATE_ALWAYS,
+    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_WRITE_THROUGH,
+    nullptr));
+  if (!impl->mFile) {
+    throw std::filesystem::filesystem_error(
+      "Failed to create file", path, LastError());
+  }
+  return DurableFile {std::move(impl)};
+}
+
+void DurableFile::Append(const std::span<const std::byte> data) {
+  Write(data);
+  Flush();
+}
+
+void DurableFile::Write(std::span<const std::byte> data) {
+  while (!data.empty()) {
+    DWORD written {};
+    if (!WriteFile(
+          mImpl->mFile.get(),
+          data.data(),
+          static_cast<DWORD>(std::min<std::size_t>(data.size(), MAXDWORD)),
+          &written,
+          nullptr)) {
+      throw std::filesystem::filesystem_error(
+        "Failed to write file", mImpl->mPath, LastError());
+    }
+    data = data.subspan(written);
+  }
+}
+
+void DurableFile::Flush() {
+  if (!FlushFileBuffers(mImpl->mFile.get())) {
+    throw std::filesystem::filesystem_error(
+      "Failed to flush file", mImpl->mPath, LastError());
+  }
+}
+
+void DurableFile::Rename(
+  const std::filesystem::path& from,
+  const std::filesystem::path& to) {
+  // Write-through waits for the metadata change to reach the disk
+  if (!MoveFileExW(
+        from.c_str(),
+        to.c_str(),
+        MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+    throw std::filesystem::filesystem_error(
+      "Failed to rename file", from, to, LastError());
+  }
+}
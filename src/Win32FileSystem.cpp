@@ -0,0 +1,23 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <Windows.h>
+
+#include "FileSystem.hpp"
+
+// Not mapped to a portable `std::errc`, so compare the Win32 codes directly
+bool IsSharingViolation(const std::error_code& ec) {
+  if (ec.category() != std::system_category()) {
+    return false;
+  }
+  return ec.value() == ERROR_SHARING_VIOLATION
+    || ec.value() == ERROR_LOCK_VIOLATION;
+}
+
+std::error_code MakeSharingViolationError() {
+  return {ERROR_SHARING_VIOLATION, std::system_category()};
+}
+
+std::error_code MakeAccessDeniedError() {
+  return {ERROR_ACCESS_DENIED, std::system_category()};
+}
@@ -0,0 +1,113 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <Windows.h>
+#include <msi.h>
+#include <wil/win32_helpers.h>
+#include <winrt/base.h>
+#include <winrt/windows.applicationmodel.h>
+#include <winrt/windows.foundation.collections.h>
+#include <winrt/windows.management.deployment.h>
+
+#include <charconv>
+
+#include "InstallerInventory.hpp"
+#include "Instrumentation.hpp"
+
+#pragma comment(lib, "msi.lib")
+
+namespace {
+
+class Win32InstallerBackend final : public InstallerInventory::Backend {
+ public:
+  ~Win32InstallerBackend() override = default;
+
+  std::vector<InstallerInventory::MSIProduct> GetMSIProducts(
+    std::wstring_view upgradeCodeView) override {
+    using namespace Instrumentation;
+    const std::wstring upgradeCode {upgradeCodeView};
+    std::vector<InstallerInventory::MSIProduct> ret;
+
+    WCHAR productCode[wil::guid_string_buffer_length] = {0};
+    DWORD productIndex = 0;
+    while (MsiEnumRelatedProductsW(
+             upgradeCode.c_str(), 0, productIndex++, productCode)
+           == ERROR_SUCCESS) {
+      Increment(Counter::InstallerQueries);
+      for (auto&& context: {
+             MSIINSTALLCONTEXT_MACHINE,
+             MSIINSTALLCONTEXT_USERMANAGED,
+             MSIINSTALLCONTEXT_USERUNMANAGED,
+           }) {
+        WCHAR versionString[256] {};
+        DWORD versionStringLength = std::size(versionString);
+        Increment(Counter::InstallerQueries);
+        if (
+          MsiGetProductInfoExW(
+            productCode,
+            nullptr,
+            context,
+            INSTALLPROPERTY_VERSIONSTRING,
+            versionString,
+            &versionStringLength)
+          != ERROR_SUCCESS) {
+          continue;
+        }
+        WCHAR version[256] {};
+        DWORD versionLength = std::size(version);
+        MsiGetProductInfoExW(
+          productCode,
+          nullptr,
+          context,
+          INSTALLPROPERTY_VERSION,
+          version,
+          &versionLength);
+        const auto utf8Version = winrt::to_string(version);
+        uint32_t sortableVersion {};
+        std::from_chars(
+          utf8Version.data(),
+          utf8Version.data() + utf8Version.size(),
+          sortableVersion);
+        ret.push_back({
+          .mProductCode = productCode,
+          .mContext = static_cast<uint32_t>(context),
+          .mVersionString = versionString,
+          .mSortableVersion = sortableVersion,
+        });
+      }
+    }
+    return ret;
+  }
+
+  std::vector<InstallerInventory::MSIXPackage> GetMSIXPackages(
+    std::wstring_view name) override {
+    std::vector<InstallerInventory::MSIXPackage> ret;
+    // We don't know the publisher hash, so can't ask for the package family
+    // directly; filter as we go, and only copy what we need
+    const winrt::Windows::Management::Deployment::PackageManager pm;
+    for (auto&& package: pm.FindPackagesForUser(L"")) {
+      Instrumentation::Increment(Instrumentation::Counter::InstallerQueries);
+      const auto id = package.Id();
+      if (!std::wstring_view {id.Name()}.contains(name)) {
+        continue;
+      }
+      const auto version = id.Version();
+      ret.push_back({
+        .mFullName = std::wstring {id.FullName()},
+        .mMajor = version.Major,
+        .mMinor = version.Minor,
+        .mBuild = version.Build,
+        .mRevision = version.Revision,
+      });
+    }
+    return ret;
+  }
+};
+
+}// namespace
+
+InstallerInventory& InstallerInventory::Get() {
+  static InstallerInventory sInstance {
+    std::make_unique<Win32InstallerBackend>()};
+  return sInstance;
+}
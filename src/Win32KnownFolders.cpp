@@ -0,0 +1,52 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <Windows.h>
+#include <shlobj_core.h>
+#include <wil/resource.h>
+
+#include <memory>
+
+#include "Instrumentation.hpp"
+#include "KnownFolders.hpp"
+
+namespace {
+
+std::filesystem::path GetKnownFolderPath(const KNOWNFOLDERID& id) {
+  Instrumentation::Increment(Instrumentation::Counter::KnownFolderLookups);
+  wil::unique_hlocal_string path;
+  if (FAILED(SHGetKnownFolderPath(id, 0, nullptr, std::out_ptr(path)))) {
+    return {};
+  }
+  return std::filesystem::path {std::wstring_view {path.get()}};
+}
+
+std::filesystem::path GetTempPath() {
+  Instrumentation::Increment(Instrumentation::Counter::KnownFolderLookups);
+  // MSDN says to use GetTempPath2() instead, however that would increase
+  // the minimum Windows version to Windows 11 Build 22000
+  wchar_t buf[MAX_PATH + 1];
+  const auto wcharCount = GetTempPathW(std::size(buf), buf);
+  if (wcharCount == 0 || wcharCount > std::size(buf)) {
+    return {};
+  }
+  return std::filesystem::path {std::wstring_view {buf, wcharCount}};
+}
+
+KnownFolders::Roots ResolveRoots() {
+  const Instrumentation::ScopedTimer timer {"Discovery", "KnownFolders"};
+  return {
+    .mDocuments = GetKnownFolderPath(FOLDERID_Documents),
+    .mLocalAppData = GetKnownFolderPath(FOLDERID_LocalAppData),
+    .mProgramData = GetKnownFolderPath(FOLDERID_ProgramData),
+    .mSavedGames = GetKnownFolderPath(FOLDERID_SavedGames),
+    .mTemp = GetTempPath(),
+  };
+}
+
+}// namespace
+
+KnownFolders& KnownFolders::Get() {
+  static KnownFolders sInstance {&ResolveRoots};
+  return sInstance;
+}
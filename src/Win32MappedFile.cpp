@@ -0,0 +1,146 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <Windows.h>
+#include <wil/resource.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "MappedFile.hpp"
+
+namespace {
+std::error_code LastError() {
+  return {static_cast<int>(GetLastError()), std::system_category()};
+}
+}// namespace
+
+struct MappedFile::Impl {
+  wil::unique_hfile mFile;
+  // Null for empty files, which can't be mapped
+  wil::unique_handle mMapping;
+  std::uint64_t mSize {};
+};
+
+MappedFile::MappedFile(std::unique_ptr<Impl> impl) : mImpl(std::move(impl)) {}
+MappedFile::~MappedFile() = default;
+MappedFile::MappedFile(MappedFile&&) noexcept = default;
+MappedFile& MappedFile::operator=(MappedFile&&) noexcept = default;
+
+std::optional<MappedFile> MappedFile::Open(
+  const std::filesystem::path& path,
+  std::error_code& ec) {
+  auto impl = std::make_unique<Impl>();
+  impl->mFile.reset(CreateFileW(
+    path.c_str(),
+    GENERIC_READ,
+    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+    nullptr,
+    OPEN_EXISTING,
+    FILE_FLAG_SEQUENTIAL_SCAN,
+    nullptr));
+  if (!impl->mFile) {
+    ec = LastError();
+    return std::nullopt;
+  }
+  LARGE_INTEGER size {};
+  if (!GetFileSizeEx(impl->mFile.get(), &size)) {
+    ec = LastError();
+    return std::nullopt;
+  }
+  impl->mSize = static_cast<std::uint64_t>(size.QuadPart);
+  if (impl->mSize > 0) {
+    impl->mMapping.reset(CreateFileMappingW(
+      impl->mFile.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+    if (!impl->mMapping) {
+      ec = LastError();
+      return std::nullopt;
+    }
+  }
+  ec.clear();
+  return MappedFile {std::move(impl)};
+}
+
+std::uint64_t MappedFile::GetSize() const noexcept {
+  return mImpl->mSize;
+}
+
+MappedFile::View MappedFile::Map(
+  const std::uint64_t offset,
+  const std::size_t size,
+  std::error_code& ec) const {
+  static const auto granularity = [] {
+    SYSTEM_INFO info {};
+    GetSystemInfo(&info);
+    return static_cast<std::uint64_t>(info.dwAllocationGranularity);
+  }();
+  const auto alignedOffset = offset - (offset % granularity);
+  const auto padding = static_cast<std::size_t>(offset - alignedOffset);
+
+  View ret;
+  ret.mMappedSize = size + padding;
+  const auto base = MapViewOfFile(
+    mImpl->mMapping.get(),
+    FILE_MAP_READ,
+    static_cast<DWORD>(alignedOffset >> 32),
+    static_cast<DWORD>(alignedOffset & 0xffffffff),
+    ret.mMappedSize);
+  if (!base) {
+    ec = LastError();
+    return {};
+  }
+  ret.mBase = base;
+  ret.mData = {static_cast<const std::byte*>(base) + padding, size};
+  ec.clear();
+  return ret;
+}
+
+std::size_t MappedFile::Read(
+  std::uint64_t offset,
+  std::span<std::byte> buffer,
+  std::error_code& ec) const {
+  std::size_t ret = 0;
+  while (ret < buffer.size()) {
+    const auto position = offset + ret;
+    OVERLAPPED overlapped {};
+    overlapped.Offset = static_cast<DWORD>(position & 0xffffffff);
+    overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+    DWORD count {};
+    if (!ReadFile(
+          mImpl->mFile.get(),
+          buffer.data() + ret,
+          static_cast<DWORD>(
+            std::min<std::size_t>(buffer.size() - ret, MAXDWORD)),
+          &count,
+          &overlapped)) {
+      if (GetLastError() == ERROR_HANDLE_EOF) {
+        break;
+      }
+      ec = LastError();
+      return ret;
+    }
+    if (count == 0) {
+      break;
+    }
+    ret += count;
+  }
+  ec.clear();
+  return ret;
+}
+
+void MappedFile::View::Prefetch() const noexcept {
+  if (!mBase) {
+    return;
+  }
+  WIN32_MEMORY_RANGE_ENTRY range {mBase, mMappedSize};
+  PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+void MappedFile::View::Reset() noexcept {
+  if (mBase) {
+    UnmapViewOfFile(mBase);
+  }
+  mBase = nullptr;
+  mMappedSize = 0;
+  mData = {};
+}
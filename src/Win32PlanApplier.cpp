@@ -0,0 +1,159 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <Windows.h>
+#include <msi.h>
+#include <winrt/windows.applicationmodel.h>
+#include <winrt/windows.foundation.h>
+#include <winrt/windows.management.deployment.h>
+
+#include <stdexcept>
+#include <stop_token>
+#include <system_error>
+#include <utility>
+
+#include "PlanApplier.hpp"
+#include "ThreadPool.hpp"
+
+namespace {
+using Kind = PlannedOperation::Kind;
+
+// While this exists, Windows Installer operations are cancelled if
+// `stopToken` is stopped.
+//
+// The handler is process-wide; this is fine as the `WindowsInstaller`
+// execution resource only allows one MSI action at a time.
+class MSICancellationScope {
+ public:
+  explicit MSICancellationScope(std::stop_token stopToken)
+    : mStopToken(std::move(stopToken)) {
+    // Progress messages are frequent, and can be cancelled
+    mPreviousHandler = MsiSetExternalUIW(
+      &OnMessage,
+      INSTALLLOGMODE_PROGRESS | INSTALLLOGMODE_ACTIONSTART,
+      &mStopToken);
+  }
+
+  ~MSICancellationScope() {
+    MsiSetExternalUIW(mPreviousHandler, 0, nullptr);
+  }
+
+  MSICancellationScope(const MSICancellationScope&) = delete;
+  MSICancellationScope& operator=(const MSICancellationScope&) = delete;
+
+ private:
+  std::stop_token mStopToken;
+  INSTALLUI_HANDLERW mPreviousHandler {nullptr};
+
+  static INT CALLBACK OnMessage(LPVOID context, UINT, LPCWSTR) {
+    if (static_cast<const std::stop_token*>(context)->stop_requested()) {
+      // Windows Installer rolls back, then returns ERROR_INSTALL_USEREXIT
+      return IDCANCEL;
+    }
+    // Let Windows Installer handle it as usual
+    return 0;
+  }
+};
+
+[[noreturn]] void ThrowWin32Error(
+  const DWORD error,
+  const PlannedOperation& operation) {
+  throw std::system_error(
+    static_cast<int>(error), std::system_category(), Describe(operation));
+}
+
+Task<> ApplyMSIOperation(
+  const PlannedOperation& operation,
+  const std::stop_token stopToken) {
+  co_await ThreadPool::GetShared().Schedule();
+  const MSICancellationScope cancellation {stopToken};
+  const auto productCode = operation.mTarget.c_str();
+  const auto result = (operation.mKind == Kind::UninstallMSIProduct)
+    ? MsiConfigureProductW(
+        productCode, INSTALLLEVEL_DEFAULT, INSTALLSTATE_ABSENT)
+    : MsiReinstallProductW(
+        productCode, REINSTALLMODE_FILEREPLACE | REINSTALLMODE_MACHINEDATA);
+  switch (result) {
+    case ERROR_SUCCESS:
+    case ERROR_SUCCESS_REBOOT_INITIATED:
+    case ERROR_SUCCESS_REBOOT_REQUIRED:
+      co_return;
+    case ERROR_UNKNOWN_PRODUCT:
+      // Already uninstalled
+      if (operation.mKind == Kind::UninstallMSIProduct) {
+        co_return;
+      }
+      break;
+    case ERROR_INSTALL_USEREXIT:
+      // Reported by the caller
+      if (stopToken.stop_requested()) {
+        co_return;
+      }
+      break;
+  }
+  ThrowWin32Error(result, operation);
+}
+
+// Deployment operations are natively asynchronous, so no threads are
+// blocked while they run
+Task<> RemoveMSIXPackage(
+  const PlannedOperation& operation,
+  const std::stop_token stopToken) {
+  const winrt::Windows::Management::Deployment::PackageManager pm;
+  const auto removal = pm.RemovePackageAsync(operation.mTarget);
+  // Cancelled operations complete early, and throw when awaited
+  const std::stop_callback cancel {stopToken, [&removal] { removal.Cancel(); }};
+  try {
+    (void)co_await removal;
+  } catch (const winrt::hresult_canceled&) {
+    // Reported by the caller
+  }
+}
+
+bool HasMSIXPackage(const PlannedOperation& operation) {
+  const winrt::Windows::Management::Deployment::PackageManager pm;
+  // Empty SID: the current user
+  return pm.FindPackageForUser({}, operation.mTarget) != nullptr;
+}
+}// namespace
+
+Task<> PlanApplierDetail::ApplySystemOperation(
+  const PlannedOperation& operation,
+  const std::stop_token stopToken) {
+  switch (operation.mKind) {
+    case Kind::RemovePath:
+    case Kind::DeleteRegistryValue:
+    case Kind::SetRegistryDWORD:
+    case Kind::BackupPaths:
+      // Portable; see `ApplyOperation()`
+      break;
+    case Kind::UninstallMSIProduct:
+    case Kind::RepairMSIProduct:
+      co_await ApplyMSIOperation(operation, stopToken);
+      co_return;
+    case Kind::RemoveMSIXPackage:
+      co_await RemoveMSIXPackage(operation, stopToken);
+      co_return;
+  }
+  throw std::logic_error("Unhandled operation kind");
+}
+
+bool PlanApplierDetail::IsSystemOperationApplied(
+  const PlannedOperation& operation) {
+  switch (operation.mKind) {
+    case Kind::RemovePath:
+    case Kind::DeleteRegistryValue:
+    case Kind::SetRegistryDWORD:
+    case Kind::BackupPaths:
+      break;
+    case Kind::UninstallMSIProduct:
+      return MsiQueryProductStateW(operation.mTarget.c_str())
+        != INSTALLSTATE_DEFAULT;
+    case Kind::RepairMSIProduct:
+      return MsiQueryProductStateW(operation.mTarget.c_str())
+        == INSTALLSTATE_DEFAULT;
+    case Kind::RemoveMSIXPackage:
+      return !HasMSIXPackage(operation);
+  }
+  throw std::logic_error("Unhandled operation kind");
+}
@@ -0,0 +1,198 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <Windows.h>
+#include <ktmw32.h>
+#include <wil/resource.h>
+#include <winrt/base.h>
+
+#include <format>
+#include <map>
+#include <memory>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+#include "Registry.hpp"
+
+#pragma comment(lib, "ktmw32.lib")
+
+namespace {
+
+HKEY GetRoot(const RegistryHive hive) {
+  return hive == RegistryHive::LocalMachine ? HKEY_LOCAL_MACHINE
+                                            : HKEY_CURRENT_USER;
+}
+
+// For `RegOpenKeyEx()` and friends
+REGSAM GetViewAccess(const RegistryView view) {
+  switch (view) {
+    case RegistryView::Default:
+      return 0;
+    case RegistryView::Bits64:
+      return KEY_WOW64_64KEY;
+    case RegistryView::Bits32:
+      return KEY_WOW64_32KEY;
+  }
+  std::unreachable();
+}
+
+// For `RegGetValue()`, which uses different flags
+DWORD GetViewFlags(const RegistryView view) {
+  switch (view) {
+    case RegistryView::Default:
+      return 0;
+    case RegistryView::Bits64:
+      return RRF_SUBKEY_WOW6464KEY;
+    case RegistryView::Bits32:
+      return RRF_SUBKEY_WOW6432KEY;
+  }
+  std::unreachable();
+}
+
+[[noreturn]] void ThrowWin32Error(
+  const DWORD error,
+  const std::string_view action,
+  const RegistryValueLocation& value) {
+  throw std::system_error(
+    static_cast<int>(error),
+    std::system_category(),
+    std::format(
+      "Failed to {} {}\\{}\\{}",
+      action,
+      value.mHive == RegistryHive::LocalMachine ? "HKLM" : "HKCU",
+      winrt::to_string(value.mSubKey),
+      winrt::to_string(value.mValueName)));
+}
+
+class Win32Registry final : public Registry {
+ public:
+  ~Win32Registry() override = default;
+
+  bool HasValue(const RegistryValueLocation& value) const override {
+    return RegGetValueW(
+             GetRoot(value.mHive),
+             value.mSubKey.c_str(),
+             value.mValueName.c_str(),
+             RRF_RT_ANY | GetViewFlags(value.mView),
+             nullptr,
+             nullptr,
+             nullptr)
+      == ERROR_SUCCESS;
+  }
+
+  std::optional<std::uint32_t> GetDWORD(
+    const RegistryValueLocation& value) const override {
+    DWORD data {};
+    DWORD size = sizeof(data);
+    const auto result = RegGetValueW(
+      GetRoot(value.mHive),
+      value.mSubKey.c_str(),
+      value.mValueName.c_str(),
+      RRF_RT_REG_DWORD | GetViewFlags(value.mView),
+      nullptr,
+      &data,
+      &size);
+    if (result != ERROR_SUCCESS) {
+      return std::nullopt;
+    }
+    return data;
+  }
+
+  // Closing the transaction without committing it rolls everything back, so
+  // throwing part-way through leaves the registry as it was
+  void Apply(const RegistryBatch& batch) override {
+    if (batch.IsEmpty()) {
+      return;
+    }
+    const wil::unique_handle transaction {CreateTransaction(
+      nullptr, nullptr, TRANSACTION_DO_NOT_PROMOTE, 0, 0, 0, nullptr)};
+    if (!transaction) {
+      throw std::system_error(
+        static_cast<int>(GetLastError()),
+        std::system_category(),
+        "Failed to create a registry transaction");
+    }
+
+    // Thousands of values usually share a handful of keys; null if the key
+    // doesn't exist
+    using KeyID = std::tuple<RegistryHive, RegistryView, std::wstring>;
+    std::map<KeyID, wil::unique_hkey> keys;
+    for (auto&& edit: batch.GetEdits()) {
+      const auto& value = edit.mValue;
+      auto [it, inserted]
+        = keys.try_emplace({value.mHive, value.mView, value.mSubKey});
+      if (inserted) {
+        it->second = OpenKey(value, transaction.get());
+      }
+      const auto key = it->second.get();
+
+      switch (edit.mKind) {
+        case RegistryBatch::Edit::Kind::DeleteValue: {
+          if (!key) {
+            break;
+          }
+          const auto result = RegDeleteValueW(key, value.mValueName.c_str());
+          if (result != ERROR_SUCCESS && result != ERROR_FILE_NOT_FOUND) {
+            ThrowWin32Error(result, "delete", value);
+          }
+          break;
+        }
+        case RegistryBatch::Edit::Kind::SetDWORD: {
+          if (!key) {
+            ThrowWin32Error(ERROR_FILE_NOT_FOUND, "set", value);
+          }
+          const DWORD data = edit.mData;
+          const auto result = RegSetValueExW(
+            key,
+            value.mValueName.c_str(),
+            0,
+            REG_DWORD,
+            reinterpret_cast<const BYTE*>(&data),
+            sizeof(data));
+          if (result != ERROR_SUCCESS) {
+            ThrowWin32Error(result, "set", value);
+          }
+          break;
+        }
+      }
+    }
+
+    keys.clear();
+    if (!CommitTransaction(transaction.get())) {
+      throw std::system_error(
+        static_cast<int>(GetLastError()),
+        std::system_category(),
+        "Failed to commit registry changes");
+    }
+  }
+
+ private:
+  static wil::unique_hkey OpenKey(
+    const RegistryValueLocation& value,
+    HANDLE transaction) {
+    wil::unique_hkey ret;
+    const auto result = RegOpenKeyTransactedW(
+      GetRoot(value.mHive),
+      value.mSubKey.c_str(),
+      0,
+      KEY_QUERY_VALUE | KEY_SET_VALUE | GetViewAccess(value.mView),
+      std::out_ptr(ret),
+      transaction,
+      nullptr);
+    if (result == ERROR_FILE_NOT_FOUND) {
+      return {};
+    }
+    if (result != ERROR_SUCCESS) {
+      ThrowWin32Error(result, "open the key for", value);
+    }
+    return ret;
+  }
+};
+
+}// namespace
+
+Registry& Registry::Get() {
+  static Win32Registry sInstance;
+  return sInstance;
+}
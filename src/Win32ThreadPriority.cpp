@@ -0,0 +1,11 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <Windows.h>
+
+#include "ThreadPriority.hpp"
+
+void LowerCurrentThreadPriority() {
+  // Also lowers I/O and memory priority
+  SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+}
@@ -0,0 +1,309 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+// Runs fake actions through `ActionScheduler`, checking dependency order,
+// exclusive resources, timeouts and cycle detection, then compares running
+// them one at a time with running them concurrently.
+//
+// The MSI artifacts are Windows-only, so their titles, `RunsAfter` and
+// `ExclusiveResources` are mirrored here; keep them in sync with
+// `artifacts/MultipleMSIInstallations.hpp`, `artifacts/MSIInstallation.hpp`
+// and `artifacts/HKLMLayer.hpp`.
+
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <source_location>
+#include <stdexcept>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "ActionScheduler.hpp"
+#include "Task.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+using Outcome = ActionScheduler::Outcome;
+
+constexpr std::chrono::milliseconds ActionDuration {50};
+constexpr std::size_t IndependentCount = 8;
+
+bool gFailed = false;
+
+void Check(
+  const bool condition,
+  const std::string_view what,
+  const std::source_location& caller = std::source_location::current()) {
+  if (condition) {
+    return;
+  }
+  std::cerr << std::format(
+    "{}:{}: {}\n", caller.file_name(), caller.line(), what);
+  gFailed = true;
+}
+
+// Resumes the coroutine on a new thread after `mDuration`, so that fake
+// actions don't depend on how many threads the shared pool has
+struct Sleep {
+  std::chrono::milliseconds mDuration;
+
+  bool await_ready() noexcept {
+    return false;
+  }
+  void await_suspend(std::coroutine_handle<> handle) {
+    std::thread([handle, duration = mDuration] {
+      std::this_thread::sleep_for(duration);
+      handle.resume();
+    }).detach();
+  }
+  void await_resume() noexcept {}
+};
+
+struct Span {
+  Clock::time_point mStart;
+  Clock::time_point mEnd;
+};
+
+// When each action actually ran, rather than when the scheduler reported it
+class Recorder {
+ public:
+  explicit Recorder(const std::size_t count) : mSpans(count) {}
+
+  void Start(const std::size_t index, const bool isMSI) {
+    std::unique_lock lock(mMutex);
+    mSpans.at(index).mStart = Clock::now();
+    if (isMSI) {
+      mMaxConcurrentMSI = std::max(mMaxConcurrentMSI, ++mConcurrentMSI);
+    }
+  }
+
+  void End(const std::size_t index, const bool isMSI) {
+    std::unique_lock lock(mMutex);
+    mSpans.at(index).mEnd = Clock::now();
+    if (isMSI) {
+      --mConcurrentMSI;
+    }
+  }
+
+  Span Get(const std::size_t index) {
+    std::unique_lock lock(mMutex);
+    return mSpans.at(index);
+  }
+
+  std::size_t GetMaxConcurrentMSI() {
+    std::unique_lock lock(mMutex);
+    return mMaxConcurrentMSI;
+  }
+
+ private:
+  std::mutex mMutex;
+  std::vector<Span> mSpans;
+  std::size_t mConcurrentMSI {};
+  std::size_t mMaxConcurrentMSI {};
+};
+
+// Ignores the stop token, like an installer that can't be interrupted
+Task<> FakeAction(
+  Recorder& recorder,
+  const std::size_t index,
+  const std::chrono::milliseconds duration,
+  const bool isMSI) {
+  recorder.Start(index, isMSI);
+  co_await Sleep {duration};
+  recorder.End(index, isMSI);
+}
+
+ActionScheduler::Action MakeAction(
+  Recorder& recorder,
+  const std::string_view name,
+  const std::size_t index,
+  std::vector<std::size_t> dependencies = {},
+  const bool isMSI = false,
+  const std::chrono::milliseconds duration = ActionDuration) {
+  constexpr ExecutionResource MSIResources[] {
+    ExecutionResource::WindowsInstaller};
+  return {
+    .mName = name,
+    .mRun =
+      [&recorder, index, duration, isMSI](std::stop_token) {
+        return FakeAction(recorder, index, duration, isMSI);
+      },
+    .mDependencies = std::move(dependencies),
+    .mResources = isMSI ? ActionScheduler::MakeResourceSet(MSIResources)
+                        : ActionScheduler::ResourceSet {},
+  };
+}
+
+enum Index : std::size_t {
+  MultipleMSIInstallations,
+  MSIInstallation,
+  HKLMLayer,
+  FirstIndependent,
+};
+
+// The MSI artifacts, followed by actions with no dependencies or resources,
+// like the filesystem artifacts
+std::vector<ActionScheduler::Action> MakeActions(Recorder& recorder) {
+  std::vector<ActionScheduler::Action> ret;
+  ret.push_back(MakeAction(
+    recorder,
+    "Duplicate MSI installations",
+    MultipleMSIInstallations,
+    {},
+    true));
+  ret.push_back(MakeAction(
+    recorder,
+    "MSI installation",
+    MSIInstallation,
+    {MultipleMSIInstallations},
+    true));
+  ret.push_back(MakeAction(
+    recorder, "HKLM OpenXR API layers", HKLMLayer, {MSIInstallation}));
+  for (std::size_t i = 0; i < IndependentCount; ++i) {
+    ret.push_back(MakeAction(recorder, "Independent", FirstIndependent + i));
+  }
+  return ret;
+}
+
+bool AllSucceeded(const std::vector<ActionScheduler::Result>& results) {
+  return std::ranges::all_of(results, [](const auto& it) {
+    return it.mOutcome == Outcome::Succeeded;
+  });
+}
+
+std::chrono::microseconds TimeRun(ActionScheduler& scheduler) {
+  const auto start = Clock::now();
+  Check(AllSucceeded(scheduler.Run()), "Action did not succeed");
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    Clock::now() - start);
+}
+
+std::chrono::microseconds TestOrderingAndConcurrency() {
+  Recorder recorder {FirstIndependent + IndependentCount};
+  ActionScheduler scheduler {MakeActions(recorder)};
+  const auto elapsed = TimeRun(scheduler);
+
+  Check(
+    recorder.Get(MultipleMSIInstallations).mEnd
+      <= recorder.Get(MSIInstallation).mStart,
+    "MSI repair started before duplicate MSIs were removed");
+  Check(
+    recorder.Get(MSIInstallation).mEnd <= recorder.Get(HKLMLayer).mStart,
+    "HKLM layers repaired before the MSI repair finished");
+  Check(recorder.GetMaxConcurrentMSI() == 1, "MSI actions ran concurrently");
+
+  // Every independent action is ready at once, so they should all overlap
+  // the first
+  const auto first = recorder.Get(FirstIndependent);
+  std::size_t overlapping = 0;
+  for (std::size_t i = FirstIndependent + 1;
+       i < FirstIndependent + IndependentCount;
+       ++i) {
+    const auto it = recorder.Get(i);
+    if (it.mStart < first.mEnd && first.mStart < it.mEnd) {
+      ++overlapping;
+    }
+  }
+  Check(
+    overlapping == IndependentCount - 1,
+    std::format(
+      "Only {} of {} independent actions overlapped",
+      overlapping,
+      IndependentCount - 1));
+  return elapsed;
+}
+
+// The same actions, each depending on the one before
+std::chrono::microseconds TimeSerial() {
+  Recorder recorder {FirstIndependent + IndependentCount};
+  auto actions = MakeActions(recorder);
+  for (std::size_t i = 1; i < actions.size(); ++i) {
+    actions.at(i).mDependencies = {i - 1};
+  }
+  ActionScheduler scheduler {std::move(actions)};
+  return TimeRun(scheduler);
+}
+
+// A timed-out installer may still be running, so the next one must wait
+void TestTimedOutActionKeepsResources() {
+  constexpr std::chrono::milliseconds Timeout {20};
+  Recorder recorder {3};
+  auto slow
+    = MakeAction(recorder, "Slow MSI", 0, {}, true, ActionDuration * 4);
+  slow.mTimeout = Timeout;
+  std::vector<ActionScheduler::Action> actions;
+  actions.push_back(std::move(slow));
+  actions.push_back(MakeAction(recorder, "Next MSI", 1, {}, true));
+  actions.push_back(MakeAction(recorder, "Dependent", 2, {0}));
+
+  ActionScheduler scheduler {std::move(actions)};
+  const auto results = scheduler.Run();
+  Check(
+    results.at(0).mOutcome == Outcome::TimedOut,
+    "Slow action was not reported as timed out");
+  Check(
+    results.at(1).mOutcome == Outcome::Succeeded
+      && results.at(2).mOutcome == Outcome::Succeeded,
+    "Action after timeout did not succeed");
+  Check(
+    recorder.Get(0).mEnd <= recorder.Get(1).mStart,
+    "Next MSI action started while a timed-out one was still running");
+  Check(
+    recorder.Get(0).mEnd <= recorder.Get(2).mStart,
+    "Dependent started while a timed-out action was still running");
+  Check(recorder.GetMaxConcurrentMSI() == 1, "MSI actions ran concurrently");
+}
+
+bool Rejects(std::vector<std::vector<std::size_t>> dependencies) {
+  Recorder recorder {dependencies.size()};
+  std::vector<ActionScheduler::Action> actions;
+  for (std::size_t i = 0; i < dependencies.size(); ++i) {
+    actions.push_back(
+      MakeAction(recorder, "Action", i, std::move(dependencies.at(i))));
+  }
+  try {
+    ActionScheduler scheduler {std::move(actions)};
+  } catch (const std::invalid_argument&) {
+    return true;
+  }
+  return false;
+}
+
+void TestInvalidDependencies() {
+  Check(Rejects({{0}}), "Self-dependency accepted");
+  Check(Rejects({{1}, {0}}), "Two-action cycle accepted");
+  Check(Rejects({{}, {3}, {1}, {2}}), "Three-action cycle accepted");
+  Check(Rejects({{}, {2}}), "Out of range dependency accepted");
+  Check(!Rejects({{}, {0}, {0, 1}}), "Valid dependencies rejected");
+}
+}// namespace
+
+int main() {
+  TestInvalidDependencies();
+  TestTimedOutActionKeepsResources();
+  const auto parallel = TestOrderingAndConcurrency();
+  const auto serial = TimeSerial();
+
+  // The MSI chain is three actions long, so there's plenty of room
+  Check(
+    parallel * 2 < serial,
+    std::format(
+      "Concurrent run took {}us, serial took {}us",
+      parallel.count(),
+      serial.count()));
+  std::cout << std::format(
+    "{} actions of {}ms: serial {}us, concurrent {}us\n",
+    FirstIndependent + IndependentCount,
+    ActionDuration.count(),
+    serial.count(),
+    parallel.count());
+  return gFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
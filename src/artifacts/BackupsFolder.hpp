@@ -6,17 +6,21 @@
 
 #include "Artifact.hpp"
 #include "FilesystemArtifact.hpp"
+#include "KnownFolders.hpp"
+#include "Versions.hpp"
 
 class BackupsFolder final : public FilesystemArtifact {
  public:
-  BackupsFolder();
-  ~BackupsFolder() override = default;
-  [[nodiscard]] std::string_view GetTitle() const override;
-  void DrawCardContent() const override;
-  [[nodiscard]] Version GetEarliestVersion() const override;
-  [[nodiscard]] std::optional<Version> GetRemovedVersion() const override;
-  Kind GetKind() const override;
+  static constexpr KnownFolders::Location Location {
+    KnownFolder::LocalAppData, L"OpenKneeboard Backups"};
+  static constexpr Metadata StaticMetadata {
+    .mTitle = "Settings Backups",
+    .mKind = Kind::UserSettings,
+    .mEarliestVersion = Versions::v1_10,
+    .mRemovedVersion = std::nullopt,
+  };
 
- private:
-  std::filesystem::path mPath;
+  explicit BackupsFolder(KnownFolders& folders = KnownFolders::Get());
+  ~BackupsFolder() override = default;
+  [[nodiscard]] const Metadata& GetMetadata() const override;
 };
\ No newline at end of file
@@ -2,37 +2,55 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "ActionScheduler.hpp"
 #include "Artifact.hpp"
+#include "ChangeSource.hpp"
+#include "InstallerInventory.hpp"
+#include "Lazy.hpp"
 
 class BasicMSIArtifact : public virtual Artifact {
  public:
-  BasicMSIArtifact();
-  ~BasicMSIArtifact() override = default;
+  // Updated by Windows Installer for per-machine and per-user products
+  static constexpr std::array ChangeSources {
+    ChangeSource::RegistryKey(
+      RegistryHive::LocalMachine,
+      L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall"),
+    ChangeSource::RegistryKey(
+      RegistryHive::CurrentUser, L"Software\\Microsoft\\Installer\\Products"),
+  };
+  static constexpr std::array ExclusiveResources {
+    ExecutionResource::WindowsInstaller,
+  };
+  // Uninstallers can be slow, especially with custom actions
+  static constexpr std::chrono::milliseconds ActionTimeout {
+    std::chrono::minutes {15}};
 
-  [[nodiscard]] Kind GetKind() const override;
-  [[nodiscard]] Version GetEarliestVersion() const override;
-  [[nodiscard]] std::optional<Version> GetRemovedVersion() const override;
+  explicit BasicMSIArtifact(
+    InstallerInventory& inventory = InstallerInventory::Get());
+  ~BasicMSIArtifact() override = default;
 
  protected:
-  const auto& GetInstallations() const {
-    return mInstallations;
+  // Sorted by version, oldest first
+  const std::vector<InstallerInventory::MSIProduct>& GetInstallations() const {
+    return *mInstallations;
   }
 
- private:
-  struct Installation {
-    std::wstring mProductCode;
-    uint32_t mSortableVersion {};
-    uint32_t mContext {};
-    std::string mDescription;
+  // Indices match `GetInstallations()`
+  const std::vector<std::string>& GetDescriptions() const {
+    return *mDescriptions;
+  }
 
-    constexpr auto operator<=>(const Installation& other) const noexcept {
-      return mSortableVersion <=> other.mSortableVersion;
-    }
+ private:
+  // Shared with other MSI artifacts
+  std::shared_ptr<const std::vector<InstallerInventory::MSIProduct>>
+    mInstallations;
+  Lazy<std::vector<std::string>> mDescriptions;
 
-    bool operator==(const Installation& other) const noexcept = default;
-  };
-  std::vector<Installation> mInstallations;
-};
\ No newline at end of file
+  std::vector<std::string> CreateDescriptions() const;
+};
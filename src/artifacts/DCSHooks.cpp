@@ -3,37 +3,17 @@
 
 #include "DCSHooks.hpp"
 
-#include <ShlObj_core.h>
-#include <wil/resource.h>
-
-#include <FredEmmott/GUI.hpp>
 #include <filesystem>
-#include <memory>
-
-DCSHooks::DCSHooks() {
-  wil::unique_hlocal_string savedGamesStr;
-  if (FAILED(SHGetKnownFolderPath(
-        FOLDERID_SavedGames, 0, nullptr, std::out_ptr(savedGamesStr)))) {
-    return;
-  }
-  const auto savedGames = std::filesystem::path {savedGamesStr.get()};
-  savedGamesStr.reset();
 
-  for (auto&& game: std::filesystem::directory_iterator {savedGames}) {
-    const auto hooks = game.path() / L"Scripts" / L"Hooks";
-    try {
-      if (!std::filesystem::exists(hooks)) {
-        continue;
-      }
-      for (auto&& item: std::filesystem::directory_iterator {hooks}) {
-        if (item.path().filename().wstring().starts_with(L"OpenKneeboard")) {
-          mPaths.emplace_back(item.path());
-        }
-      }
+#include "DCSHooksScanner.hpp"
+#include "ParallelDelete.hpp"
 
-    } catch (const std::filesystem::filesystem_error&) {
-    }
+DCSHooks::DCSHooks(KnownFolders& folders) {
+  const auto savedGames = folders.GetRoot(KnownFolder::SavedGames);
+  if (savedGames.empty()) {
+    return;
   }
+  mPaths = DCSHooksScanner {}.Scan(savedGames).mHooks;
 }
 
 DCSHooks::~DCSHooks() {}
@@ -42,39 +22,41 @@ bool DCSHooks::IsPresent() const {
   return !mPaths.empty();
 }
 
-void DCSHooks::Remove() {
+// Hooks are small, so measuring them is quick
+std::vector<PlannedOperation> DCSHooks::PlanRemoval() const {
+  std::vector<PlannedOperation> ret;
+  ret.reserve(mPaths.size());
   for (auto&& path: mPaths) {
-    try {
-      std::filesystem::remove_all(path);
-    } catch (const std::filesystem::filesystem_error&) {
-    }
+    ret.push_back(
+      PlannedOperation::RemovePath(path, ParallelDelete::Measure(path)));
   }
+  return ret;
 }
 
-std::string_view DCSHooks::GetTitle() const {
-  return "DCS hooks";
+std::vector<std::filesystem::path> DCSHooks::GetDiskUsageRoots() const {
+  return mPaths;
 }
 
-void DCSHooks::DrawCardContent() const {
-  using namespace FredEmmott::GUI;
-  using namespace FredEmmott::GUI::Immediate;
-  TextBlock(
-    "DCS has a feature called 'Hooks', which allows you to run custom "
-    "scripts when certain events occur. These hooks must be installed inside "
-    "each DCS Saved Games folder, so are not part of the "
-    "installer/uninstaller.");
-  TextBlock(
-    "These are harmless if OpenKneeboard is not installed or not running, but "
-    "they can be removed to clean up. OpenKneeboard will automatically "
-    "reinstall them if DCS is configured correctly within OpenKneeboard.");
-  Label("Found:");
-
-  const auto itemsLayout = BeginVStackPanel().Scoped().Styled(Style().Gap(4));
+Artifact::Details DCSHooks::GetDetails() const {
+  Details ret {
+    .mExplanation = {
+      "DCS has a feature called 'Hooks', which allows you to run custom "
+      "scripts when certain events occur. These hooks must be installed "
+      "inside each DCS Saved Games folder, so are not part of the "
+      "installer/uninstaller.",
+      "These are harmless if OpenKneeboard is not installed or not running, "
+      "but they can be removed to clean up. OpenKneeboard will automatically "
+      "reinstall them if DCS is configured correctly within OpenKneeboard.",
+    },
+    .mSummary = "Found:",
+  };
+  ret.mItems.reserve(mPaths.size());
   for (auto&& path: mPaths) {
-    Label("• {}", path.string());
+    ret.mItems.push_back(path.string());
   }
+  return ret;
 }
 
-Artifact::Kind DCSHooks::GetKind() const {
-  return Kind::Software;
-}
\ No newline at end of file
+const Artifact::Metadata& DCSHooks::GetMetadata() const {
+  return StaticMetadata;
+}
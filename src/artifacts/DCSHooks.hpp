@@ -2,31 +2,35 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <array>
 #include <vector>
 
 #include "Artifact.hpp"
+#include "ChangeSource.hpp"
+#include "KnownFolders.hpp"
 #include "Versions.hpp"
 
-namespace std::filesystem {
-class path;
-}
 class DCSHooks final : public Artifact {
  public:
-  DCSHooks();
-  ~DCSHooks() final;
-  Version GetEarliestVersion() const override {
-    return Versions::v0_1;
-  }
-
-  std::optional<Version> GetRemovedVersion() const override {
-    return std::nullopt;
-  }
+  static constexpr Metadata StaticMetadata {
+    .mTitle = "DCS hooks",
+    .mKind = Kind::Software,
+    .mEarliestVersion = Versions::v0_1,
+    .mRemovedVersion = std::nullopt,
+  };
+  // Hooks can be in any game folder
+  static constexpr std::array ChangeSources {
+    ChangeSource::Folder(KnownFolder::SavedGames),
+  };
 
+  explicit DCSHooks(KnownFolders& folders = KnownFolders::Get());
+  ~DCSHooks() final;
   [[nodiscard]] bool IsPresent() const override;
-  void Remove() override;
-  [[nodiscard]] std::string_view GetTitle() const override;
-  void DrawCardContent() const override;
-  [[nodiscard]] Kind GetKind() const override;
+  [[nodiscard]] std::vector<PlannedOperation> PlanRemoval() const override;
+  [[nodiscard]] std::vector<std::filesystem::path> GetDiskUsageRoots()
+    const override;
+  [[nodiscard]] const Metadata& GetMetadata() const override;
+  [[nodiscard]] Details GetDetails() const override;
 
  private:
   std::vector<std::filesystem::path> mPaths;
@@ -3,20 +3,32 @@
 
 #include "FilesystemArtifact.hpp"
 
+#include <format>
+
+#include "FileSystem.hpp"
+
 bool FilesystemArtifact::IsPresent() const {
   if (mPath.empty()) {
     return false;
   }
-  try {
-    return std::filesystem::exists(mPath);
-  } catch (const std::filesystem::filesystem_error&) {
-    return false;
-  }
+  std::error_code ec;
+  return RetryIfInUse(
+    [this](auto& error) { return FileSystem::Get().Exists(mPath, error); },
+    ec);
 }
 
 FilesystemArtifact::FilesystemArtifact(const std::filesystem::path& path)
   : mPath(path) {}
 
-void FilesystemArtifact::Remove() {
-  std::filesystem::remove_all(mPath);
-}
\ No newline at end of file
+std::vector<PlannedOperation> FilesystemArtifact::PlanRemoval() const {
+  return {PlannedOperation::RemovePath(mPath)};
+}
+
+std::vector<std::filesystem::path> FilesystemArtifact::GetDiskUsageRoots()
+  const {
+  return {mPath};
+}
+
+Artifact::Details FilesystemArtifact::GetDetails() const {
+  return {.mSummary = std::format("Found in {}", mPath.string())};
+}
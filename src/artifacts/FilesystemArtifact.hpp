@@ -12,7 +12,13 @@ class FilesystemArtifact : public virtual Artifact {
   ~FilesystemArtifact() override = default;
 
   bool IsPresent() const final;
-  void Remove() final;
+  // Usually instant; see `TombstoneReaper`. Not measured, as that would
+  // take longer than the removal.
+  [[nodiscard]] std::vector<PlannedOperation> PlanRemoval() const final;
+  [[nodiscard]] std::vector<std::filesystem::path> GetDiskUsageRoots()
+    const final;
+  // Where it was found
+  [[nodiscard]] Details GetDetails() const override;
 
  protected:
   explicit FilesystemArtifact(const std::filesystem::path& path);
@@ -6,66 +6,60 @@
 #include <wil/registry.h>
 #include <winrt/base.h>
 
-#include <FredEmmott/GUI.hpp>
+#include <ranges>
 
-#include "Versions.hpp"
+#include "Instrumentation.hpp"
 
-HKCULayer::HKCULayer() {
+HKCULayer::HKCULayer()
+  : mLabels([this] {
+      return std::ranges::to<std::vector>(
+        mValueNames | std::views::transform([](const auto& name) {
+          return winrt::to_string(name);
+        }));
+    }) {
+  wil::unique_hkey key;
   if (!SUCCEEDED(
         wil::reg::open_unique_key_nothrow(
-          HKEY_CURRENT_USER,
-          L"Software\\Khronos\\OpenXR\\1\\ApiLayers\\Implicit",
-          mKey,
-          wil::reg::key_access::readwrite))) {
+          HKEY_CURRENT_USER, SubKey, key, wil::reg::key_access::read))) {
     return;
   }
   for (auto&& value: wil::make_range(
-         wil::reg::value_iterator {mKey.get()}, wil::reg::value_iterator {})) {
+         wil::reg::value_iterator {key.get()}, wil::reg::value_iterator {})) {
+    Instrumentation::Increment(Instrumentation::Counter::RegistryValuesRead);
     if (value.name.contains(L"OpenKneeboard")) {
-      mValues.emplace_back(value.name, winrt::to_string(value.name));
+      mValueNames.emplace_back(value.name);
     }
   }
 }
 
 bool HKCULayer::IsPresent() const {
-  return !mValues.empty();
+  return !mValueNames.empty();
 }
 
-void HKCULayer::Remove() {
-  for (auto&& value: mValues) {
-    RegDeleteValueW(mKey.get(), value.mValueName.c_str());
-  }
+std::vector<PlannedOperation> HKCULayer::PlanRemoval() const {
+  return std::ranges::to<std::vector>(
+    mValueNames | std::views::transform([](const auto& name) {
+      return PlannedOperation::DeleteRegistryValue(
+        RegistryHive::CurrentUser,
+        RegistryView::Default,
+        SubKey,
+        name);
+    }));
 }
 
-std::string_view HKCULayer::GetTitle() const {
-  return "HKCU OpenXR API layers";
+Artifact::Details HKCULayer::GetDetails() const {
+  return {
+    .mExplanation = {
+      "OpenXR API layers can be installed in the registry either under "
+      "HKEY_LOCAL_MACHINE (HKLM), or under HKEY_CURRENT_USER (HKCU). "
+      "OpenKneeboard originally used HKCU, but now uses HKLM to improve "
+      "compatibility with other software. Found OpenKneeboard layers "
+      "installed in HKCU:",
+    },
+    .mItems = *mLabels,
+  };
 }
 
-void HKCULayer::DrawCardContent() const {
-  using namespace FredEmmott::GUI;
-  using namespace FredEmmott::GUI::Immediate;
-
-  TextBlock(
-    "OpenXR API layers can be installed in the registry either under "
-    "HKEY_LOCAL_MACHINE (HKLM), or under HKEY_CURRENT_USER (HKCU). "
-    "OpenKneeboard originally used HKCU, but now uses HKLM to improve "
-    "compatibility with other software. Found OpenKneeboard layers "
-    "installed in HKCU:");
-
-  const auto innerLayout = BeginVStackPanel().Scoped().Styled(Style().Gap(6));
-  for (auto&& value: mValues) {
-    Label("• {}", value.mLabel);
-  }
+const Artifact::Metadata& HKCULayer::GetMetadata() const {
+  return StaticMetadata;
 }
-
-Artifact::Kind HKCULayer::GetKind() const {
-  return Kind::Software;
-}
-
-Version HKCULayer::GetEarliestVersion() const {
-  return Versions::v0_3;
-}
-
-std::optional<Version> HKCULayer::GetRemovedVersion() const {
-  return Versions::v1_3;
-}
\ No newline at end of file
@@ -2,28 +2,37 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
-#include <Windows.h>
-#include <wil/registry.h>
+#include <array>
+#include <string>
+#include <vector>
 
 #include "Artifact.hpp"
+#include "ChangeSource.hpp"
+#include "Lazy.hpp"
+#include "Versions.hpp"
 
 class HKCULayer final : public Artifact {
  public:
+  static constexpr Metadata StaticMetadata {
+    .mTitle = "HKCU OpenXR API layers",
+    .mKind = Kind::Software,
+    .mEarliestVersion = Versions::v0_3,
+    .mRemovedVersion = Versions::v1_3,
+  };
+  static constexpr auto SubKey
+    = L"Software\\Khronos\\OpenXR\\1\\ApiLayers\\Implicit";
+  static constexpr std::array ChangeSources {
+    ChangeSource::RegistryKey(RegistryHive::CurrentUser, SubKey),
+  };
+
   HKCULayer();
   ~HKCULayer() override = default;
   [[nodiscard]] bool IsPresent() const override;
-  void Remove() override;
-  [[nodiscard]] std::string_view GetTitle() const override;
-  void DrawCardContent() const override;
-  [[nodiscard]] Kind GetKind() const override;
-  [[nodiscard]] Version GetEarliestVersion() const override;
-  [[nodiscard]] std::optional<Version> GetRemovedVersion() const override;
+  [[nodiscard]] std::vector<PlannedOperation> PlanRemoval() const override;
+  [[nodiscard]] const Metadata& GetMetadata() const override;
+  [[nodiscard]] Details GetDetails() const override;
 
  private:
-  wil::unique_hkey mKey;
-  struct Value {
-    std::wstring mValueName;
-    std::string mLabel;
-  };
-  std::vector<Value> mValues;
+  std::vector<std::wstring> mValueNames;
+  Lazy<std::vector<std::string>> mLabels;
 };
\ No newline at end of file
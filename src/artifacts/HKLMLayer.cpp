@@ -6,35 +6,29 @@
 #include <wil/registry.h>
 #include <winrt/base.h>
 
-#include <FredEmmott/GUI.hpp>
 #include <filesystem>
 
-#include "Versions.hpp"
+#include "Instrumentation.hpp"
 
-HKLMLayer::HKLMLayer() {
-  constexpr auto SubKey = L"SOFTWARE\\Khronos\\OpenXR\\1\\ApiLayers\\Implicit";
+HKLMLayer::HKLMLayer() : mLabels([this] { return CreateLabels(); }) {
   RegOpenKeyExW(
     HKEY_LOCAL_MACHINE,
     SubKey,
     0,
-    KEY_WOW64_64KEY | KEY_READ | KEY_WRITE,
+    KEY_WOW64_64KEY | KEY_READ,
     std::out_ptr(mKey64));
   RegOpenKeyExW(
     HKEY_LOCAL_MACHINE,
     SubKey,
     0,
-    KEY_WOW64_32KEY | KEY_READ | KEY_WRITE,
+    KEY_WOW64_32KEY | KEY_READ,
     std::out_ptr(mKey32));
-  for (auto [keyName, key]:
-       {std::tuple {"64-bit", mKey64.get()},
-        std::tuple {"32-bit", mKey32.get()}}) {
+  for (auto key: {mKey64.get(), mKey32.get()}) {
     for (auto&& value: wil::make_range(
            wil::reg::value_iterator {key}, wil::reg::value_iterator {})) {
+      Instrumentation::Increment(Instrumentation::Counter::RegistryValuesRead);
       if (value.name.contains(L"OpenKneeboard")) {
-        mValues.emplace_back(
-          key,
-          value.name,
-          std::format("{} ({})", winrt::to_string(value.name), keyName));
+        mValues.emplace_back(key, value.name);
       }
     }
   }
@@ -42,33 +36,59 @@ HKLMLayer::HKLMLayer() {
   mModernLayerPath32 = GetModernLayerPath(L"OpenKneeboard-OpenXR32.json");
 }
 
+std::vector<std::string> HKLMLayer::CreateLabels() const {
+  std::vector<std::string> ret;
+  ret.reserve(mValues.size());
+  for (auto&& value: mValues) {
+    ret.push_back(std::format(
+      "{} ({})",
+      winrt::to_string(value.mValueName),
+      value.mKey == mKey64.get() ? "64-bit" : "32-bit"));
+  }
+  return ret;
+}
+
 bool HKLMLayer::IsPresent() const {
   return !mValues.empty();
 }
 
-void HKLMLayer::Remove() {
+RegistryView HKLMLayer::GetView(const Value& value) const {
+  return value.mKey == mKey64.get() ? RegistryView::Bits64
+                                    : RegistryView::Bits32;
+}
+
+std::vector<PlannedOperation> HKLMLayer::PlanRemoval() const {
+  std::vector<PlannedOperation> ret;
+  ret.reserve(mValues.size());
   for (auto&& value: mValues) {
-    RegDeleteValueW(mKey64.get(), value.mValueName.c_str());
+    ret.push_back(PlannedOperation::DeleteRegistryValue(
+      RegistryHive::LocalMachine, GetView(value), SubKey, value.mValueName));
   }
+  return ret;
 }
 
-void HKLMLayer::Repair() {
+std::vector<PlannedOperation> HKLMLayer::PlanRepair() const {
   const std::wstring modern64
     = mModernLayerPath64 ? mModernLayerPath64->wstring() : L"";
   const std::wstring modern32
     = mModernLayerPath32 ? mModernLayerPath32->wstring() : L"";
 
+  std::vector<PlannedOperation> ret;
+  ret.reserve(mValues.size());
   for (auto&& value: mValues) {
-    if (
-      (value.mKey == mKey64.get() && (!modern64.empty())
-       && value.mValueName == modern64)
-      || (value.mKey == mKey32.get() && (!modern32.empty()) && value.mValueName == modern32)) {
-      wil::reg::set_value_dword(
-        value.mKey, nullptr, value.mValueName.c_str(), 1);
+    const auto view = GetView(value);
+    const auto& modern
+      = (view == RegistryView::Bits64) ? modern64 : modern32;
+    if ((!modern.empty()) && value.mValueName == modern) {
+      // Enabled
+      ret.push_back(PlannedOperation::SetRegistryDWORD(
+        RegistryHive::LocalMachine, view, SubKey, value.mValueName, 1));
       continue;
     }
-    RegDeleteValueW(value.mKey, value.mValueName.c_str());
+    ret.push_back(PlannedOperation::DeleteRegistryValue(
+      RegistryHive::LocalMachine, view, SubKey, value.mValueName));
   }
+  return ret;
 }
 
 bool HKLMLayer::CanRepair() const {
@@ -77,6 +97,7 @@ bool HKLMLayer::CanRepair() const {
 
 std::optional<std::filesystem::path> HKLMLayer::GetModernLayerPath(
   std::wstring_view fileName) const try {
+  Instrumentation::Increment(Instrumentation::Counter::RegistryValuesRead);
   const auto pathStr = wil::reg::try_get_value_string(
     HKEY_LOCAL_MACHINE, L"SOFTWARE\\Fred Emmott\\OpenKneeboard", L"InstallDir");
   if (!pathStr) {
@@ -97,32 +118,17 @@ std::optional<std::filesystem::path> HKLMLayer::GetModernLayerPath(
   return {};
 }
 
-std::string_view HKLMLayer::GetTitle() const {
-  return "HKLM OpenXR API layers";
-}
-
-void HKLMLayer::DrawCardContent() const {
-  using namespace FredEmmott::GUI;
-  using namespace FredEmmott::GUI::Immediate;
-  TextBlock(
-    "OpenXR API layers are usually installed in the registry under "
-    "HKEY_LOCAL_MACHINE (HKLM). Found OpenKneeboard API layers installed in "
-    "HKLM:");
-
-  const auto inner = BeginVStackPanel().Styled(Style().Gap(8)).Scoped();
-  for (auto&& value: mValues) {
-    Label("• {}", value.mLabel);
-  }
+Artifact::Details HKLMLayer::GetDetails() const {
+  return {
+    .mExplanation = {
+      "OpenXR API layers are usually installed in the registry under "
+      "HKEY_LOCAL_MACHINE (HKLM). Found OpenKneeboard API layers installed "
+      "in HKLM:",
+    },
+    .mItems = *mLabels,
+  };
 }
 
-Artifact::Kind HKLMLayer::GetKind() const {
-  return Kind::Software;
+const Artifact::Metadata& HKLMLayer::GetMetadata() const {
+  return StaticMetadata;
 }
-
-Version HKLMLayer::GetEarliestVersion() const {
-  return Versions::v1_3;
-}
-
-std::optional<Version> HKLMLayer::GetRemovedVersion() const {
-  return std::nullopt;
-}
\ No newline at end of file
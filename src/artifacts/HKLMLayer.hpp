@@ -5,23 +5,42 @@
 #include <Windows.h>
 #include <wil/registry.h>
 
+#include <array>
 #include <filesystem>
 
 #include "Artifact.hpp"
+#include "ChangeSource.hpp"
+#include "Lazy.hpp"
+#include "MSIInstallation.hpp"
+#include "Versions.hpp"
 
 class HKLMLayer final : public RepairableArtifact {
  public:
+  static constexpr Metadata StaticMetadata {
+    .mTitle = "HKLM OpenXR API layers",
+    .mKind = Kind::Software,
+    .mEarliestVersion = Versions::v1_3,
+    .mRemovedVersion = std::nullopt,
+  };
+  static constexpr auto SubKey
+    = L"SOFTWARE\\Khronos\\OpenXR\\1\\ApiLayers\\Implicit";
+  static constexpr std::array ChangeSources {
+    ChangeSource::RegistryKey(RegistryHive::LocalMachine, SubKey),
+  };
+  // Repair keeps the layers that the MSI registers, so must see the result
+  // of any MSI changes
+  static constexpr std::array RunsAfter {
+    MSIInstallation::StaticMetadata.mTitle,
+  };
+
   HKLMLayer();
   ~HKLMLayer() override = default;
   [[nodiscard]] bool IsPresent() const override;
-  void Remove() override;
+  [[nodiscard]] std::vector<PlannedOperation> PlanRemoval() const override;
   [[nodiscard]] bool CanRepair() const override;
-  void Repair() override;
-  [[nodiscard]] std::string_view GetTitle() const override;
-  void DrawCardContent() const override;
-  [[nodiscard]] Kind GetKind() const override;
-  [[nodiscard]] Version GetEarliestVersion() const override;
-  [[nodiscard]] std::optional<Version> GetRemovedVersion() const override;
+  [[nodiscard]] std::vector<PlannedOperation> PlanRepair() const override;
+  [[nodiscard]] const Metadata& GetMetadata() const override;
+  [[nodiscard]] Details GetDetails() const override;
 
  private:
   wil::unique_hkey mKey64;
@@ -30,12 +49,14 @@ class HKLMLayer final : public RepairableArtifact {
   struct Value {
     HKEY mKey {nullptr};
     std::wstring mValueName;
-    std::string mLabel;
   };
   std::vector<Value> mValues;
+  Lazy<std::vector<std::string>> mLabels;
   std::optional<std::filesystem::path> mModernLayerPath64;
   std::optional<std::filesystem::path> mModernLayerPath32;
 
   std::optional<std::filesystem::path> GetModernLayerPath(
     std::wstring_view fileName) const;
+  std::vector<std::string> CreateLabels() const;
+  RegistryView GetView(const Value&) const;
 };
\ No newline at end of file
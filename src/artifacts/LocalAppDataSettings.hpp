@@ -6,14 +6,21 @@
 
 #include "Artifact.hpp"
 #include "FilesystemArtifact.hpp"
+#include "KnownFolders.hpp"
+#include "Versions.hpp"
 
 class LocalAppDataSettings final : public FilesystemArtifact {
  public:
-  LocalAppDataSettings();
+  static constexpr KnownFolders::Location Location {
+    KnownFolder::LocalAppData, L"OpenKneeboard"};
+  static constexpr Metadata StaticMetadata {
+    .mTitle = "Settings in Local App Data",
+    .mKind = Kind::UserSettings,
+    .mEarliestVersion = Versions::v1_10,
+    .mRemovedVersion = std::nullopt,
+  };
+
+  explicit LocalAppDataSettings(KnownFolders& folders = KnownFolders::Get());
   ~LocalAppDataSettings() override = default;
-  [[nodiscard]] std::string_view GetTitle() const override;
-  void DrawCardContent() const override;
-  [[nodiscard]] Version GetEarliestVersion() const override;
-  [[nodiscard]] std::optional<Version> GetRemovedVersion() const override;
-  Kind GetKind() const override;
+  [[nodiscard]] const Metadata& GetMetadata() const override;
 };
\ No newline at end of file
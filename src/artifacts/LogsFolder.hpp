@@ -6,17 +6,21 @@
 
 #include "Artifact.hpp"
 #include "FilesystemArtifact.hpp"
+#include "KnownFolders.hpp"
+#include "Versions.hpp"
 
 class LogsFolder final : public FilesystemArtifact {
  public:
-  LogsFolder();
-  ~LogsFolder() override = default;
-  [[nodiscard]] std::string_view GetTitle() const override;
-  void DrawCardContent() const override;
-  [[nodiscard]] Version GetEarliestVersion() const override;
-  [[nodiscard]] std::optional<Version> GetRemovedVersion() const override;
-  Kind GetKind() const override;
+  static constexpr KnownFolders::Location Location {
+    KnownFolder::LocalAppData, L"OpenKneeboard Logs"};
+  static constexpr Metadata StaticMetadata {
+    .mTitle = "Logs or crash dumps",
+    .mKind = Kind::Logs,
+    .mEarliestVersion = Versions::v1_10,
+    .mRemovedVersion = std::nullopt,
+  };
 
- private:
-  std::filesystem::path mPath;
+  explicit LogsFolder(KnownFolders& folders = KnownFolders::Get());
+  ~LogsFolder() override = default;
+  [[nodiscard]] const Metadata& GetMetadata() const override;
 };
\ No newline at end of file
@@ -2,36 +2,34 @@
 // SPDX-License-Identifier: MIT
 #include "MSIInstallation.hpp"
 
-#include <FredEmmott/GUI.hpp>
+#include <format>
 
-#include "Msi.h"
+MSIInstallation::MSIInstallation(InstallerInventory& inventory)
+  : BasicMSIArtifact(inventory) {}
 
-MSIInstallation::MSIInstallation() = default;
-
-void MSIInstallation::Remove() {
-  MsiConfigureProductW(
-    GetInstallations().back().mProductCode.c_str(),
-    INSTALLLEVEL_DEFAULT,
-    INSTALLSTATE_ABSENT);
+std::vector<PlannedOperation> MSIInstallation::PlanRemoval() const {
+  return {PlannedOperation::UninstallMSIProduct(
+    GetInstallations().back().mProductCode)};
 }
 
-void MSIInstallation::Repair() {
-  MsiReinstallProductW(
-    GetInstallations().back().mProductCode.c_str(),
-    REINSTALLMODE_FILEREPLACE | REINSTALLMODE_MACHINEDATA);
+std::vector<PlannedOperation> MSIInstallation::PlanRepair() const {
+  return {
+    PlannedOperation::RepairMSIProduct(GetInstallations().back().mProductCode)};
 }
 
 bool MSIInstallation::IsPresent() const {
   return !GetInstallations().empty();
 }
 
-std::string_view MSIInstallation::GetTitle() const {
-  return "MSI installation";
+Artifact::Details MSIInstallation::GetDetails() const {
+  return {
+    .mExplanation = {
+      "OpenKneeboard is installed via a Windows Installer (MSI) package.",
+    },
+    .mSummary = std::format("Found {}", GetDescriptions().back()),
+  };
 }
 
-void MSIInstallation::DrawCardContent() const {
-  namespace fuii = FredEmmott::GUI::Immediate;
-  fuii::TextBlock(
-    "OpenKneeboard is installed via a Windows Installer (MSI) package.");
-  fuii::Label("Found {}", GetInstallations().back().mDescription);
-}
\ No newline at end of file
+const Artifact::Metadata& MSIInstallation::GetMetadata() const {
+  return StaticMetadata;
+}
@@ -2,18 +2,34 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <array>
+
 #include "Artifact.hpp"
 #include "BasicMSIArtifact.hpp"
+#include "MultipleMSIInstallations.hpp"
+#include "Versions.hpp"
 
 class MSIInstallation final
   : public BasicMSIArtifact,
     public RepairableArtifact {
  public:
-  MSIInstallation();
+  static constexpr Metadata StaticMetadata {
+    .mTitle = "MSI installation",
+    .mKind = Kind::Software,
+    .mEarliestVersion = Versions::v1_2,
+    .mRemovedVersion = std::nullopt,
+  };
+  // Repair the newest installation only once the others are gone
+  static constexpr std::array RunsAfter {
+    MultipleMSIInstallations::StaticMetadata.mTitle,
+  };
+
+  explicit MSIInstallation(
+    InstallerInventory& inventory = InstallerInventory::Get());
   ~MSIInstallation() override = default;
   [[nodiscard]] bool IsPresent() const override;
-  void Remove() override;
-  void Repair() override;
-  [[nodiscard]] std::string_view GetTitle() const override;
-  void DrawCardContent() const override;
+  [[nodiscard]] std::vector<PlannedOperation> PlanRemoval() const override;
+  [[nodiscard]] std::vector<PlannedOperation> PlanRepair() const override;
+  [[nodiscard]] const Metadata& GetMetadata() const override;
+  [[nodiscard]] Details GetDetails() const override;
 };
\ No newline at end of file
@@ -2,32 +2,48 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "Artifact.hpp"
+#include "ChangeSource.hpp"
+#include "InstallerInventory.hpp"
+#include "Lazy.hpp"
+#include "Versions.hpp"
 
 class MSIXInstallation final : public Artifact {
  public:
-  MSIXInstallation();
+  static constexpr Metadata StaticMetadata {
+    .mTitle = "MSIX installations",
+    .mKind = Kind::Software,
+    .mEarliestVersion = Versions::v0_1,
+    .mRemovedVersion = Versions::v1_2,
+  };
+  // Per-user package registrations
+  static constexpr std::array ChangeSources {
+    ChangeSource::RegistryKey(
+      RegistryHive::CurrentUser,
+      L"Software\\Classes\\Local Settings\\Software\\Microsoft\\Windows\\"
+      L"CurrentVersion\\AppModel\\Repository\\Packages"),
+  };
+  // Deployment operations queue behind any others on the system
+  static constexpr std::chrono::milliseconds ActionTimeout {
+    std::chrono::minutes {15}};
+
+  explicit MSIXInstallation(
+    InstallerInventory& inventory = InstallerInventory::Get());
   ~MSIXInstallation() override = default;
 
   [[nodiscard]] bool IsPresent() const override;
-  void Remove() override;
-  [[nodiscard]] std::string_view GetTitle() const override;
-  void DrawCardContent() const override;
-  [[nodiscard]] Kind GetKind() const override;
-  [[nodiscard]] Version GetEarliestVersion() const override;
-  [[nodiscard]] std::optional<Version> GetRemovedVersion() const override;
+  [[nodiscard]] std::vector<PlannedOperation> PlanRemoval() const override;
+  [[nodiscard]] const Metadata& GetMetadata() const override;
+  [[nodiscard]] Details GetDetails() const override;
 
  private:
-  struct Installation {
-    std::string mFullName;
-    std::string mVersion;
-
-    auto operator<=>(const Installation& other) const noexcept {
-      return mVersion <=> other.mVersion;
-    }
-  };
-  std::vector<Installation> mInstallations;
+  std::shared_ptr<const std::vector<InstallerInventory::MSIXPackage>>
+    mInstallations;
+  Lazy<std::vector<std::string>> mVersions;
 };
\ No newline at end of file
@@ -2,43 +2,41 @@
 // SPDX-License-Identifier: MIT
 #include "MultipleMSIInstallations.hpp"
 
-#include <Windows.h>
-#include <msi.h>
-
-#include <FredEmmott/GUI.hpp>
-
-#include "Versions.hpp"
-
-MultipleMSIInstallations::MultipleMSIInstallations() {}
-
-void MultipleMSIInstallations::Remove() {
-  auto installations = GetInstallations();
-  installations.pop_back();
-  for (auto&& it: installations) {
-    MsiConfigureProductW(
-      it.mProductCode.c_str(), INSTALLLEVEL_DEFAULT, INSTALLSTATE_ABSENT);
+#include <format>
+#include <span>
+
+MultipleMSIInstallations::MultipleMSIInstallations(
+  InstallerInventory& inventory)
+  : BasicMSIArtifact(inventory) {}
+
+std::vector<PlannedOperation> MultipleMSIInstallations::PlanRemoval() const {
+  const auto& installations = GetInstallations();
+  std::vector<PlannedOperation> ret;
+  // Keep the newest
+  for (auto&& it: std::span {installations}.first(installations.size() - 1)) {
+    ret.push_back(PlannedOperation::UninstallMSIProduct(it.mProductCode));
   }
+  return ret;
 }
 
 bool MultipleMSIInstallations::IsPresent() const {
   return GetInstallations().size() > 1;
 }
 
-std::string_view MultipleMSIInstallations::GetTitle() const {
-  return "Duplicate MSI installations";
+Artifact::Details MultipleMSIInstallations::GetDetails() const {
+  Details ret {
+    .mExplanation = {
+      "Multiple versions of OpenKneeboard are installed via Windows "
+      "Installer (MSI). This is unusual and may cause conflicts.",
+    },
+  };
+  ret.mItems.reserve(GetDescriptions().size());
+  for (auto&& it: GetDescriptions()) {
+    ret.mItems.push_back(std::format("Found {}", it));
+  }
+  return ret;
 }
 
-void MultipleMSIInstallations::DrawCardContent() const {
-  using namespace FredEmmott::GUI;
-  using namespace FredEmmott::GUI::Immediate;
-  TextBlock(
-    "Multiple versions of OpenKneeboard are installed via Windows "
-    "Installer (MSI). This is unusual and may cause conflicts.");
-  const auto subLayout = BeginVStackPanel().Styled(Style().Gap(4)).Scoped();
-  for (auto&& it: GetInstallations()) {
-    Label(" • Found {}", it.mDescription);
-  }
+const Artifact::Metadata& MultipleMSIInstallations::GetMetadata() const {
+  return StaticMetadata;
 }
-std::optional<Version> MultipleMSIInstallations::GetRemovedVersion() const {
-  return Versions::v1_10;
-}
\ No newline at end of file
@@ -4,15 +4,22 @@
 
 #include "Artifact.hpp"
 #include "BasicMSIArtifact.hpp"
+#include "Versions.hpp"
 
 class MultipleMSIInstallations final : public BasicMSIArtifact {
  public:
-  MultipleMSIInstallations();
+  static constexpr Metadata StaticMetadata {
+    .mTitle = "Duplicate MSI installations",
+    .mKind = Kind::Software,
+    .mEarliestVersion = Versions::v1_2,
+    .mRemovedVersion = Versions::v1_10,
+  };
+
+  explicit MultipleMSIInstallations(
+    InstallerInventory& inventory = InstallerInventory::Get());
   ~MultipleMSIInstallations() override = default;
   [[nodiscard]] bool IsPresent() const override;
-  void Remove() override;
-  [[nodiscard]] std::string_view GetTitle() const override;
-  void DrawCardContent() const override;
-  [[nodiscard]]
-  std::optional<Version> GetRemovedVersion() const override;
+  [[nodiscard]] std::vector<PlannedOperation> PlanRemoval() const override;
+  [[nodiscard]] const Metadata& GetMetadata() const override;
+  [[nodiscard]] Details GetDetails() const override;
 };
\ No newline at end of file
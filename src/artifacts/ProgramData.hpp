@@ -4,14 +4,22 @@
 
 #include "Artifact.hpp"
 #include "FilesystemArtifact.hpp"
+#include "KnownFolders.hpp"
+#include "Versions.hpp"
 
 class ProgramData final : public FilesystemArtifact {
  public:
-  ProgramData();
+  static constexpr KnownFolders::Location Location {
+    KnownFolder::ProgramData, L"OpenKneeboard"};
+  static constexpr Metadata StaticMetadata {
+    .mTitle = "ProgramData files",
+    .mKind = Kind::Software,
+    .mEarliestVersion = Versions::v1_0,
+    .mRemovedVersion = Versions::v1_3,
+  };
+
+  explicit ProgramData(KnownFolders& folders = KnownFolders::Get());
   ~ProgramData() override = default;
-  [[nodiscard]] std::string_view GetTitle() const override;
-  void DrawCardContent() const override;
-  [[nodiscard]] Version GetEarliestVersion() const override;
-  [[nodiscard]] std::optional<Version> GetRemovedVersion() const override;
-  Kind GetKind() const override;
+  [[nodiscard]] const Metadata& GetMetadata() const override;
+  [[nodiscard]] Details GetDetails() const override;
 };
\ No newline at end of file
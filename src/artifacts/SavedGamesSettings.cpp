@@ -2,52 +2,9 @@
 // SPDX-License-Identifier: MIT
 #include "SavedGamesSettings.hpp"
 
-#include <Windows.h>
-#include <shlobj_core.h>
-#include <wil/resource.h>
+SavedGamesSettings::SavedGamesSettings(KnownFolders& folders)
+  : FilesystemArtifact(folders.FindChild(Location)) {}
 
-#include <FredEmmott/GUI.hpp>
-#include <memory>
-
-#include "Versions.hpp"
-
-namespace {
-std::filesystem::path GetPathForConstructor() {
-  wil::unique_hlocal_string path;
-  if (FAILED(SHGetKnownFolderPath(
-        FOLDERID_SavedGames, 0, nullptr, std::out_ptr(path)))) {
-    return {};
-  }
-  const auto ret
-    = std::filesystem::path {std::wstring_view {path.get()}} / L"OpenKneeboard";
-  if (!std::filesystem::exists(ret)) {
-    return {};
-  }
-
-  return ret;
+const Artifact::Metadata& SavedGamesSettings::GetMetadata() const {
+  return StaticMetadata;
 }
-}// namespace
-
-SavedGamesSettings::SavedGamesSettings()
-  : FilesystemArtifact {GetPathForConstructor()} {}
-
-std::string_view SavedGamesSettings::GetTitle() const {
-  return "Settings in 'Saved Games'";
-}
-
-void SavedGamesSettings::DrawCardContent() const {
-  namespace fuii = FredEmmott::GUI::Immediate;
-  fuii::Label("Found in {}", mPath.string());
-}
-
-Artifact::Kind SavedGamesSettings::GetKind() const {
-  return Kind::UserSettings;
-}
-
-Version SavedGamesSettings::GetEarliestVersion() const {
-  return Versions::v0_1;
-}
-
-std::optional<Version> SavedGamesSettings::GetRemovedVersion() const {
-  return Versions::v1_10;
-}
\ No newline at end of file
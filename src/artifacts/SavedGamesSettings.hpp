@@ -6,17 +6,21 @@
 
 #include "Artifact.hpp"
 #include "FilesystemArtifact.hpp"
+#include "KnownFolders.hpp"
+#include "Versions.hpp"
 
 class SavedGamesSettings final : public FilesystemArtifact {
  public:
-  SavedGamesSettings();
-  ~SavedGamesSettings() override = default;
-  [[nodiscard]] std::string_view GetTitle() const override;
-  void DrawCardContent() const override;
-  [[nodiscard]] Version GetEarliestVersion() const override;
-  [[nodiscard]] std::optional<Version> GetRemovedVersion() const override;
-  Kind GetKind() const override;
+  static constexpr KnownFolders::Location Location {
+    KnownFolder::SavedGames, L"OpenKneeboard"};
+  static constexpr Metadata StaticMetadata {
+    .mTitle = "Settings in 'Saved Games'",
+    .mKind = Kind::UserSettings,
+    .mEarliestVersion = Versions::v0_1,
+    .mRemovedVersion = Versions::v1_10,
+  };
 
- private:
-  std::filesystem::path mPath;
+  explicit SavedGamesSettings(KnownFolders& folders = KnownFolders::Get());
+  ~SavedGamesSettings() override = default;
+  [[nodiscard]] const Metadata& GetMetadata() const override;
 };
\ No newline at end of file
@@ -6,17 +6,21 @@
 
 #include "Artifact.hpp"
 #include "FilesystemArtifact.hpp"
+#include "KnownFolders.hpp"
+#include "Versions.hpp"
 
 class TemporaryFilesFolder final : public FilesystemArtifact {
  public:
-  TemporaryFilesFolder();
-  ~TemporaryFilesFolder() override = default;
-  [[nodiscard]] std::string_view GetTitle() const override;
-  void DrawCardContent() const override;
-  [[nodiscard]] Version GetEarliestVersion() const override;
-  [[nodiscard]] std::optional<Version> GetRemovedVersion() const override;
-  Kind GetKind() const override;
+  static constexpr KnownFolders::Location Location {
+    KnownFolder::Temp, L"OpenKneeboard"};
+  static constexpr Metadata StaticMetadata {
+    .mTitle = "Temporary Files",
+    .mKind = Kind::TemporaryFiles,
+    .mEarliestVersion = Versions::v1_10,
+    .mRemovedVersion = std::nullopt,
+  };
 
- private:
-  std::filesystem::path mPath;
+  explicit TemporaryFilesFolder(KnownFolders& folders = KnownFolders::Get());
+  ~TemporaryFilesFolder() override = default;
+  [[nodiscard]] const Metadata& GetMetadata() const override;
 };
\ No newline at end of file
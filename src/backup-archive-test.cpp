@@ -0,0 +1,282 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+// Backs up a folder tree with `BackupArchive`, deletes it, restores it, and
+// compares the result; then checks that truncated, corrupt, or extended
+// archives are rejected.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <random>
+#include <source_location>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BackupArchive.hpp"
+#include "Progress.hpp"
+
+namespace {
+namespace fs = std::filesystem;
+
+bool gFailed = false;
+
+void Check(
+  const bool condition,
+  const std::string_view what,
+  const std::source_location& caller = std::source_location::current()) {
+  if (condition) {
+    return;
+  }
+  std::cerr << std::format(
+    "{}:{}: {}\n", caller.file_name(), caller.line(), what);
+  gFailed = true;
+}
+
+// Relative path to contents; folders have no value
+using Tree = std::map<fs::path, std::optional<std::string>>;
+
+void WriteFile(const fs::path& path, const std::string_view contents) {
+  fs::create_directories(path.parent_path());
+  std::ofstream {path, std::ios::binary}.write(
+    contents.data(), static_cast<std::streamsize>(contents.size()));
+}
+
+std::string ReadFile(const fs::path& path) {
+  std::ifstream file {path, std::ios::binary};
+  return {std::istreambuf_iterator<char> {file}, {}};
+}
+
+// Random, so it doesn't compress well
+std::string MakeContents(const std::size_t size, const std::uint32_t seed) {
+  std::mt19937 random {seed};
+  std::uniform_int_distribution<int> byte {0, 255};
+  std::string ret(size, '\0');
+  for (auto& it: ret) {
+    it = static_cast<char>(byte(random));
+  }
+  return ret;
+}
+
+// Empty and nested folders, an empty file, and files both smaller and
+// larger than the size that's read ahead rather than mapped
+void CreateTree(const fs::path& root, const bool withLargeFile) {
+  fs::create_directories(root / "Empty folder");
+  WriteFile(root / "Settings.json", R"({"theme":"dark"})");
+  WriteFile(root / "Empty.txt", {});
+  WriteFile(root / "Profiles" / "Default" / "Tabs.json", "[1,2,3]");
+  for (std::uint32_t i = 0; i < 20; ++i) {
+    WriteFile(
+      root / "Profiles" / std::format("Profile {}", i) / "Notes.bin",
+      MakeContents(i * 100, i));
+  }
+  if (withLargeFile) {
+    WriteFile(root / "Large.bin", MakeContents(3 * 1024 * 1024, 1234));
+  }
+}
+
+Tree ReadTree(const fs::path& root) {
+  Tree ret;
+  for (auto&& it: fs::recursive_directory_iterator {root}) {
+    const auto relative = it.path().lexically_relative(root);
+    if (it.is_directory()) {
+      ret.emplace(relative, std::nullopt);
+    } else {
+      ret.emplace(relative, ReadFile(it.path()));
+    }
+  }
+  return ret;
+}
+
+// Returns true if restoring threw `std::runtime_error` without writing
+// anything to `root`, which must not exist
+bool Rejects(const fs::path& archive, const fs::path& root) {
+  try {
+    BackupArchive {}.Restore(archive);
+  } catch (const fs::filesystem_error& e) {
+    std::cerr << std::format("Unexpected filesystem error: {}\n", e.what());
+    return false;
+  } catch (const std::runtime_error&) {
+    if (fs::exists(root)) {
+      std::cerr << "Rejected archive was partially restored\n";
+      return false;
+    }
+    return true;
+  }
+  return false;
+}
+
+std::string ReadArchive(const fs::path& path) {
+  return ReadFile(path);
+}
+
+void WriteArchive(const fs::path& path, const std::string_view data) {
+  std::ofstream {path, std::ios::binary | std::ios::trunc}.write(
+    data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+void TestRoundTrip(const fs::path& folder) {
+  const auto roots = std::vector {
+    folder / "RoundTrip" / "A",
+    folder / "RoundTrip" / "B",
+    // Missing roots are skipped
+    folder / "RoundTrip" / "Missing",
+  };
+  CreateTree(roots.at(0), true);
+  CreateTree(roots.at(1), false);
+  const auto expectedA = ReadTree(roots.at(0));
+  const auto expectedB = ReadTree(roots.at(1));
+
+  const auto archive = folder / "RoundTrip.okbbackup";
+  Progress progress;
+  Check(
+    BackupArchive {}.Create(archive, roots, &progress), "Create() failed");
+  Check(fs::exists(archive), "Archive not created");
+  Check(
+    !fs::exists(fs::path {archive} += L".partial"),
+    "Partial archive left behind");
+  Check(
+    progress.GetSnapshot().mDone.mFiles
+      == expectedA.size() + expectedB.size() + 2,
+    "Wrong file count in progress");
+  Check(
+    BackupArchive::GetRoots(archive) == roots, "Wrong roots in archive");
+
+  fs::remove_all(folder / "RoundTrip");
+  BackupArchive {}.Restore(archive);
+  Check(ReadTree(roots.at(0)) == expectedA, "First root changed");
+  Check(ReadTree(roots.at(1)) == expectedB, "Second root changed");
+  Check(!fs::exists(roots.at(2)), "Missing root was created");
+
+  // Existing files are replaced
+  WriteFile(roots.at(0) / "Settings.json", "changed");
+  BackupArchive {}.Restore(archive);
+  Check(ReadTree(roots.at(0)) == expectedA, "Existing file not replaced");
+}
+
+// Every length, as the end of the zstd frame and its checksum must be
+// checked, not just whether there was enough data for the entries
+void TestTruncated(const fs::path& folder) {
+  const auto root = folder / "Truncated" / "Root";
+  CreateTree(root, false);
+  const auto archive = folder / "Truncated.okbbackup";
+  Check(BackupArchive {}.Create(archive, {&root, 1}), "Create() failed");
+  const auto data = ReadArchive(archive);
+  fs::remove_all(root);
+
+  for (std::size_t size = 0; size < data.size(); ++size) {
+    WriteArchive(archive, std::string_view {data}.substr(0, size));
+    if (!Rejects(archive, root)) {
+      Check(
+        false,
+        std::format(
+          "Archive truncated to {} of {} bytes was accepted",
+          size,
+          data.size()));
+      return;
+    }
+  }
+}
+
+// The frame has a checksum, so a changed byte is either noticed before
+// anything is written, or didn't change what's restored, e.g. if it was in an
+// unused part of a table.
+//
+// Small archives are a single zstd block, which is checked before any of it
+// is returned; with the large file, most bytes are in later blocks, or
+// stored rather than compressed, so are only caught by the checksum at the
+// end. That's slower, so only some bytes are changed.
+void TestCorrupt(const fs::path& folder, const bool withLargeFile) {
+  const auto name = withLargeFile ? "CorruptLarge" : "Corrupt";
+  const auto root = folder / name / "Root";
+  CreateTree(root, withLargeFile);
+  const auto expected = ReadTree(root);
+  const auto archive = (folder / name) += ".okbbackup";
+  Check(BackupArchive {}.Create(archive, {&root, 1}), "Create() failed");
+  const auto data = ReadArchive(archive);
+  fs::remove_all(root);
+
+  const std::size_t stride = withLargeFile ? data.size() / 256 : 1;
+  std::vector<std::size_t> offsets;
+  for (std::size_t offset = 0; offset < data.size(); offset += stride) {
+    offsets.push_back(offset);
+  }
+  // The checksum
+  for (std::size_t offset = data.size() - 4; offset < data.size(); ++offset) {
+    offsets.push_back(offset);
+  }
+
+  std::size_t harmless = 0;
+  for (const auto offset: offsets) {
+    auto corrupt = data;
+    corrupt.at(offset) ^= 0x01;
+    WriteArchive(archive, corrupt);
+    if (Rejects(archive, root)) {
+      continue;
+    }
+    ++harmless;
+    if (!fs::exists(root) || ReadTree(root) != expected) {
+      Check(
+        false,
+        std::format(
+          "Archive with byte {} of {} changed was not rejected",
+          offset,
+          data.size()));
+      return;
+    }
+    fs::remove_all(root);
+  }
+  Check(
+    harmless <= offsets.size() / 100,
+    std::format(
+      "{} of {} changed bytes were not noticed", harmless, offsets.size()));
+}
+
+void TestNotArchives(const fs::path& folder) {
+  const auto root = folder / "NotArchives" / "Root";
+  CreateTree(root, false);
+  const auto archive = folder / "NotArchives.okbbackup";
+  Check(BackupArchive {}.Create(archive, {&root, 1}), "Create() failed");
+  const auto data = ReadArchive(archive);
+  fs::remove_all(root);
+
+  WriteArchive(archive, data + '\0');
+  Check(Rejects(archive, root), "Archive with trailing data was accepted");
+  fs::remove_all(root);
+
+  WriteArchive(archive, R"({"theme":"dark"})");
+  Check(Rejects(archive, root), "Something that isn't an archive was accepted");
+}
+}// namespace
+
+int main() {
+  const auto folder = fs::temp_directory_path()
+    / std::format("backup-archive-test-{}",
+                  std::chrono::steady_clock::now().time_since_epoch().count());
+  fs::create_directories(folder);
+
+  try {
+    TestRoundTrip(folder);
+    TestTruncated(folder);
+    TestCorrupt(folder, false);
+    TestCorrupt(folder, true);
+    TestNotArchives(folder);
+  } catch (const std::exception& e) {
+    Check(false, std::format("Unexpected exception: {}", e.what()));
+  }
+
+  std::error_code ec;
+  fs::remove_all(folder, ec);
+  return gFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,150 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+// Stress test for `SpscQueue` and `EventChannel`: several producers push
+// numbered events as fast as they can, and the consumer checks that every
+// event arrives exactly once, in order per producer.
+//
+// Most useful when built with ThreadSanitizer, e.g. with
+// `-DCMAKE_CXX_FLAGS=-fsanitize=thread`.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "EventChannel.hpp"
+#include "SpscQueue.hpp"
+
+namespace {
+
+struct Event {
+  std::size_t mProducer {};
+  std::uint64_t mSequence {};
+};
+
+// Small, so that the queue is often full and the indices wrap many times
+bool StressSpscQueue(const std::uint64_t count) {
+  SpscQueue<std::uint64_t, 8> queue;
+
+  std::jthread producer {[&queue, count] {
+    for (std::uint64_t i = 0; i < count; ++i) {
+      while (!queue.TryPush(i)) {
+        std::this_thread::yield();
+      }
+    }
+  }};
+
+  for (std::uint64_t expected = 0; expected < count;) {
+    const auto value = queue.TryPop();
+    if (!value) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (*value != expected) {
+      std::cerr << std::format(
+        "SpscQueue: expected {}, got {}\n", expected, *value);
+      return false;
+    }
+    ++expected;
+  }
+  return true;
+}
+
+bool StressEventChannel(
+  const std::size_t producerCount,
+  const std::uint64_t countPerProducer) {
+  // Counted rather than a flag, so that a wake between `Drain()` and the
+  // wait isn't lost
+  std::atomic<std::uint64_t> wakeCount {0};
+  EventChannel<Event> channel {producerCount, [&wakeCount] {
+                                 ++wakeCount;
+                                 wakeCount.notify_one();
+                               }};
+
+  std::vector<std::jthread> producers;
+  for (std::size_t producer = 0; producer < producerCount; ++producer) {
+    producers.emplace_back([&channel, producer, countPerProducer] {
+      for (std::uint64_t i = 0; i < countPerProducer; ++i) {
+        channel.Push(producer, {producer, i});
+      }
+    });
+  }
+
+  bool ok = true;
+  std::vector<std::uint64_t> next(producerCount, 0);
+  std::uint64_t remaining = producerCount * countPerProducer;
+  while (remaining > 0) {
+    const auto wakes = wakeCount.load();
+    channel.Drain([&](Event&& event) {
+      --remaining;
+      auto& expected = next.at(event.mProducer);
+      if (event.mSequence != expected) {
+        std::cerr << std::format(
+          "EventChannel: producer {} expected {}, got {}\n",
+          event.mProducer,
+          expected,
+          event.mSequence);
+        ok = false;
+      }
+      expected = event.mSequence + 1;
+    });
+    if (remaining > 0) {
+      wakeCount.wait(wakes);
+    }
+  }
+  return ok;
+}
+
+std::optional<std::size_t> ParseCount(
+  const std::string_view arg,
+  const std::string_view prefix) {
+  if (!arg.starts_with(prefix)) {
+    return std::nullopt;
+  }
+  return std::strtoull(
+    std::string {arg.substr(prefix.size())}.c_str(), nullptr, 10);
+}
+
+void ShowUsage(std::ostream& out) {
+  out << "Usage: event-channel-stress [--producers=N] [--events=N]\n";
+}
+
+}// namespace
+
+int main(int argc, char** argv) {
+  std::size_t producerCount = 8;
+  std::uint64_t countPerProducer = 200'000;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg {argv[i]};
+    if (const auto it = ParseCount(arg, "--producers=")) {
+      producerCount = *it;
+    } else if (const auto it = ParseCount(arg, "--events=")) {
+      countPerProducer = *it;
+    } else {
+      ShowUsage(std::cerr);
+      return 2;
+    }
+  }
+  if (producerCount == 0) {
+    ShowUsage(std::cerr);
+    return 2;
+  }
+
+  if (!StressSpscQueue(producerCount * countPerProducer)) {
+    return EXIT_FAILURE;
+  }
+  if (!StressEventChannel(producerCount, countPerProducer)) {
+    return EXIT_FAILURE;
+  }
+  std::cout << std::format(
+    "OK: {} producers, {} events each\n", producerCount, countPerProducer);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,201 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+// Aggregates scan reports from many machines, as written by
+// `OpenKneeboard-Fresh-Start --scan --json`; see `FleetInventory`.
+//
+// Only uses the standard library, so it can run on whatever machine the
+// reports are collected on.
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "FleetInventory.hpp"
+#include "JSON.hpp"
+#include "ScanReport.hpp"
+
+namespace {
+constexpr std::string_view ThreadsPrefix {"--threads="};
+
+// Reports are a few KB; anything much larger isn't one
+constexpr std::uintmax_t MaxReportSize = 16 * 1024 * 1024;
+// Bounds memory use, however many reports there are
+constexpr std::size_t QueueCapacity = 1024;
+
+// From the thread listing reports, to the threads parsing them
+class PathQueue {
+ public:
+  void Push(std::filesystem::path path) {
+    std::unique_lock lock(mMutex);
+    mNotFull.wait(lock, [this] { return mQueue.size() < QueueCapacity; });
+    mQueue.push_back(std::move(path));
+    mNotEmpty.notify_one();
+  }
+
+  // Wakes every waiting `Pop()` once the queue is empty
+  void Close() {
+    std::unique_lock lock(mMutex);
+    mIsClosed = true;
+    mNotEmpty.notify_all();
+  }
+
+  // nullopt once closed and empty
+  [[nodiscard]] std::optional<std::filesystem::path> Pop() {
+    std::unique_lock lock(mMutex);
+    mNotEmpty.wait(lock, [this] { return mIsClosed || !mQueue.empty(); });
+    if (mQueue.empty()) {
+      return std::nullopt;
+    }
+    auto ret = std::move(mQueue.front());
+    mQueue.pop_front();
+    mNotFull.notify_one();
+    return ret;
+  }
+
+ private:
+  std::mutex mMutex;
+  std::condition_variable mNotEmpty;
+  std::condition_variable mNotFull;
+  std::deque<std::filesystem::path> mQueue;
+  bool mIsClosed {false};
+};
+
+// `buffer` is reused for every report a thread reads
+bool ReadReport(const std::filesystem::path& path, std::string& buffer) {
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec || size > MaxReportSize) {
+    return false;
+  }
+  std::ifstream file {path, std::ios::binary};
+  if (!file) {
+    return false;
+  }
+  buffer.resize(static_cast<std::size_t>(size));
+  file.read(buffer.data(), static_cast<std::streamsize>(size));
+  return file.gcount() == static_cast<std::streamsize>(size);
+}
+
+void ParseReports(PathQueue& queue, FleetInventory& inventory) {
+  std::string buffer;
+  while (const auto path = queue.Pop()) {
+    if (!ReadReport(*path, buffer)) {
+      inventory.AddRejected(FleetInventory::Rejection::Unreadable);
+      continue;
+    }
+    try {
+      inventory.Add(ScanReport::Parse(buffer));
+    } catch (const UnsupportedScanReportError&) {
+      inventory.AddRejected(FleetInventory::Rejection::UnsupportedVersion);
+    } catch (const JSONError&) {
+      inventory.AddRejected(FleetInventory::Rejection::Malformed);
+    }
+  }
+}
+
+// Every `.json` file under `folder`, including in subfolders, e.g. one per
+// site; unreadable folders are skipped
+void ListReports(const std::filesystem::path& folder, PathQueue& queue) {
+  std::error_code ec;
+  std::filesystem::recursive_directory_iterator it {
+    folder, std::filesystem::directory_options::skip_permission_denied, ec};
+  for (; !ec && it != std::filesystem::recursive_directory_iterator {};
+       it.increment(ec)) {
+    std::error_code fileEC;
+    if (it->is_regular_file(fileEC) && it->path().extension() == ".json") {
+      queue.Push(it->path());
+    }
+  }
+  if (ec) {
+    std::cerr << std::format(
+      "Stopped listing reports early: {}\n", ec.message());
+  }
+}
+
+void ShowUsage(std::ostream& out) {
+  out << "Usage: fleet-inventory [--json] [--threads=N] FOLDER\n"
+         "\n"
+         "Reads every .json scan report under FOLDER, and prints counts by\n"
+         "artifact, kind, OpenKneeboard versions, and action taken.\n";
+}
+}// namespace
+
+int main(int argc, char** argv) {
+  bool json = false;
+  std::size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+  std::filesystem::path folder;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg {argv[i]};
+    if (arg == "--help" || arg == "-h") {
+      ShowUsage(std::cout);
+      return EXIT_SUCCESS;
+    }
+    if (arg == "--json") {
+      json = true;
+    } else if (arg.starts_with(ThreadsPrefix)) {
+      threadCount = std::strtoull(
+        std::string {arg.substr(ThreadsPrefix.size())}.c_str(), nullptr, 10);
+    } else if (folder.empty() && !arg.starts_with("--")) {
+      folder = arg;
+    } else {
+      ShowUsage(std::cerr);
+      return 2;
+    }
+  }
+  if (folder.empty() || threadCount == 0) {
+    ShowUsage(std::cerr);
+    return 2;
+  }
+  if (!std::filesystem::is_directory(folder)) {
+    std::cerr << std::format("'{}' is not a folder\n", folder.string());
+    return EXIT_FAILURE;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  PathQueue queue;
+  // One each, so nothing is shared while parsing
+  std::vector<FleetInventory> inventories(threadCount);
+  {
+    std::vector<std::jthread> workers;
+    workers.reserve(threadCount);
+    for (auto&& inventory: inventories) {
+      workers.emplace_back(
+        [&queue, &inventory] { ParseReports(queue, inventory); });
+    }
+    ListReports(folder, queue);
+    queue.Close();
+  }
+
+  FleetInventory inventory;
+  for (auto&& it: inventories) {
+    inventory.Merge(it);
+  }
+  const auto elapsed = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start);
+
+  if (json) {
+    inventory.WriteJSON(std::cout);
+  } else {
+    inventory.WriteText(std::cout);
+  }
+  std::cerr << std::format(
+    "Read {} reports in {:.2f}s with {} threads\n",
+    inventory.GetReportCount(),
+    elapsed.count(),
+    threadCount);
+  return inventory.GetReportCount() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,858 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+// Measures discovery and removal on synthetic OpenKneeboard footprints, to
+// catch performance regressions; see `SyntheticFootprint`.
+//
+// Each iteration creates a new footprint, finds every artifact in it,
+// measures their disk usage, then removes them all, like
+// `--mode=remove-all --remove-settings --no-backup`.
+//
+// Slow or unreliable storage can be simulated with the fault options; see
+// `FaultInjectingFileSystem`.
+//
+// With `--delete-trees`, it instead compares `ParallelDelete` with
+// `std::filesystem::remove_all()` on plain trees of many small files.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ArtifactDescriptor.hpp"
+#include "DCSHooksScanner.hpp"
+#include "Decisions.hpp"
+#include "DiscoveryScheduler.hpp"
+#include "FaultInjectingFileSystem.hpp"
+#include "JSON.hpp"
+#include "KnownFolders.hpp"
+#include "ParallelDelete.hpp"
+#include "PlanRunner.hpp"
+#include "SizeScanner.hpp"
+#include "SyntheticFootprint.hpp"
+#include "TombstoneReaper.hpp"
+#include "artifacts/BackupsFolder.hpp"
+#include "artifacts/DCSHooks.hpp"
+#include "artifacts/LocalAppDataSettings.hpp"
+#include "artifacts/LogsFolder.hpp"
+#include "artifacts/ProgramData.hpp"
+#include "artifacts/SavedGamesSettings.hpp"
+#include "artifacts/TemporaryFilesFolder.hpp"
+
+using namespace std::string_view_literals;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// Increased whenever a field in the `--json` output is removed or changes
+// meaning
+constexpr std::int64_t ResultsSchemaVersion = 1;
+
+// The artifact types that can be found in a footprint; the others are
+// installers or registry entries
+constexpr std::array ArtifactTypes {
+  ArtifactRegistryDetail::Describe<ProgramData>(),
+  ArtifactRegistryDetail::Describe<DCSHooks>(),
+  ArtifactRegistryDetail::Describe<SavedGamesSettings>(),
+  ArtifactRegistryDetail::Describe<LocalAppDataSettings>(),
+  ArtifactRegistryDetail::Describe<LogsFolder>(),
+  ArtifactRegistryDetail::Describe<BackupsFolder>(),
+  ArtifactRegistryDetail::Describe<TemporaryFilesFolder>(),
+};
+static_assert(ArtifactRegistryDetail::IsValid(ArtifactTypes));
+
+constexpr std::array Locations {
+  ProgramData::Location,
+  SavedGamesSettings::Location,
+  LocalAppDataSettings::Location,
+  LogsFolder::Location,
+  BackupsFolder::Location,
+  TemporaryFilesFolder::Location,
+};
+
+// Like `RegistryProbe`, but finds artifacts in the footprint instead of the
+// real known folders
+template <std::derived_from<Artifact> T>
+class FootprintProbe final : public ArtifactProbe {
+ public:
+  explicit FootprintProbe(KnownFolders& folders) : mFolders(folders) {}
+
+  [[nodiscard]] std::string_view GetName() const override {
+    return T::StaticMetadata.mTitle;
+  }
+
+  [[nodiscard]] std::chrono::milliseconds GetDeadline() const override {
+    return ArtifactRegistryDetail::DefaultDeadline;
+  }
+
+  [[nodiscard]] std::unique_ptr<Artifact> Run() override {
+    return std::make_unique<T>(mFolders);
+  }
+
+ private:
+  KnownFolders& mFolders;
+};
+
+template <class... Ts>
+std::vector<std::unique_ptr<ArtifactProbe>> MakeProbes(KnownFolders& folders) {
+  std::vector<std::unique_ptr<ArtifactProbe>> ret;
+  (ret.push_back(std::make_unique<FootprintProbe<Ts>>(folders)), ...);
+  return ret;
+}
+
+enum class Phase {
+  // Until every artifact has been found
+  Discovery,
+  // Just `DCSHooksScanner`, which is usually the slowest probe when there
+  // are many game folders; see `--game-folders`
+  HooksScan,
+  // Finding the disk usage of every artifact, as the UI shows
+  Measure,
+  // Until every step of the plan has finished; folders are usually renamed
+  // into tombstones, so this is what the user waits for
+  Removal,
+  // Until the tombstones have been deleted in the background
+  Reclaim,
+};
+constexpr std::array PhaseNames {
+  "discovery"sv,
+  "hooks-scan"sv,
+  "measure"sv,
+  "removal"sv,
+  "reclaim"sv,
+};
+
+struct Sample {
+  Clock::duration mDuration {};
+  // Files and folders handled, for throughput; empty for discovery, and
+  // the game folders checked for the hooks scan
+  WorkAmount mWork;
+};
+
+struct Iteration {
+  WorkAmount mFootprintSize;
+  std::array<Sample, PhaseNames.size()> mSamples;
+  std::size_t mFoundCount {};
+  // Steps that didn't succeed, and anything left behind
+  std::vector<std::string> mErrors;
+  FaultInjectingFileSystem::Counters mFaults;
+};
+
+struct PhaseSummary {
+  Clock::duration mMin {};
+  Clock::duration mMedian {};
+  Clock::duration mMax {};
+  // Of the median iteration; 0 if not applicable
+  double mFilesPerSecond {};
+  double mBytesPerSecond {};
+};
+
+template <class F>
+Sample Time(F&& f) {
+  const auto start = Clock::now();
+  Sample ret {.mWork = f()};
+  ret.mDuration = Clock::now() - start;
+  return ret;
+}
+
+std::vector<std::unique_ptr<Artifact>> Discover(KnownFolders& folders) {
+  folders.Expect(Locations);
+  DiscoveryScheduler scheduler {
+    MakeProbes<
+      ProgramData,
+      DCSHooks,
+      SavedGamesSettings,
+      LocalAppDataSettings,
+      LogsFolder,
+      BackupsFolder,
+      TemporaryFilesFolder>(folders),
+    std::thread::hardware_concurrency(),
+    {}};
+  scheduler.WaitForAll();
+
+  std::vector<std::unique_ptr<Artifact>> ret;
+  for (auto&& result: scheduler.TakeResults()) {
+    if (result.mStatus == DiscoveryScheduler::Status::Found) {
+      ret.push_back(std::move(result.mArtifact));
+    }
+  }
+  return ret;
+}
+
+DiskUsage MeasureDiskUsage(
+  const std::vector<std::unique_ptr<Artifact>>& artifacts) {
+  std::vector<std::filesystem::path> roots;
+  for (auto&& artifact: artifacts) {
+    std::ranges::move(
+      artifact->GetDiskUsageRoots(), std::back_inserter(roots));
+  }
+  return SizeScanner {}.Scan(roots);
+}
+
+// Returns an error for each step that did not succeed
+std::vector<std::string> Remove(
+  const std::vector<std::unique_ptr<Artifact>>& artifacts) {
+  std::vector<PlannedArtifact> planned;
+  planned.reserve(artifacts.size());
+  for (auto&& artifact: artifacts) {
+    planned.push_back({
+      .mArtifact = artifact.get(),
+      .mIsUserSettings = GetArtifactFlags(*artifact).mIsUserSettings,
+      .mAction = Action::Remove,
+    });
+  }
+  const auto plan = BuildPlan(
+    planned,
+    {
+      .mMode = CleanupMode::RemoveAll,
+      .mRemoveSettings = true,
+      .mBackUpSettings = false,
+    });
+
+  const auto steps = plan.GetSteps();
+  std::vector<Progress> progress(steps.size());
+  std::vector<Progress*> progressPointers;
+  for (auto&& it: progress) {
+    progressPointers.push_back(&it);
+  }
+  const auto results
+    = RunPlan(ArtifactTypes, plan, progressPointers, /* journal = */ nullptr);
+
+  std::vector<std::string> ret;
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    if (results[i].mOutcome != ActionScheduler::Outcome::Succeeded) {
+      ret.push_back(std::format("Failed to remove {}", steps[i].mTitle));
+    }
+  }
+  return ret;
+}
+
+void RunPhases(Iteration& iteration, KnownFolders& folders) {
+  auto& samples = iteration.mSamples;
+
+  std::vector<std::unique_ptr<Artifact>> artifacts;
+  samples.at(std::to_underlying(Phase::Discovery)) = Time([&] {
+    artifacts = Discover(folders);
+    return WorkAmount {};
+  });
+  iteration.mFoundCount = artifacts.size();
+
+  samples.at(std::to_underlying(Phase::HooksScan)) = Time([&] {
+    const auto result
+      = DCSHooksScanner {}.Scan(folders.GetRoot(KnownFolder::SavedGames));
+    return WorkAmount {.mFiles = result.mFolderTimings.size()};
+  });
+
+  samples.at(std::to_underlying(Phase::Measure)) = Time([&] {
+    const auto usage = MeasureDiskUsage(artifacts);
+    return WorkAmount {
+      .mBytes = usage.mAllocatedBytes,
+      .mFiles = usage.mFileCount,
+    };
+  });
+
+  samples.at(std::to_underlying(Phase::Removal)) = Time([&] {
+    iteration.mErrors = Remove(artifacts);
+    return iteration.mFootprintSize;
+  });
+
+  samples.at(std::to_underlying(Phase::Reclaim)) = Time([&] {
+    TombstoneReaper::Get().WaitUntilIdle();
+    return iteration.mFootprintSize;
+  });
+}
+
+Iteration RunIteration(
+  const std::filesystem::path& root,
+  const SyntheticFootprint::Options& options,
+  const std::optional<FaultInjectingFileSystem::Options>& faults) {
+  const SyntheticFootprint footprint {root, options};
+  KnownFolders folders {footprint.GetRoots()};
+  Iteration ret {.mFootprintSize = footprint.GetSize()};
+
+  if (faults) {
+    FaultInjectingFileSystem fileSystem {FileSystem::Get(), *faults};
+    {
+      const FileSystem::ScopedOverride scope {fileSystem};
+      RunPhases(ret, folders);
+    }
+    ret.mFaults = fileSystem.GetCounters();
+  } else {
+    RunPhases(ret, folders);
+  }
+
+  // Checked without faults, so that we only find what was really left
+  folders.Invalidate();
+  for (auto&& location: Locations) {
+    if (const auto path = folders.FindChild(location); !path.empty()) {
+      ret.mErrors.push_back(std::format("Left behind {}", path.string()));
+    }
+  }
+  if (DCSHooks {folders}.IsPresent()) {
+    ret.mErrors.push_back("Left behind DCS hooks");
+  }
+  // Everything should have been reaped, even if there were faults
+  std::set<std::filesystem::path> tombstones;
+  for (auto&& location: Locations) {
+    tombstones.insert(
+      folders.GetRoot(location.mRoot) / TombstoneReaper::FolderName);
+  }
+  for (auto&& path: tombstones) {
+    std::error_code ec;
+    if (std::filesystem::exists(path, ec)) {
+      ret.mErrors.push_back(std::format("Left behind {}", path.string()));
+    }
+  }
+  return ret;
+}
+
+PhaseSummary Summarize(std::vector<Sample> samples) {
+  std::ranges::sort(samples, {}, &Sample::mDuration);
+  const auto& median = samples.at(samples.size() / 2);
+
+  PhaseSummary ret {
+    .mMin = samples.front().mDuration,
+    .mMedian = median.mDuration,
+    .mMax = samples.back().mDuration,
+  };
+  const auto seconds = std::chrono::duration<double>(median.mDuration).count();
+  if (seconds > 0) {
+    ret.mFilesPerSecond = median.mWork.mFiles / seconds;
+    ret.mBytesPerSecond = median.mWork.mBytes / seconds;
+  }
+  return ret;
+}
+
+PhaseSummary Summarize(const std::vector<Iteration>& iterations, Phase phase) {
+  std::vector<Sample> samples;
+  for (auto&& it: iterations) {
+    samples.push_back(it.mSamples.at(std::to_underlying(phase)));
+  }
+  return Summarize(std::move(samples));
+}
+
+double ToMilliseconds(const Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+FaultInjectingFileSystem::Counters GetTotalFaults(
+  const std::vector<Iteration>& iterations) {
+  FaultInjectingFileSystem::Counters ret;
+  for (auto&& it: iterations) {
+    ret += it.mFaults;
+  }
+  return ret;
+}
+
+std::size_t GetErrorCount(const std::vector<Iteration>& iterations) {
+  std::size_t ret {};
+  for (auto&& it: iterations) {
+    ret += it.mErrors.size();
+  }
+  return ret;
+}
+
+void WriteText(
+  std::ostream& out,
+  const SyntheticFootprint::Options& options,
+  const std::optional<FaultInjectingFileSystem::Options>& faults,
+  const std::vector<Iteration>& iterations) {
+  const auto& size = iterations.front().mFootprintSize;
+  out << std::format(
+    "Footprint: {} game folders, {} log files, {} temporary folders deep; "
+    "{} files and folders, {}\n",
+    options.mGameFolderCount,
+    options.mLogFileCount,
+    options.mTempDepth,
+    size.mFiles,
+    FormatBytes(size.mBytes));
+  out << std::format(
+    "Iterations: {}, found {} artifacts\n\n",
+    iterations.size(),
+    iterations.front().mFoundCount);
+  out << std::format(
+    "{:<10} {:>12} {:>12} {:>12} {:>14} {:>12}\n",
+    "Phase",
+    "Median (ms)",
+    "Min (ms)",
+    "Max (ms)",
+    "Files/s",
+    "Bytes/s");
+  for (std::size_t i = 0; i < PhaseNames.size(); ++i) {
+    const auto summary = Summarize(iterations, static_cast<Phase>(i));
+    out << std::format(
+      "{:<10} {:>12.2f} {:>12.2f} {:>12.2f} {:>14.0f} {:>12}\n",
+      PhaseNames[i],
+      ToMilliseconds(summary.mMedian),
+      ToMilliseconds(summary.mMin),
+      ToMilliseconds(summary.mMax),
+      summary.mFilesPerSecond,
+      FormatBytes(static_cast<std::uint64_t>(summary.mBytesPerSecond)));
+  }
+
+  if (!faults) {
+    return;
+  }
+  const auto total = GetTotalFaults(iterations);
+  out << std::format(
+    "\nInjected faults (seed {}): {} calls, {} sharing violations, "
+    "{} access denied, {} disappeared, {:.2f} ms added latency\n",
+    faults->mSeed,
+    total.mCalls,
+    total.mSharingViolations,
+    total.mAccessDenied,
+    total.mDisappeared,
+    ToMilliseconds(total.mAddedLatency));
+  out << std::format("Errors: {}\n", GetErrorCount(iterations));
+}
+
+void WriteJSON(
+  std::ostream& out,
+  const SyntheticFootprint::Options& options,
+  const std::optional<FaultInjectingFileSystem::Options>& faults,
+  const std::vector<Iteration>& iterations) {
+  const auto& size = iterations.front().mFootprintSize;
+  out << std::format(
+    R"({{"schemaVersion":{},"gameFolders":{},"logFiles":{},"tempDepth":{},)"
+    R"("files":{},"bytes":{},"iterations":{},"artifacts":{},"phases":{{)",
+    ResultsSchemaVersion,
+    options.mGameFolderCount,
+    options.mLogFileCount,
+    options.mTempDepth,
+    size.mFiles,
+    size.mBytes,
+    iterations.size(),
+    iterations.front().mFoundCount);
+  for (std::size_t i = 0; i < PhaseNames.size(); ++i) {
+    const auto summary = Summarize(iterations, static_cast<Phase>(i));
+    out << (i ? "," : "");
+    WriteJSONString(out, PhaseNames[i]);
+    out << std::format(
+      R"(:{{"medianMs":{:.3f},"minMs":{:.3f},"maxMs":{:.3f},)"
+      R"("filesPerSecond":{:.0f},"bytesPerSecond":{:.0f}}})",
+      ToMilliseconds(summary.mMedian),
+      ToMilliseconds(summary.mMin),
+      ToMilliseconds(summary.mMax),
+      summary.mFilesPerSecond,
+      summary.mBytesPerSecond);
+  }
+  out << std::format(R"(}},"errors":{})", GetErrorCount(iterations));
+  if (faults) {
+    const auto total = GetTotalFaults(iterations);
+    out << std::format(
+      R"(,"faults":{{"seed":{},"calls":{},"sharingViolations":{},)"
+      R"("accessDenied":{},"disappeared":{},"addedLatencyMs":{:.3f}}})",
+      faults->mSeed,
+      total.mCalls,
+      total.mSharingViolations,
+      total.mAccessDenied,
+      total.mDisappeared,
+      ToMilliseconds(total.mAddedLatency));
+  }
+  out << '}' << std::endl;
+}
+
+// Files per folder, and folders per parent folder, in `CreateTree()`
+constexpr std::size_t TreeFanOut = 100;
+constexpr std::array DefaultTreeSizes {
+  std::size_t {10'000},
+  std::size_t {100'000},
+  std::size_t {1'000'000},
+};
+
+enum class DeleteMethod {
+  ParallelDelete,
+  RemoveAll,
+};
+constexpr std::array DeleteMethodNames {
+  "parallel"sv,
+  "remove_all"sv,
+};
+
+struct TreeResult {
+  std::size_t mFileCount {};
+  WorkAmount mTreeSize;
+  // Indexed by `DeleteMethod`, then iteration
+  std::array<std::vector<Sample>, DeleteMethodNames.size()> mSamples;
+  std::vector<std::string> mErrors;
+};
+
+// `fileCount` small files, `TreeFanOut` to a folder, with `TreeFanOut`
+// folders in each parent folder
+WorkAmount CreateTree(
+  const std::filesystem::path& root,
+  const std::size_t fileCount) {
+  constexpr std::string_view Content {"OpenKneeboard footprint-benchmark\n"};
+  WorkAmount ret {.mFiles = 1};
+  std::filesystem::create_directories(root);
+
+  std::filesystem::path folder;
+  for (std::size_t i = 0; i < fileCount; ++i) {
+    const auto folderIndex = i / TreeFanOut;
+    if (i % TreeFanOut == 0) {
+      const auto parent = root / std::format("{}", folderIndex / TreeFanOut);
+      if (folderIndex % TreeFanOut == 0) {
+        std::filesystem::create_directory(parent);
+        ret += {.mFiles = 1};
+      }
+      folder = parent / std::format("{}", folderIndex % TreeFanOut);
+      std::filesystem::create_directory(folder);
+      ret += {.mFiles = 1};
+    }
+    const auto path = folder / std::format("{}.txt", i % TreeFanOut);
+    std::ofstream file {path, std::ios::binary};
+    file << Content;
+    if (!file) {
+      throw std::filesystem::filesystem_error(
+        "Failed to create file",
+        path,
+        std::make_error_code(std::errc::io_error));
+    }
+    ret += {.mBytes = Content.size(), .mFiles = 1};
+  }
+  return ret;
+}
+
+// Returns an error message if anything was left behind
+std::optional<std::string> DeleteTree(
+  const DeleteMethod method,
+  const std::filesystem::path& root) {
+  std::error_code ec;
+  switch (method) {
+    case DeleteMethod::ParallelDelete: {
+      const auto result = ParallelDelete {}.Remove(root);
+      if (!result.mErrors.empty()) {
+        ec = result.mErrors.front().mError;
+      }
+      break;
+    }
+    case DeleteMethod::RemoveAll:
+      std::filesystem::remove_all(root, ec);
+      break;
+  }
+  const auto name = DeleteMethodNames.at(std::to_underlying(method));
+  if (ec) {
+    return std::format("{} failed: {}", name, ec.message());
+  }
+  if (std::filesystem::exists(root, ec)) {
+    return std::format("{} left behind {}", name, root.string());
+  }
+  return std::nullopt;
+}
+
+TreeResult RunTree(
+  const std::filesystem::path& folder,
+  const std::size_t fileCount,
+  const std::size_t iterationCount) {
+  TreeResult ret {.mFileCount = fileCount};
+  for (std::size_t i = 0; i < iterationCount; ++i) {
+    // Alternated, so that neither always gets the warmer cache
+    for (std::size_t j = 0; j < DeleteMethodNames.size(); ++j) {
+      const auto method
+        = static_cast<DeleteMethod>((i + j) % DeleteMethodNames.size());
+      const auto root = folder / std::format("tree-{}-{}", fileCount, i);
+      ret.mTreeSize = CreateTree(root, fileCount);
+      ret.mSamples.at(std::to_underlying(method)).push_back(Time([&] {
+        if (const auto error = DeleteTree(method, root)) {
+          ret.mErrors.push_back(*error);
+        }
+        return ret.mTreeSize;
+      }));
+      std::error_code ec;
+      std::filesystem::remove_all(root, ec);
+    }
+  }
+  return ret;
+}
+
+void WriteTreesText(std::ostream& out, const std::vector<TreeResult>& trees) {
+  out << std::format(
+    "Iterations: {}\n\n", trees.front().mSamples.front().size());
+  out << std::format(
+    "{:>10} {:<12} {:>12} {:>12} {:>12} {:>14}\n",
+    "Files",
+    "Method",
+    "Median (ms)",
+    "Min (ms)",
+    "Max (ms)",
+    "Files/s");
+  for (auto&& tree: trees) {
+    for (std::size_t i = 0; i < DeleteMethodNames.size(); ++i) {
+      const auto summary = Summarize(tree.mSamples.at(i));
+      out << std::format(
+        "{:>10} {:<12} {:>12.2f} {:>12.2f} {:>12.2f} {:>14.0f}\n",
+        tree.mFileCount,
+        DeleteMethodNames[i],
+        ToMilliseconds(summary.mMedian),
+        ToMilliseconds(summary.mMin),
+        ToMilliseconds(summary.mMax),
+        summary.mFilesPerSecond);
+    }
+  }
+}
+
+void WriteTreesJSON(std::ostream& out, const std::vector<TreeResult>& trees) {
+  out << std::format(
+    R"({{"schemaVersion":{},"iterations":{},"trees":[)",
+    ResultsSchemaVersion,
+    trees.front().mSamples.front().size());
+  for (std::size_t i = 0; i < trees.size(); ++i) {
+    const auto& tree = trees[i];
+    out << std::format(
+      R"({}{{"files":{},"filesAndFolders":{},"bytes":{},"methods":{{)",
+      i ? "," : "",
+      tree.mFileCount,
+      tree.mTreeSize.mFiles,
+      tree.mTreeSize.mBytes);
+    for (std::size_t j = 0; j < DeleteMethodNames.size(); ++j) {
+      const auto summary = Summarize(tree.mSamples.at(j));
+      out << (j ? "," : "");
+      WriteJSONString(out, DeleteMethodNames[j]);
+      out << std::format(
+        R"(:{{"medianMs":{:.3f},"minMs":{:.3f},"maxMs":{:.3f},)"
+        R"("filesPerSecond":{:.0f}}})",
+        ToMilliseconds(summary.mMedian),
+        ToMilliseconds(summary.mMin),
+        ToMilliseconds(summary.mMax),
+        summary.mFilesPerSecond);
+    }
+    out << std::format(R"(}},"errors":{}}})", tree.mErrors.size());
+  }
+  out << "]}" << std::endl;
+}
+
+// Comma-separated counts; empty if any are invalid
+std::vector<std::size_t> ParseCounts(std::string_view value) {
+  std::vector<std::size_t> ret;
+  while (!value.empty()) {
+    const auto comma = value.find(',');
+    const auto count = std::strtoull(
+      std::string {value.substr(0, comma)}.c_str(), nullptr, 10);
+    if (count == 0) {
+      return {};
+    }
+    ret.push_back(count);
+    value = (comma == std::string_view::npos) ? std::string_view {}
+                                              : value.substr(comma + 1);
+  }
+  return ret;
+}
+
+void ShowUsage(std::ostream& out) {
+  out << "Usage: footprint-benchmark [--json] [--iterations=N]\n"
+         "         [--game-folders=N] [--log-files=N] [--temp-depth=N]\n"
+         "         [--folder=PATH]\n"
+         "         [--latency-us=[OPERATION:]N] [--jitter-us=N]\n"
+         "         [--sharing-violations=RATE] [--access-denied=RATE]\n"
+         "         [--disappear=RATE] [--seed=N]\n"
+         "       footprint-benchmark --delete-trees[=N,...] [--json]\n"
+         "         [--iterations=N] [--folder=PATH]\n"
+         "\n"
+         "Creates OpenKneeboard-like files in a temporary folder, or PATH,\n"
+         "then times finding and removing them.\n"
+         "\n"
+         "The other options make the filesystem slow or unreliable while\n"
+         "finding and removing; RATE is a probability for each call, from 0\n"
+         "to 1. OPERATION is one of: exists, list, stat, remove, rename, or\n"
+         "mkdir; if omitted, the latency is added to all of them.\n"
+         "\n"
+         "--delete-trees instead times removing trees of N small files with\n"
+         "ParallelDelete, and with std::filesystem::remove_all(); by default,\n"
+         "10000, 100000, and 1000000 files.\n";
+}
+
+std::optional<std::size_t> ParseCount(
+  const std::string_view arg,
+  const std::string_view prefix) {
+  if (!arg.starts_with(prefix)) {
+    return std::nullopt;
+  }
+  return std::strtoull(
+    std::string {arg.substr(prefix.size())}.c_str(), nullptr, 10);
+}
+
+std::optional<double> ParseRate(
+  const std::string_view arg,
+  const std::string_view prefix) {
+  if (!arg.starts_with(prefix)) {
+    return std::nullopt;
+  }
+  return std::strtod(std::string {arg.substr(prefix.size())}.c_str(), nullptr);
+}
+
+// `N`, or `OPERATION:N`; false if the operation is unknown
+bool ParseLatency(
+  const std::string_view value,
+  FaultInjectingFileSystem::Options& options) {
+  const auto colon = value.find(':');
+  const auto count = (colon == std::string_view::npos)
+    ? value
+    : value.substr(colon + 1);
+  const std::chrono::microseconds latency {
+    std::strtoll(std::string {count}.c_str(), nullptr, 10)};
+  if (colon == std::string_view::npos) {
+    options.mLatency.fill(latency);
+    return true;
+  }
+
+  const auto& names = FaultInjectingFileSystem::OperationNames;
+  const auto it = std::ranges::find(names, value.substr(0, colon));
+  if (it == names.end()) {
+    return false;
+  }
+  options.mLatency.at(it - names.begin()) = latency;
+  return true;
+}
+}// namespace
+
+int main(int argc, char** argv) {
+  bool json = false;
+  std::size_t iterationCount = 5;
+  SyntheticFootprint::Options options;
+  std::filesystem::path folder;
+  std::optional<FaultInjectingFileSystem::Options> faults;
+  std::vector<std::size_t> treeSizes;
+  const auto faultOptions = [&faults]() -> auto& {
+    return faults ? *faults : faults.emplace();
+  };
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg {argv[i]};
+    if (arg == "--help" || arg == "-h") {
+      ShowUsage(std::cout);
+      return EXIT_SUCCESS;
+    }
+    if (arg == "--json") {
+      json = true;
+    } else if (const auto it = ParseCount(arg, "--iterations=")) {
+      iterationCount = *it;
+    } else if (const auto it = ParseCount(arg, "--game-folders=")) {
+      options.mGameFolderCount = *it;
+    } else if (const auto it = ParseCount(arg, "--log-files=")) {
+      options.mLogFileCount = *it;
+    } else if (const auto it = ParseCount(arg, "--temp-depth=")) {
+      options.mTempDepth = *it;
+    } else if (arg.starts_with("--folder=")) {
+      folder = arg.substr(std::string_view {"--folder="}.size());
+    } else if (arg == "--delete-trees") {
+      treeSizes.assign(DefaultTreeSizes.begin(), DefaultTreeSizes.end());
+    } else if (arg.starts_with("--delete-trees=")) {
+      treeSizes
+        = ParseCounts(arg.substr(std::string_view {"--delete-trees="}.size()));
+      if (treeSizes.empty()) {
+        ShowUsage(std::cerr);
+        return 2;
+      }
+    } else if (arg.starts_with("--latency-us=")) {
+      const auto value = arg.substr(std::string_view {"--latency-us="}.size());
+      if (!ParseLatency(value, faultOptions())) {
+        ShowUsage(std::cerr);
+        return 2;
+      }
+    } else if (const auto it = ParseCount(arg, "--jitter-us=")) {
+      faultOptions().mJitter = std::chrono::microseconds {*it};
+    } else if (const auto it = ParseRate(arg, "--sharing-violations=")) {
+      faultOptions().mSharingViolationRate = *it;
+    } else if (const auto it = ParseRate(arg, "--access-denied=")) {
+      faultOptions().mAccessDeniedRate = *it;
+    } else if (const auto it = ParseRate(arg, "--disappear=")) {
+      faultOptions().mDisappearanceRate = *it;
+    } else if (const auto it = ParseCount(arg, "--seed=")) {
+      faultOptions().mSeed = *it;
+    } else {
+      ShowUsage(std::cerr);
+      return 2;
+    }
+  }
+  if (iterationCount == 0) {
+    ShowUsage(std::cerr);
+    return 2;
+  }
+  if (folder.empty()) {
+    folder = std::filesystem::temp_directory_path()
+      / std::format("footprint-benchmark-{}",
+                    Clock::now().time_since_epoch().count());
+  }
+
+  if (!treeSizes.empty()) {
+    if (faults) {
+      ShowUsage(std::cerr);
+      return 2;
+    }
+    std::vector<TreeResult> trees;
+    bool failed = false;
+    try {
+      for (auto&& size: treeSizes) {
+        trees.push_back(RunTree(folder, size, iterationCount));
+        for (auto&& error: trees.back().mErrors) {
+          std::cerr << std::format("{} files: {}\n", size, error);
+          failed = true;
+        }
+      }
+    } catch (const std::exception& e) {
+      std::cerr << std::format("Failed: {}\n", e.what());
+      return EXIT_FAILURE;
+    }
+    std::error_code ec;
+    std::filesystem::remove_all(folder, ec);
+
+    if (json) {
+      WriteTreesJSON(std::cout, trees);
+    } else {
+      WriteTreesText(std::cout, trees);
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+
+  std::vector<Iteration> iterations;
+  bool failed = false;
+  try {
+    for (std::size_t i = 0; i < iterationCount; ++i) {
+      const auto root = folder / std::format("{}", i);
+      // Different faults each time, but reproducible
+      auto iterationFaults = faults;
+      if (iterationFaults) {
+        iterationFaults->mSeed += i;
+      }
+      iterations.push_back(RunIteration(root, options, iterationFaults));
+      for (auto&& error: iterations.back().mErrors) {
+        std::cerr << std::format("Iteration {}: {}\n", i, error);
+        failed = true;
+      }
+      std::filesystem::remove_all(root);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << std::format("Failed: {}\n", e.what());
+    return EXIT_FAILURE;
+  }
+  std::error_code ec;
+  std::filesystem::remove_all(folder, ec);
+
+  if (json) {
+    WriteJSON(std::cout, options, faults, iterations);
+  } else {
+    WriteText(std::cout, options, faults, iterations);
+  }
+  // Access denied can't be worked around, so errors are expected; any other
+  // fault should be handled without leaving anything behind
+  if (faults && faults->mAccessDeniedRate > 0) {
+    return EXIT_SUCCESS;
+  }
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -1,4 +1,8 @@
 #include <Windows.h>
+#include <ShObjIdl_core.h>
+#include <shellapi.h>
+#include <wil/com.h>
+#include <wil/resource.h>
 #include <winrt/base.h>
 
 #include <FredEmmott/GUI.hpp>
@@ -7,137 +11,90 @@
 #include <FredEmmott/GUI/StaticTheme/ComboBox.hpp>
 #include <FredEmmott/GUI/StaticTheme/Common.hpp>
 #include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <format>
 #include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
 #include <ranges>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
 
-#include "artifacts/BackupsFolder.hpp"
-#include "artifacts/DCSHooks.hpp"
-#include "artifacts/HKCULayer.hpp"
-#include "artifacts/HKLMLayer.hpp"
-#include "artifacts/LocalAppDataSettings.hpp"
-#include "artifacts/LogsFolder.hpp"
-#include "artifacts/MSIInstallation.hpp"
-#include "artifacts/MSIXInstallation.hpp"
-#include "artifacts/MultipleMSIInstallations.hpp"
-#include "artifacts/ProgramData.hpp"
-#include "artifacts/SavedGamesSettings.hpp"
-#include "artifacts/TemporaryFilesFolder.hpp"
+#include "ActionScheduler.hpp"
+#include "ArtifactRegistry.hpp"
+#include "BackupArchive.hpp"
+#include "ChangeWatcher.hpp"
+#include "Decisions.hpp"
+#include "DiscoveryScheduler.hpp"
+#include "DiskUsageCache.hpp"
+#include "EventChannel.hpp"
+#include "Headless.hpp"
+#include "InstallerInventory.hpp"
+#include "Instrumentation.hpp"
+#include "KnownFolders.hpp"
+#include "Plan.hpp"
+#include "PlanRunner.hpp"
+#include "Progress.hpp"
+#include "RegistryProbe.hpp"
+#include "RunJournal.hpp"
+#include "TombstoneReaper.hpp"
 #include "config.hpp"
 #include "licenses.hpp"
 
 using namespace FredEmmott::GUI;
 using namespace FredEmmott::GUI::Immediate;
+using namespace std::chrono_literals;
 using namespace std::string_view_literals;
 
-enum class CleanupMode {
-  Repair,
-  RemoveAll,
-  Custom,
-};
-CleanupMode gCleanupMode = CleanupMode::Repair;
-bool gRemoveSettings = false;
-
-enum class Action {
-  Ignore,
-  Repair,
-  Remove,
-};
+CleanupOptions gOptions;
 
 struct ArtifactState {
   ArtifactState() = delete;
-  explicit ArtifactState(std::unique_ptr<Artifact> artifact)
-    : mArtifact(std::move(artifact)) {
-    mSelectedAction = GetDefaultAction();
+  ArtifactState(std::size_t discoveryIndex, std::unique_ptr<Artifact> artifact)
+    : mDiscoveryIndex(discoveryIndex),
+      mArtifact(std::move(artifact)) {
+    mSelectedAction = GetFlags().mDefaultAction;
   }
 
   auto operator->() const {
     return mArtifact.get();
   }
 
+  // Does not include presence; see `ArtifactTable`
   [[nodiscard]]
-  bool IsUserSettings() const {
-    return mArtifact->GetKind() == Artifact::Kind::UserSettings;
-  }
-
-  [[nodiscard]]
-  bool CanRepair() const {
-    const auto it = dynamic_cast<const RepairableArtifact*>(mArtifact.get());
-    return it && it->CanRepair();
-  }
-
-  [[nodiscard]]
-  bool IsOutdated() const {
-    return mArtifact->GetRemovedVersion().has_value();
-  }
-
-  std::optional<std::tuple<Action, std::function<void()>>> GetExecutor() {
-    if (!mArtifact->IsPresent()) {
-      return std::nullopt;
-    }
-
-    switch (gCleanupMode) {
-      case CleanupMode::Repair:
-        if (
-          const auto it = dynamic_cast<RepairableArtifact*>(mArtifact.get()); it && it->CanRepair()) {
-          return {{Action::Repair, [it] { it->Repair(); }}};
-        }
-        if (this->IsOutdated() && !this->IsUserSettings()) {
-          return {{Action::Remove, [it = mArtifact.get()] { it->Remove(); }}};
-        }
-        if (mArtifact->GetKind() == Artifact::Kind::TemporaryFiles) {
-          return {{Action::Remove, [it = mArtifact.get()] { it->Remove(); }}};
-        }
-        return std::nullopt;
-      case CleanupMode::RemoveAll:
-        if (gRemoveSettings || !this->IsUserSettings()) {
-          return {{Action::Remove, [it = mArtifact.get()] { it->Remove(); }}};
-        }
-        return std::nullopt;
-      case CleanupMode::Custom:
-        switch (mSelectedAction) {
-          case Action::Ignore:
-            return std::nullopt;
-          case Action::Repair: {
-            const auto it = dynamic_cast<RepairableArtifact*>(mArtifact.get());
-            if (it && it->CanRepair()) {
-              return {{Action::Repair, [it] { it->Repair(); }}};
-            }
-            return std::nullopt;
-          }
-          case Action::Remove:
-            return {{Action::Remove, [it = mArtifact.get()] { it->Remove(); }}};
-        }
-    }
-    std::unreachable();
+  ArtifactFlags GetFlags() const {
+    return GetArtifactFlags(*mArtifact);
   }
 
+  // What will happen to this artifact with the current options
   [[nodiscard]]
-  Action GetDefaultAction() const {
-    if (IsUserSettings()) {
-      return Action::Ignore;
-    }
-    if (CanRepair()) {
-      return Action::Repair;
-    }
-    if (IsOutdated()) {
-      return Action::Remove;
-    }
-    if (mArtifact->GetKind() == Artifact::Kind::TemporaryFiles) {
-      return Action::Remove;
-    }
-    return Action::Ignore;
+  std::optional<Action> GetPlannedAction(const ArtifactFlags& flags) const {
+    return ::GetPlannedAction(flags, gOptions, mSelectedAction);
   }
 
-  std::span<const std::tuple<Action, std::string_view>> GetOptions() const {
-    if (CanRepair()) {
+  static std::span<const std::tuple<Action, std::string_view>> GetOptions(
+    const ArtifactFlags& flags) {
+    if (flags.mCanRepair) {
       return RepairOptions;
     }
     return RemoveOptions;
   }
 
+  // Position in the probe list; used to keep a stable order as probes finish
+  std::size_t mDiscoveryIndex {};
   std::unique_ptr<Artifact> mArtifact;
   Action mSelectedAction {};
   bool mShowingDetails = false;
+  // Fetched when the details are opened
+  Artifact::Details mDetails;
 
  private:
   static constexpr auto RemoveOptions = std::array {
@@ -151,39 +108,306 @@ struct ArtifactState {
   };
 };
 
+// `ArtifactFlags` for every row in `GetArtifacts()`, stored as parallel
+// arrays, plus the summaries needed by `ShowModes()`.
+//
+// This is rebuilt at the start of a frame if it has been invalidated, e.g.
+// by new discovery results or a completed executor; otherwise, frames only
+// read from it.
+class ArtifactTable {
+ public:
+  // Thread-safe
+  void Invalidate() noexcept {
+    mDirty.store(true, std::memory_order_release);
+  }
+
+  void Update(std::span<const ArtifactState> artifacts) {
+    if (!mDirty.exchange(false, std::memory_order_acq_rel)) {
+      return;
+    }
+    const Instrumentation::ScopedTimer timer {"UI", "ArtifactTable::Update"};
+
+    const auto count = artifacts.size();
+    for (auto column: {
+           &mIsPresent,
+           &mIsUserSettings,
+           &mIsOutdated,
+           &mIsTemporaryFiles,
+           &mCanRepair,
+         }) {
+      column->assign(count, false);
+    }
+    mDefaultAction.assign(count, Action::Ignore);
+    mHaveSettings = false;
+    mHaveNonSettings = false;
+    mShowRepairMode = false;
+
+    for (auto&& [i, artifact]: std::views::enumerate(artifacts)) {
+      const auto flags = artifact.GetFlags();
+      {
+        const Instrumentation::ScopedTimer timer {
+          "IsPresent", artifact->GetTitle()};
+        mIsPresent[i] = artifact->IsPresent();
+      }
+      mIsUserSettings[i] = flags.mIsUserSettings;
+      mIsOutdated[i] = flags.mIsOutdated;
+      mIsTemporaryFiles[i] = flags.mIsTemporaryFiles;
+      mCanRepair[i] = flags.mCanRepair;
+      mDefaultAction[i] = flags.mDefaultAction;
+
+      mHaveSettings |= flags.mIsUserSettings;
+      mHaveNonSettings |= !flags.mIsUserSettings;
+      mShowRepairMode
+        |= flags.mCanRepair || flags.mDefaultAction == Action::Remove;
+    }
+  }
+
+  [[nodiscard]]
+  ArtifactFlags operator[](std::size_t i) const {
+    return {
+      .mIsPresent = mIsPresent.at(i),
+      .mIsUserSettings = mIsUserSettings.at(i),
+      .mIsOutdated = mIsOutdated.at(i),
+      .mIsTemporaryFiles = mIsTemporaryFiles.at(i),
+      .mCanRepair = mCanRepair.at(i),
+      .mDefaultAction = mDefaultAction.at(i),
+    };
+  }
+
+  bool mHaveSettings {false};
+  bool mHaveNonSettings {false};
+  bool mShowRepairMode {false};
+
+ private:
+  std::atomic<bool> mDirty {true};
+
+  std::vector<bool> mIsPresent;
+  std::vector<bool> mIsUserSettings;
+  std::vector<bool> mIsOutdated;
+  std::vector<bool> mIsTemporaryFiles;
+  std::vector<bool> mCanRepair;
+  std::vector<Action> mDefaultAction;
+};
+ArtifactTable gArtifactTable;
+
+std::unique_ptr<DiscoveryScheduler> gDiscovery;
+// Sizes are only measured once an artifact has been shown
+std::unique_ptr<DiskUsageCache> gDiskUsage;
+std::vector<std::string_view> gIncompleteProbes;
+// Indexed by `ArtifactRegistry`
+std::bitset<ArtifactRegistry.size()> gFinishedProbes;
+
 auto& GetArtifacts() {
   static std::vector<ArtifactState> ret;
-  static bool initialized = false;
-  if (!std::exchange(initialized, true)) {
-    std::unique_ptr<Artifact> artifacts[] {
-      std::make_unique<MSIXInstallation>(),
-      std::make_unique<ProgramData>(),
-      std::make_unique<HKCULayer>(),
-      std::make_unique<MultipleMSIInstallations>(),
-      std::make_unique<MSIInstallation>(),
-      std::make_unique<HKLMLayer>(),
-      std::make_unique<DCSHooks>(),
-      std::make_unique<SavedGamesSettings>(),
-      std::make_unique<LocalAppDataSettings>(),
-      std::make_unique<LogsFolder>(),
-      std::make_unique<BackupsFolder>(),
-      std::make_unique<TemporaryFilesFolder>(),
-    };
-    for (auto&& it: artifacts) {
-      if (!it->IsPresent()) {
-        continue;
+  return ret;
+}
+
+void StartDiscovery(HWND window) {
+  KnownFolders::Get().Expect(FilesystemLocations);
+
+  gDiscovery = std::make_unique<DiscoveryScheduler>(
+    MakeRegistryProbes(),
+    std::thread::hardware_concurrency(),
+    [window] { InvalidateRect(window, nullptr, FALSE); });
+  gDiskUsage = std::make_unique<DiskUsageCache>(
+    [window] { InvalidateRect(window, nullptr, FALSE); });
+}
+
+// Finish deleting anything that was moved aside by a previous run
+void StartReaping(HWND window) {
+  auto& reaper = TombstoneReaper::Get();
+  reaper.SetIdleCallback(
+    [window] { InvalidateRect(window, nullptr, FALSE); });
+  auto& folders = KnownFolders::Get();
+  for (auto&& location: FilesystemLocations) {
+    const auto root = folders.GetRoot(location.mRoot);
+    if (!root.empty()) {
+      reaper.ReapLeftovers((root / location.mChild).parent_path());
+    }
+  }
+}
+
+[[nodiscard]]
+bool IsDiscoveryComplete() {
+  return gDiscovery && gDiscovery->IsComplete();
+}
+
+// Re-checks individual artifacts when the files or registry keys they use
+// change, e.g. if OpenKneeboard or an installer runs while we're open
+struct LiveDiscovery {
+  std::unique_ptr<ChangeWatcher> mWatcher;
+
+  std::mutex mMutex;
+  // Indices into `ArtifactRegistry`; guarded by `mMutex`
+  std::vector<std::size_t> mChanged;
+
+  std::unique_ptr<DiscoveryScheduler> mScheduler;
+  // The `ArtifactRegistry` index for each probe in `mScheduler`
+  std::vector<std::size_t> mIndices;
+};
+LiveDiscovery gLiveDiscovery;
+
+void WatchForChanges(std::size_t index) {
+  auto& watcher = *gLiveDiscovery.mWatcher;
+  watcher.Unwatch(index);
+  for (auto&& source: ArtifactRegistry.at(index).mChangeSources) {
+    switch (source.mKind) {
+      case ChangeSource::Kind::Folder: {
+        const auto root = KnownFolders::Get().GetRoot(source.mFolder);
+        if (root.empty()) {
+          break;
+        }
+        if (source.mPath.empty()) {
+          watcher.WatchFolder(index, root, /* recursive = */ true);
+          break;
+        }
+        // The root is watched to find out if the child is created or deleted
+        watcher.WatchFolder(index, root, /* recursive = */ false);
+        watcher.WatchFolder(index, root / source.mPath, /* recursive = */ true);
+        break;
       }
-      ret.emplace_back(std::move(it));
+      case ChangeSource::Kind::RegistryKey:
+        watcher.WatchRegistryKey(index, source.mHive, source.mPath);
+        break;
     }
   }
-  return ret;
 }
 
-void ShowArtifact(ArtifactState& artifact) {
-  const auto row
-    = BeginHStackPanel().Styled(Style().FlexGrow(1).Gap(8)).Scoped();
+void StartWatching(HWND window) {
+  gLiveDiscovery.mWatcher
+    = ChangeWatcher::Create([window](std::vector<std::size_t> changed) {
+        {
+          std::unique_lock lock(gLiveDiscovery.mMutex);
+          auto& pending = gLiveDiscovery.mChanged;
+          pending.insert(pending.end(), changed.begin(), changed.end());
+        }
+        InvalidateRect(window, nullptr, FALSE);
+      });
+  for (std::size_t i = 0; i < ArtifactRegistry.size(); ++i) {
+    WatchForChanges(i);
+  }
+}
+
+// Once we're making changes, artifacts must not be replaced underneath us
+void StopWatching() {
+  gLiveDiscovery.mWatcher.reset();
+  gLiveDiscovery.mScheduler.reset();
+  gLiveDiscovery.mIndices.clear();
+}
+
+void StartRescanIfNeeded(HWND window) {
+  auto& live = gLiveDiscovery;
+  if (live.mScheduler && !live.mScheduler->IsComplete()) {
+    // Changes will be picked up when this finishes
+    return;
+  }
+
+  {
+    std::unique_lock lock(live.mMutex);
+    std::ranges::sort(live.mChanged);
+    const auto [first, last] = std::ranges::unique(live.mChanged);
+    live.mChanged.erase(first, last);
+    live.mIndices = std::exchange(live.mChanged, {});
+  }
+  if (live.mIndices.empty()) {
+    live.mScheduler.reset();
+    return;
+  }
+
+  // Only the affected artifacts are checked, so dropping the caches is cheap
+  KnownFolders::Get().Invalidate();
+  InstallerInventory::Get().Invalidate();
+
+  std::vector<std::unique_ptr<ArtifactProbe>> probes;
+  probes.reserve(live.mIndices.size());
+  for (auto&& index: live.mIndices) {
+    probes.push_back(
+      std::make_unique<RegistryProbe>(ArtifactRegistry.at(index)));
+  }
+  live.mScheduler = std::make_unique<DiscoveryScheduler>(
+    std::move(probes),
+    std::thread::hardware_concurrency(),
+    [window] { InvalidateRect(window, nullptr, FALSE); });
+}
+
+// Adds, replaces, or removes the row for an `ArtifactRegistry` index
+void ApplyDiscoveryResult(
+  std::size_t index,
+  DiscoveryScheduler::Result&& result) {
+  auto& artifacts = GetArtifacts();
+  const auto existing
+    = std::ranges::find(artifacts, index, &ArtifactState::mDiscoveryIndex);
+
+  using enum DiscoveryScheduler::Status;
+  switch (result.mStatus) {
+    case Found:
+      if (existing != artifacts.end()) {
+        gDiskUsage->Forget(*existing->mArtifact);
+        const auto selected = existing->mSelectedAction;
+        *existing = ArtifactState {index, std::move(result.mArtifact)};
+        // Keep the user's choice, unless it's no longer offered; e.g.
+        // repair, if the artifact can no longer be repaired
+        if (std::ranges::contains(
+              ArtifactState::GetOptions(existing->GetFlags()),
+              selected,
+              [](const auto& option) { return std::get<Action>(option); })) {
+          existing->mSelectedAction = selected;
+        }
+        return;
+      }
+      artifacts.emplace(
+        std::ranges::upper_bound(
+          artifacts, index, {}, &ArtifactState::mDiscoveryIndex),
+        index,
+        std::move(result.mArtifact));
+      return;
+    case NotFound:
+      if (existing != artifacts.end()) {
+        gDiskUsage->Forget(*existing->mArtifact);
+        artifacts.erase(existing);
+      }
+      return;
+    case Failed:
+    case TimedOut:
+      // Keep whatever we knew before
+      return;
+  }
+}
+
+// Returns true if any probes finished, i.e. rows may have been added,
+// replaced, or removed, or placeholders removed
+bool UpdateArtifacts() {
+  if (!gDiscovery) {
+    return false;
+  }
+
+  bool changed = false;
+  for (auto&& result: gDiscovery->TakeResults()) {
+    gFinishedProbes.set(result.mIndex);
+    changed = true;
+    if (
+      result.mStatus == DiscoveryScheduler::Status::Failed
+      || result.mStatus == DiscoveryScheduler::Status::TimedOut) {
+      gIncompleteProbes.push_back(result.mName);
+    }
+    ApplyDiscoveryResult(result.mIndex, std::move(result));
+  }
+
+  if (gLiveDiscovery.mScheduler) {
+    for (auto&& result: gLiveDiscovery.mScheduler->TakeResults()) {
+      changed = true;
+      const auto index = gLiveDiscovery.mIndices.at(result.mIndex);
+      ApplyDiscoveryResult(index, std::move(result));
+      // Folders may have been created or removed
+      WatchForChanges(index);
+    }
+  }
+  return changed;
+}
+
+void ShowArtifactIcon(Artifact::Kind kind) {
   std::string_view icon;
-  switch (artifact->GetKind()) {
+  switch (kind) {
     case Artifact::Kind::Software:
       icon = "\uECAA";// AppIconDefault
       break;
@@ -199,6 +423,52 @@ void ShowArtifact(ArtifactState& artifact) {
   }
   FontIcon(icon, SystemFont::Subtitle)
     .Styled(Style().AlignSelf(YGAlignFlexStart));
+}
+
+// Placeholder for an artifact type that discovery hasn't checked yet
+void ShowPendingArtifact(const ArtifactDescriptor& descriptor) {
+  const auto row
+    = BeginHStackPanel().Styled(Style().FlexGrow(1).Gap(8)).Scoped();
+  ShowArtifactIcon(descriptor.mMetadata.mKind);
+  using namespace StaticTheme::Common;
+  const auto body
+    = BeginVStackPanel().Scoped().Styled(Style().FlexGrow(1).Gap(8));
+  Label(descriptor.mMetadata.mTitle)
+    .Subtitle()
+    .Styled(Style().Color(TextFillColorSecondaryBrush));
+  Label("Checking...")
+    .Body()
+    .Styled(Style().Color(TextFillColorTertiaryBrush));
+}
+
+void ShowArtifactDetails(const Artifact::Details& details) {
+  for (auto&& paragraph: details.mExplanation) {
+    TextBlock(paragraph);
+  }
+  if (!details.mSummary.empty()) {
+    Label(details.mSummary);
+  }
+  if (details.mItems.empty()) {
+    return;
+  }
+  const auto items = BeginVStackPanel().Styled(Style().Gap(4)).Scoped();
+  for (auto&& item: details.mItems) {
+    Label("• {}", item);
+  }
+}
+
+std::string FormatDiskUsage(const DiskUsage& usage) {
+  return std::format(
+    "{} in {} {}",
+    FormatBytes(usage.mAllocatedBytes),
+    usage.mFileCount,
+    usage.mFileCount == 1 ? "file" : "files");
+}
+
+void ShowArtifact(ArtifactState& artifact, const ArtifactFlags& flags) {
+  const auto row
+    = BeginHStackPanel().Styled(Style().FlexGrow(1).Gap(8)).Scoped();
+  ShowArtifactIcon(artifact->GetKind());
   using namespace StaticTheme::Common;
   {
     const auto body
@@ -222,6 +492,11 @@ void ShowArtifact(ArtifactState& artifact) {
         .Body()
         .Styled(Style().Color(TextFillColorTertiaryBrush));
     }
+    if (const auto usage = gDiskUsage->Get(*artifact.mArtifact)) {
+      Label("Using {}", FormatDiskUsage(*usage))
+        .Body()
+        .Styled(Style().Color(TextFillColorTertiaryBrush));
+    }
   }
   {
     bool clicked {false};
@@ -235,14 +510,15 @@ void ShowArtifact(ArtifactState& artifact) {
     FontIcon("\uea1f");// info2
     if (clicked) {
       artifact.mShowingDetails = true;
+      artifact.mDetails = artifact->GetDetails();
     }
   }
   if (const auto popup = BeginPopup(&artifact.mShowingDetails).Scoped()) {
     const auto layout
       = BeginVStackPanel().Scoped().Styled(Style().Gap(12).Margin(8));
-    artifact.mArtifact->DrawCardContent();
+    ShowArtifactDetails(artifact.mDetails);
   }
-  ComboBox(&artifact.mSelectedAction, artifact.GetOptions())
+  ComboBox(&artifact.mSelectedAction, ArtifactState::GetOptions(flags))
     .Styled(Style().Width(120));
 }
 struct Executor {
@@ -250,115 +526,552 @@ struct Executor {
     Pending,
     InProgress,
     Complete,
+    TimedOut,
+    Cancelled,
   };
 
   std::string_view mTitle;
-  Action mAction;
-  std::function<void()> mExecutor;
+  Plan::Action mAction {};
+  // Owned by the plan passed to `GetExecutors()`
+  const Plan::Step* mStep {nullptr};
+  // Heap-allocated as `Progress` is not movable
+  std::unique_ptr<Progress> mProgress;
+  // Only accessed by the UI thread; see `gExecutorEvents`
   State mState {State::Pending};
+
+  [[nodiscard]] bool IsDone() const {
+    return mState != State::Pending && mState != State::InProgress;
+  }
 };
 
-std::vector<Executor> GetExecutors() {
-  std::vector<Executor> ret;
-  for (auto&& artifact: GetArtifacts()) {
-    if (auto it = artifact.GetExecutor()) {
-      auto&& [action, executor] = *it;
-      ret.emplace_back(
-        Executor {
-          .mTitle = artifact->GetTitle(),
-          .mAction = action,
-          .mExecutor = std::move(executor),
-        });
+// Parent of every `Executor::mProgress`
+Progress gOverallProgress;
+
+struct ExecutorEvent {
+  std::size_t mIndex {};
+  ActionScheduler::Event mEvent {};
+};
+// From `ExecutorThread()`'s workers to the UI thread, which owns
+// `Executor::mState`
+std::unique_ptr<EventChannel<ExecutorEvent>> gExecutorEvents;
+// Stopped by the 'Cancel' button in `ShowProgress()`
+std::stop_source gExecutorStop;
+// Null if the journal couldn't be created; see `CreateJournal()`
+std::unique_ptr<RunJournal> gJournal;
+
+// Everything is decided here, on the UI thread; nothing looks at the
+// artifacts again once the plan is built
+Plan BuildPlan() {
+  std::vector<PlannedArtifact> planned;
+  for (auto&& [i, artifact]: std::views::enumerate(GetArtifacts())) {
+    const auto flags = gArtifactTable[i];
+    const auto action = artifact.GetPlannedAction(flags);
+    if (!action) {
+      continue;
+    }
+    PlannedArtifact it {
+      .mArtifact = artifact.mArtifact.get(),
+      .mIsUserSettings = flags.mIsUserSettings,
+      .mAction = *action,
+    };
+    // We've usually already measured folders
+    if (const auto usage = gDiskUsage->Get(*artifact.mArtifact)) {
+      it.mKnownSize = WorkAmount {
+        .mBytes = usage->mAllocatedBytes,
+        .mFiles = usage->mFileCount,
+      };
     }
+    planned.push_back(std::move(it));
+  }
+  return BuildPlan(planned, gOptions);
+}
+
+// `plan` must outlive the executors
+std::vector<Executor> GetExecutors(const Plan& plan) {
+  std::vector<Executor> ret;
+  ret.reserve(plan.GetSteps().size());
+  for (auto&& step: plan.GetSteps()) {
+    auto& executor = ret.emplace_back(
+      Executor {
+        .mTitle = step.mTitle,
+        .mAction = step.mAction,
+        .mStep = &step,
+        .mProgress = std::make_unique<Progress>(&gOverallProgress),
+      });
+    // Known up front, so the overall total is right from the start
+    executor.mProgress->AddToTotal(plan.GetEstimate(step));
   }
   return ret;
 }
 
-void ExecutorThread(std::vector<Executor>& executors, HWND window) {
+// Progress changes far more often than we want to redraw, so redraw
+// periodically until the returned thread is destroyed
+std::jthread StartRedrawing(HWND window) {
+  return std::jthread([window](std::stop_token stop) {
+    std::mutex mutex;
+    std::condition_variable_any cv;
+    std::unique_lock lock(mutex);
+    while (!stop.stop_requested()) {
+      InvalidateRect(window, nullptr, FALSE);
+      cv.wait_for(lock, stop, 250ms, [] { return false; });
+    }
+  });
+}
+
+// Schedules the actions; they do their own work on `ThreadPool::GetShared()`,
+// or asynchronously
+void ExecutorThread(
+  const Plan& plan,
+  std::vector<Executor>& executors,
+  HWND window) {
+  const auto redraw = StartRedrawing(window);
+
+  gOverallProgress.Start();
+  // Executors and plan steps have the same indices
+  std::vector<Progress*> progress;
+  progress.reserve(executors.size());
   for (auto&& it: executors) {
-    it.mState = Executor::State::InProgress;
-    UpdateWindow(window);
+    progress.push_back(it.mProgress.get());
+  }
+  const auto results = RunPlan(
+    ArtifactRegistry,
+    plan,
+    progress,
+    gJournal.get(),
+    [](auto index, auto event) {
+      // Callbacks never run concurrently, so they can share a producer
+      gExecutorEvents->Push(0, {index, event});
+    },
+    gExecutorStop.get_token());
 
-    it.mExecutor();
-    // The MSI API in particular likes to give away focus when it's done
-    SetForegroundWindow(window);
+  // Don't claim the total was reached if anything was stopped early
+  if (std::ranges::all_of(results, [](const auto& it) {
+        using enum ActionScheduler::Outcome;
+        return it.mOutcome == Succeeded || it.mOutcome == Failed;
+      })) {
+    gOverallProgress.Complete();
+  } else {
+    gOverallProgress.Stop();
+  }
+  // Even if cancelled or incomplete, the user has seen how it ended, so
+  // there's nothing to resume
+  if (gJournal) {
+    gJournal->Complete();
+  }
+  InvalidateRect(window, nullptr, FALSE);
+}
 
-    it.mState = Executor::State::Complete;
-    UpdateWindow(window);
+// Kept apart from OpenKneeboard's own folders, as they may be removed
+std::filesystem::path GetJournalPath() {
+  const auto root = KnownFolders::Get().GetRoot(KnownFolder::LocalAppData);
+  if (root.empty()) {
+    return {};
   }
+  return root / L"OpenKneeboard Fresh Start" / L"Cleanup.journal";
 }
 
-void ShowProgress(const std::vector<Executor>& executors) {
-  const auto allComplete = std::ranges::all_of(executors, [](const auto& it) {
-    return it.mState == Executor::State::Complete;
+// The run goes ahead even if this fails; it just can't be resumed
+std::unique_ptr<RunJournal> CreateJournal(const Plan& plan) {
+  const auto path = GetJournalPath();
+  if (path.empty()) {
+    return nullptr;
+  }
+  try {
+    std::filesystem::create_directories(path.parent_path());
+    return std::make_unique<RunJournal>(path, plan);
+  } catch (const std::filesystem::filesystem_error&) {
+    return nullptr;
+  }
+}
+
+// What's left of a run that was interrupted, e.g. by a restart; nullopt if
+// the last run finished. Unreadable journals are discarded.
+std::optional<Plan> GetInterruptedPlan() {
+  const auto path = GetJournalPath();
+  if (path.empty()) {
+    return std::nullopt;
+  }
+  if (const auto recovery = RunJournal::Recover(path)) {
+    auto plan = recovery->GetRemainingPlan();
+    if (
+      !plan.GetSteps().empty()
+      && std::ranges::all_of(plan.GetSteps(), [](const auto& step) {
+           return IsKnownStep(ArtifactRegistry, step);
+         })) {
+      return plan;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  return std::nullopt;
+}
+
+// Called once per frame
+void ApplyExecutorEvents(std::vector<Executor>& executors, HWND window) {
+  gExecutorEvents->Drain([&executors, window](ExecutorEvent&& event) {
+    auto& it = executors.at(event.mIndex);
+    switch (event.mEvent) {
+      case ActionScheduler::Event::Started:
+        it.mState = Executor::State::InProgress;
+        break;
+      case ActionScheduler::Event::Finished:
+        // The MSI API in particular likes to give away focus when it's done
+        SetForegroundWindow(window);
+        it.mState = Executor::State::Complete;
+        gArtifactTable.Invalidate();
+        break;
+      case ActionScheduler::Event::TimedOut:
+        it.mState = Executor::State::TimedOut;
+        gArtifactTable.Invalidate();
+        break;
+      case ActionScheduler::Event::Cancelled:
+        it.mState = Executor::State::Cancelled;
+        gArtifactTable.Invalidate();
+        break;
+    }
   });
+}
+
+// FUI doesn't have a progress bar yet
+void ShowProgressBar(const Progress::Snapshot& snapshot) {
+  constexpr auto Width = 240.0f;
+  const auto track = BeginHStackPanel().Scoped().Styled(
+    Style()
+      .BackgroundColor(StaticTheme::Common::ControlStrongFillColorDefaultBrush)
+      .Height(4)
+      .Width(Width));
+  const auto fraction = snapshot.GetFraction().value_or(0);
+  const auto fill = BeginHStackPanel().Scoped().Styled(
+    Style()
+      .BackgroundColor(StaticTheme::Common::AccentFillColorDefaultBrush)
+      .Height(4)
+      .Width(static_cast<float>(Width * fraction)));
+}
+
+// Nothing for actions that don't touch files, e.g. uninstallers
+void ShowProgressDetails(const Progress::Snapshot& snapshot) {
+  const auto text = FormatProgress(snapshot);
+  if (text.empty()) {
+    return;
+  }
+  ShowProgressBar(snapshot);
+  Label("{}", text).Caption();
+}
+
+void ShowExecutorHeader(const Executor& it) {
+  const auto row = BeginHStackPanel().Scoped();
+  using enum Plan::Action;
+  switch (it.mAction) {
+    case Repair:
+      FontIcon("\ue90f");// Repair
+      break;
+    case Remove:
+      FontIcon("\ue74d");// delete
+      break;
+    case Backup:
+      FontIcon("\ue74e");// Save
+      break;
+  }
+
+  Label(it.mTitle).Styled(Style().FlexGrow(1).MarginRight(16));
+
+  using enum Executor::State;
+  switch (it.mState) {
+    case Pending:
+      // Checkbox glyph
+      FontIcon("\ue739").Styled(Style().AlignSelf(YGAlignFlexStart));
+      break;
+    case InProgress:
+      // TODO: replace with a ProgressRing:
+      //  https://github.com/fredemmott/FUI/issues/62
+      // ProgressRingDots glyph
+      FontIcon("\uf16a").Styled(Style().AlignSelf(YGAlignFlexStart));
+      break;
+    case Complete:
+      // CheckboxComposite
+      FontIcon("\ue73a").Styled(Style().AlignSelf(YGAlignFlexStart));
+      break;
+    case TimedOut:
+      Label("Timed out").Caption().Styled(Style().MarginRight(8));
+      // Clock
+      FontIcon("\ue121").Styled(Style().AlignSelf(YGAlignFlexStart));
+      break;
+    case Cancelled:
+      Label("Cancelled").Caption().Styled(Style().MarginRight(8));
+      // Cancel
+      FontIcon("\ue711").Styled(Style().AlignSelf(YGAlignFlexStart));
+      break;
+  }
+}
+
+void ShowProgress(const std::vector<Executor>& executors) {
+  const auto allDone = std::ranges::all_of(executors, &Executor::IsDone);
 
   const auto dialog = BeginContentDialog().Scoped();
-  if (allComplete) {
-    ContentDialogTitle("Cleanup complete");
-  } else {
+  if (!allDone) {
     ContentDialogTitle("Applying changes...");
+  } else if (gExecutorStop.stop_requested()) {
+    ContentDialogTitle("Cleanup cancelled");
+  } else {
+    ContentDialogTitle("Cleanup complete");
   }
 
   for (auto&& [i, it]: std::views::enumerate(executors)) {
-    const auto row = BeginHStackPanel(ID {i}).Scoped().Styled(
+    const auto row = BeginVStackPanel(ID {i}).Scoped().Styled(
       Style()
         .Color(StaticTheme::Common::TextFillColorSecondaryBrush)
+        .Gap(4)
         .PaddingLeft(8));
-    using enum Action;
-    switch (it.mAction) {
-      case Ignore:
-        throw std::logic_error("Can't take an 'ignore' action");
-      case Repair:
-        FontIcon("\ue90f");// Repair
-        break;
-      case Remove:
-        FontIcon("\ue74d");// delete
-        break;
+    ShowExecutorHeader(it);
+    ShowProgressDetails(it.mProgress->GetSnapshot());
+  }
+
+  if (const auto overall = gOverallProgress.GetSnapshot();
+      !FormatProgress(overall).empty()) {
+    const auto layout
+      = BeginVStackPanel().Scoped().Styled(Style().Gap(4).MarginTop(12));
+    Label("Total");
+    ShowProgressDetails(overall);
+  }
+
+  if (allDone && TombstoneReaper::Get().IsBusy()) {
+    TextBlock(
+      "Removed folders are still being deleted in the background. If you "
+      "close this window, this will continue the next time OpenKneeboard "
+      "Fresh Start is run.")
+      .Caption()
+      .Styled(Style().MarginTop(12));
+  }
+
+  const auto buttons = BeginContentDialogButtons().Scoped();
+  if (allDone) {
+    if (ContentDialogCloseButton("Close").Accent()) {
+      throw ExitException(EXIT_SUCCESS);
+    }
+    return;
+  }
+  // Running actions are asked to stop, and nothing else is started
+  const auto enabled = BeginEnabled(!gExecutorStop.stop_requested()).Scoped();
+  if (ContentDialogCloseButton("Cancel")) {
+    gExecutorStop.request_stop();
+  }
+}
+
+// Total size of everything that will be removed with the current options
+void ShowReclaimableSpace() {
+  DiskUsage total;
+  for (auto&& [i, artifact]: std::views::enumerate(GetArtifacts())) {
+    if (artifact.GetPlannedAction(gArtifactTable[i]) != Action::Remove) {
+      continue;
     }
+    if (const auto usage = gDiskUsage->Get(*artifact.mArtifact)) {
+      total += *usage;
+    }
+  }
+  if (total.mAllocatedBytes == 0) {
+    return;
+  }
 
-    Label(it.mTitle).Styled(Style().FlexGrow(1).MarginRight(16));
+  Label(
+    "{} will be freed{}",
+    FormatBytes(total.mAllocatedBytes),
+    gDiskUsage->IsMeasuring() ? " (still measuring)" : "")
+    .Caption()
+    .Styled(
+      Style()
+        .Color(StaticTheme::Common::TextFillColorSecondaryBrush)
+        .MarginTop(8));
+}
 
-    using enum Executor::State;
-    switch (it.mState) {
-      case Pending:
-        // Checkbox glyph
-        FontIcon("\ue739").Styled(Style().AlignSelf(YGAlignFlexStart));
-        break;
-      case InProgress:
-        // TODO: replace with a ProgressRing:
-        //  https://github.com/fredemmott/FUI/issues/62
-        // ProgressRingDots glyph
-        FontIcon("\uf16a").Styled(Style().AlignSelf(YGAlignFlexStart));
-        break;
-      case Complete:
-        // CheckboxComposite
-        FontIcon("\ue73a").Styled(Style().AlignSelf(YGAlignFlexStart));
-        break;
+// Empty if cancelled
+std::filesystem::path ShowPicker(
+  IFileOpenDialog* dialog,
+  HWND parent,
+  const std::filesystem::path& initial,
+  const FILEOPENDIALOGOPTIONS extraOptions) {
+  FILEOPENDIALOGOPTIONS options {};
+  THROW_IF_FAILED(dialog->GetOptions(&options));
+  THROW_IF_FAILED(
+    dialog->SetOptions(options | extraOptions | FOS_FORCEFILESYSTEM));
+  if (wil::com_ptr<IShellItem> folder; SUCCEEDED(SHCreateItemFromParsingName(
+        initial.c_str(), nullptr, IID_PPV_ARGS(folder.put())))) {
+    dialog->SetFolder(folder.get());
+  }
+  if (FAILED(dialog->Show(parent))) {
+    return {};
+  }
+  wil::com_ptr<IShellItem> result;
+  THROW_IF_FAILED(dialog->GetResult(result.put()));
+  wil::unique_cotaskmem_string path;
+  THROW_IF_FAILED(
+    result->GetDisplayName(SIGDN_FILESYSPATH, std::out_ptr(path)));
+  return std::filesystem::path {std::wstring_view {path.get()}};
+}
+
+// Empty if cancelled
+std::filesystem::path PickFolder(
+  HWND parent,
+  const std::filesystem::path& initial) {
+  const auto dialog
+    = wil::CoCreateInstance<IFileOpenDialog>(CLSID_FileOpenDialog);
+  return ShowPicker(dialog.get(), parent, initial, FOS_PICKFOLDERS);
+}
+
+// Empty if cancelled
+std::filesystem::path PickBackup(
+  HWND parent,
+  const std::filesystem::path& initial) {
+  const auto dialog
+    = wil::CoCreateInstance<IFileOpenDialog>(CLSID_FileOpenDialog);
+  constexpr COMDLG_FILTERSPEC FileTypes[] {
+    {L"OpenKneeboard settings backups", L"*.okbbackup"},
+  };
+  THROW_IF_FAILED(dialog->SetFileTypes(std::size(FileTypes), FileTypes));
+  return ShowPicker(dialog.get(), parent, initial, FOS_FILEMUSTEXIST);
+}
+
+// A settings backup being restored; see `ShowRestoreButton()`
+struct SettingsRestore {
+  std::filesystem::path mArchive;
+  Progress mProgress;
+  std::stop_source mStop;
+  std::future<void> mThread;
+  // Set on the UI thread, once `mThread` is ready
+  bool mDone {false};
+  std::string mError;
+};
+// Heap-allocated as `Progress` is not movable
+std::unique_ptr<SettingsRestore> gRestore;
+
+void RestoreThread(SettingsRestore& restore, HWND window) {
+  const auto redraw = StartRedrawing(window);
+  const auto redrawWhenDone
+    = wil::scope_exit([window] { InvalidateRect(window, nullptr, FALSE); });
+  restore.mProgress.Start();
+  try {
+    BackupArchive {{.mStopToken = restore.mStop.get_token()}}.Restore(
+      restore.mArchive, &restore.mProgress);
+  } catch (...) {
+    restore.mProgress.Stop();
+    throw;
+  }
+  if (restore.mStop.stop_requested()) {
+    restore.mProgress.Stop();
+  } else {
+    restore.mProgress.Complete();
+  }
+}
+
+// Next to the backup options, and also shown when there's nothing left to
+// clean up, as that's when a backup is most likely to be wanted
+void ShowRestoreButton(HWND window) {
+  if (!HyperlinkButton("Restore settings from a backup")) {
+    return;
+  }
+  auto archive = PickBackup(window, GetBackupFolder(gOptions));
+  if (archive.empty()) {
+    return;
+  }
+  gRestore = std::make_unique<SettingsRestore>();
+  gRestore->mArchive = std::move(archive);
+  gRestore->mThread = std::async(
+    std::launch::async, RestoreThread, std::ref(*gRestore), window);
+}
+
+void ShowRestoreProgress() {
+  auto& restore = *gRestore;
+  if (
+    !restore.mDone
+    && restore.mThread.wait_for(0s) == std::future_status::ready) {
+    restore.mDone = true;
+    try {
+      restore.mThread.get();
+    } catch (const std::exception& e) {
+      restore.mError = e.what();
     }
   }
 
+  const auto dialog = BeginContentDialog().Scoped();
+  if (!restore.mDone) {
+    ContentDialogTitle("Restoring settings...");
+  } else if (!restore.mError.empty()) {
+    ContentDialogTitle("Couldn't restore settings");
+  } else if (restore.mStop.stop_requested()) {
+    ContentDialogTitle("Restore cancelled");
+  } else {
+    ContentDialogTitle("Settings restored");
+  }
+  ShowProgressDetails(restore.mProgress.GetSnapshot());
+  if (!restore.mError.empty()) {
+    TextBlock(restore.mError).Caption();
+  }
+
   const auto buttons = BeginContentDialogButtons().Scoped();
-  const auto disabled = BeginEnabled(allComplete).Scoped();
-  if (ContentDialogCloseButton("Close").Accent()) {
-    throw ExitException(EXIT_SUCCESS);
+  if (restore.mDone) {
+    if (ContentDialogCloseButton("Close").Accent()) {
+      gRestore.reset();
+    }
+    return;
+  }
+  const auto enabled = BeginEnabled(!restore.mStop.stop_requested()).Scoped();
+  if (ContentDialogCloseButton("Cancel")) {
+    restore.mStop.request_stop();
   }
 }
 
-void ShowModes() {
-  auto& artifacts = GetArtifacts();
+// Only shown if settings will be deleted
+void ShowBackupOptions(HWND window) {
+  bool removingSettings = false;
+  for (auto&& [i, artifact]: std::views::enumerate(GetArtifacts())) {
+    const auto flags = gArtifactTable[i];
+    if (
+      flags.mIsUserSettings
+      && artifact.GetPlannedAction(flags) == Action::Remove) {
+      removingSettings = true;
+      break;
+    }
+  }
+  if (!removingSettings) {
+    return;
+  }
+
+  CheckBox(&gOptions.mBackUpSettings, "Back up your settings first");
+  if (!gOptions.mBackUpSettings) {
+    return;
+  }
+  const auto row = BeginHStackPanel().Scoped().Styled(
+    Style().AlignItems(YGAlignCenter).Gap(8).PaddingLeft(32));
+  const auto folder = GetBackupFolder(gOptions).u8string();
+  Label(
+    "Saved in {}",
+    std::string_view {
+      reinterpret_cast<const char*>(folder.data()), folder.size()})
+    .Caption()
+    .Styled(Style().Color(StaticTheme::Common::TextFillColorSecondaryBrush));
+  if (HyperlinkButton("Change")) {
+    if (auto picked = PickFolder(window, GetBackupFolder(gOptions));
+        !picked.empty()) {
+      gOptions.mBackupFolder = std::move(picked);
+    }
+  }
+}
 
+void ShowModes(HWND window) {
   Label("Your computer contains files or components created by OpenKneeboard.")
     .Styled(Style().Color(StaticTheme::Common::TextFillColorTertiaryBrush));
 
-  const auto haveSettings
-    = std::ranges::any_of(artifacts, &ArtifactState::IsUserSettings);
-  const auto showRepairMode
-    = std::ranges::any_of(artifacts, [](const auto& it) {
-        return it.CanRepair() || it.GetDefaultAction() == Action::Remove;
-      });
-  const auto haveNonSettings = std::ranges::any_of(
-    artifacts, std::not_fn(&ArtifactState::IsUserSettings));
+  const auto haveSettings = gArtifactTable.mHaveSettings;
+  const auto showRepairMode = gArtifactTable.mShowRepairMode;
+  const auto haveNonSettings = gArtifactTable.mHaveNonSettings;
+  // Don't change the user's choices based on a partial list
+  const auto discoveryComplete = IsDiscoveryComplete();
+
+  if (!gIncompleteProbes.empty()) {
+    Label(
+      "Some checks did not finish, so some components may not be listed.")
+      .Caption()
+      .Styled(Style().Color(StaticTheme::Common::TextFillColorSecondaryBrush));
+  }
 
   Label("Clean up OpenKneeboard").Subtitle();
 
@@ -368,7 +1081,7 @@ void ShowModes() {
   BeginRadioButtons();
   if (showRepairMode) {
     RadioButton(
-      &gCleanupMode, CleanupMode::Repair, "Remove outdated components");
+      &gOptions.mMode, CleanupMode::Repair, "Remove outdated components");
     Label("Modern components will be repaired.")
       .Caption()
       .Styled(
@@ -376,24 +1089,31 @@ void ShowModes() {
           .Color(StaticTheme::Common::TextFillColorSecondaryBrush)
           .MarginTop(-6)
           .PaddingLeft(32));
-  } else if (gCleanupMode == CleanupMode::Repair) {
-    gCleanupMode = CleanupMode::RemoveAll;
+  } else if (discoveryComplete && gOptions.mMode == CleanupMode::Repair) {
+    gOptions.mMode = CleanupMode::RemoveAll;
   }
 
   if (haveNonSettings) {
-    RadioButton(&gCleanupMode, CleanupMode::RemoveAll, "Remove everything");
+    RadioButton(&gOptions.mMode, CleanupMode::RemoveAll, "Remove everything");
     if (haveSettings) {
       const auto enabled
-        = BeginEnabled(gCleanupMode == CleanupMode::RemoveAll).Scoped();
-      CheckBox(&gRemoveSettings, "Delete your settings")
+        = BeginEnabled(gOptions.mMode == CleanupMode::RemoveAll).Scoped();
+      CheckBox(&gOptions.mRemoveSettings, "Delete your settings")
         .Styled(Style().PaddingLeft(32));
     }
   } else {
-    gRemoveSettings = true;
-    RadioButton(&gCleanupMode, CleanupMode::RemoveAll, "Delete your settings");
+    if (discoveryComplete) {
+      gOptions.mRemoveSettings = true;
+    }
+    RadioButton(
+      &gOptions.mMode, CleanupMode::RemoveAll, "Delete your settings");
   }
-  RadioButton(&gCleanupMode, CleanupMode::Custom, "Customize");
+  RadioButton(&gOptions.mMode, CleanupMode::Custom, "Customize");
   EndRadioButtons();
+
+  ShowBackupOptions(window);
+  ShowRestoreButton(window);
+  ShowReclaimableSpace();
 }
 
 void ShowArtifacts() {
@@ -401,9 +1121,19 @@ void ShowArtifacts() {
   const auto card = BeginCard().Scoped().Styled(
     Style().FlexDirection(YGFlexDirectionColumn).Gap(12));
 
-  for (auto&& [index, artifact]: std::views::enumerate(GetArtifacts())) {
+  // Rows are sorted by registry index, so walk both together
+  auto& artifacts = GetArtifacts();
+  std::size_t row = 0;
+  for (std::size_t index = 0; index < ArtifactRegistry.size(); ++index) {
     const auto popId = PushID(index).Scoped();
-    ShowArtifact(artifact);
+    if (row < artifacts.size() && artifacts[row].mDiscoveryIndex == index) {
+      ShowArtifact(artifacts[row], gArtifactTable[row]);
+      ++row;
+      continue;
+    }
+    if (!gFinishedProbes.test(index)) {
+      ShowPendingArtifact(ArtifactRegistry[index]);
+    }
   }
 }
 
@@ -419,6 +1149,7 @@ void ShowLicenses() {
     Product {"FredEmmott::GUI", licenses.FUIAsStringView()},
     Product {"Windows Implementation Library", licenses.WILAsStringView()},
     Product {"Yoga", licenses.YogaAsStringView()},
+    Product {"Zstandard", licenses.ZstdAsStringView()},
   };
 
   const auto layout
@@ -468,16 +1199,22 @@ void ShowContent(Win32Window& window) {
   if (GetArtifacts().empty()) {
     window.SetResizeMode(Window::ResizeMode::Fixed, Window::ResizeMode::Fixed);
     const auto layout = BeginVStackPanel().Styled(ContentLayoutStyle).Scoped();
-    Label("Couldn't find anything from OpenKneeboard on your computer.")
-      .Styled(ContentLayoutStyle);
+    if (IsDiscoveryComplete()) {
+      Label("Couldn't find anything from OpenKneeboard on your computer.")
+        .Styled(ContentLayoutStyle);
+      ShowRestoreButton(window.GetNativeHandle());
+    } else {
+      Label("Looking for OpenKneeboard components...")
+        .Styled(ContentLayoutStyle);
+    }
     ShowLicensesButton();
     return;
   }
 
-  if (gCleanupMode != CleanupMode::Custom) {
+  if (gOptions.mMode != CleanupMode::Custom) {
     window.SetResizeMode(Window::ResizeMode::Fixed, Window::ResizeMode::Fixed);
     const auto layout = BeginVStackPanel().Styled(ContentLayoutStyle).Scoped();
-    ShowModes();
+    ShowModes(window.GetNativeHandle());
     ShowLicensesButton();
     return;
   }
@@ -487,19 +1224,64 @@ void ShowContent(Win32Window& window) {
   const auto scroll
     = BeginVScrollView().Scoped().Styled(Style().FlexGrow(1).FlexShrink(1));
   const auto layout = BeginVStackPanel().Scoped().Styled(ContentLayoutStyle);
-  ShowModes();
+  ShowModes(window.GetNativeHandle());
   ShowArtifacts();
   ShowLicensesButton();
 }
 
 void AppTick(Win32Window& window) {
-  const auto resizeIfNeeded
-    = wil::scope_exit([wasCustom = gCleanupMode == CleanupMode::Custom] {
-        const auto isCustom = gCleanupMode == CleanupMode::Custom;
-        if (wasCustom != isCustom) {
-          ResizeToFit();
-        }
-      });
+  const Instrumentation::ScopedTimer timer {"UI", "AppTick"};
+  static Plan sPlan;
+  static std::vector<Executor> sExecutors;
+  static std::future<void> sExecutorThread;
+  // If so, nothing is discovered, and only the progress is shown
+  static bool sIsResuming = false;
+
+  const auto startRun = [window = window.GetNativeHandle()](Plan plan) {
+    sPlan = std::move(plan);
+    sExecutors = GetExecutors(sPlan);
+    gJournal = CreateJournal(sPlan);
+    // Scheduler callbacks are serialized; see `ActionScheduler::Callback`
+    gExecutorEvents = std::make_unique<EventChannel<ExecutorEvent>>(
+      1, [window] { InvalidateRect(window, nullptr, FALSE); });
+    sExecutorThread = std::async(
+      std::launch::async,
+      ExecutorThread,
+      std::cref(sPlan),
+      std::ref(sExecutors),
+      window);
+  };
+
+  static bool sStarted = false;
+  if (!std::exchange(sStarted, true)) {
+    if (auto plan = GetInterruptedPlan()) {
+      sIsResuming = true;
+      startRun(std::move(*plan));
+    } else {
+      StartDiscovery(window.GetNativeHandle());
+    }
+    StartReaping(window.GetNativeHandle());
+  }
+
+  if (IsDiscoveryComplete() && sExecutors.empty()) {
+    if (!gLiveDiscovery.mWatcher) {
+      StartWatching(window.GetNativeHandle());
+    }
+    StartRescanIfNeeded(window.GetNativeHandle());
+  }
+  const auto artifactsChanged = UpdateArtifacts();
+  if (artifactsChanged) {
+    gArtifactTable.Invalidate();
+  }
+  gArtifactTable.Update(GetArtifacts());
+
+  const auto resizeIfNeeded = wil::scope_exit(
+    [artifactsChanged, wasCustom = gOptions.mMode == CleanupMode::Custom] {
+      const auto isCustom = gOptions.mMode == CleanupMode::Custom;
+      if (artifactsChanged || wasCustom != isCustom) {
+        ResizeToFit();
+      }
+    });
 
   const auto outer
     = BeginVStackPanel()
@@ -511,7 +1293,18 @@ void AppTick(Win32Window& window) {
             .Gap(0))
         .Scoped();
 
+  if (sIsResuming) {
+    Label("Resuming an interrupted cleanup...")
+      .Styled(Style().Margin(12).Padding(8));
+    ApplyExecutorEvents(sExecutors, window.GetNativeHandle());
+    ShowProgress(sExecutors);
+    return;
+  }
+
   ShowContent(window);
+  if (gRestore) {
+    ShowRestoreProgress();
+  }
 
   if (GetArtifacts().empty()) {
     const auto buttons = BeginContentDialogButtons().Scoped();
@@ -521,18 +1314,14 @@ void AppTick(Win32Window& window) {
     return;
   }
 
-  static std::vector<Executor> sExecutors;
-  static std::future<void> sExecutorThread;
-
   {
     const auto buttons = BeginContentDialogButtons().Scoped();
-    if (ContentDialogPrimaryButton("OK").Accent()) {
-      sExecutors = GetExecutors();
-      sExecutorThread = std::async(
-        std::launch::async,
-        ExecutorThread,
-        std::ref(sExecutors),
-        window.GetNativeHandle());
+    {
+      const auto enabled = BeginEnabled(IsDiscoveryComplete()).Scoped();
+      if (ContentDialogPrimaryButton("OK").Accent()) {
+        StopWatching();
+        startRun(BuildPlan());
+      }
     }
     if (ContentDialogCloseButton("Cancel")) {
       throw ExitException(EXIT_SUCCESS);
@@ -540,10 +1329,63 @@ void AppTick(Win32Window& window) {
   }
 
   if (!sExecutors.empty()) {
+    ApplyExecutorEvents(sExecutors, window.GetNativeHandle());
     ShowProgress(sExecutors);
   }
 }
 
+// Stopped by Ctrl+C in headless mode
+std::stop_source gHeadlessStop;
+
+BOOL WINAPI OnConsoleControl([[maybe_unused]] DWORD event) {
+  gHeadlessStop.request_stop();
+  return TRUE;
+}
+
+// We're a GUI app, so we don't have a console unless we borrow our parent's
+void AttachToConsole() {
+  if (!AttachConsole(ATTACH_PARENT_PROCESS)) {
+    AllocConsole();
+  }
+  FILE* stream {};
+  freopen_s(&stream, "CONOUT$", "w", stdout);
+  freopen_s(&stream, "CONOUT$", "w", stderr);
+  SetConsoleOutputCP(CP_UTF8);
+}
+
+// Returns the exit code, or nullopt if the window should be shown. Headless
+// runs never initialize FUI, so no window or renderer is created.
+std::optional<int> RunHeadlessIfRequested() {
+  int argc {};
+  const wil::unique_hlocal_ptr<PWSTR> argv {
+    CommandLineToArgvW(GetCommandLineW(), &argc)};
+  if (!argv || argc < 2) {
+    return std::nullopt;
+  }
+  const std::vector<std::wstring_view> args {argv.get() + 1, argv.get() + argc};
+
+  std::optional<HeadlessOptions> options;
+  try {
+    options = ParseHeadlessArguments(args);
+  } catch (const std::invalid_argument& e) {
+    AttachToConsole();
+    std::cerr << e.what() << "\n\n" << GetHeadlessUsage();
+    return HeadlessExitCode::InvalidArguments;
+  }
+  if (!options) {
+    return std::nullopt;
+  }
+
+  AttachToConsole();
+  SetConsoleCtrlHandler(&OnConsoleControl, TRUE);
+  try {
+    return RunHeadless(*options, std::cout, gHeadlessStop.get_token());
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return HeadlessExitCode::Incomplete;
+  }
+}
+
 int WINAPI wWinMain(
   [[maybe_unused]] HINSTANCE hInstance,
   [[maybe_unused]] HINSTANCE hPrevInstance,
@@ -553,6 +1395,19 @@ int WINAPI wWinMain(
     .mTitle = std::format("OKB Fresh Start v{}", ::Config::Version::Readable),
   };
   options.mWindowExStyle |= WS_EX_DLGMODALFRAME;
+
+  const auto tracePath
+    = Instrumentation::EnableFromEnvironment(pCmdLine ? pCmdLine : L"");
+  const auto writeTrace = wil::scope_exit([&tracePath] {
+    if (!tracePath.empty()) {
+      Instrumentation::WriteChromeTrace(tracePath);
+    }
+  });
+
+  if (const auto exitCode = RunHeadlessIfRequested()) {
+    return *exitCode;
+  }
+
   return Win32Window::WinMain(
     hInstance, hPrevInstance, pCmdLine, nCmdShow, &AppTick, options);
 }
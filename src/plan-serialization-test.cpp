@@ -0,0 +1,211 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+// Checks that `Plan::Serialize()` round-trips, and that
+// `Plan::Deserialize()` rejects truncated, corrupt, or unsupported data with
+// `std::runtime_error`, rather than returning a different plan.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <limits>
+#include <source_location>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Plan.hpp"
+
+namespace {
+bool gFailed = false;
+
+void Check(
+  const bool condition,
+  const std::string_view what,
+  const std::source_location& caller = std::source_location::current()) {
+  if (condition) {
+    return;
+  }
+  std::cerr << std::format(
+    "{}:{}: {}\n", caller.file_name(), caller.line(), what);
+  gFailed = true;
+}
+
+// Every kind of operation, with the largest integers; paths are also
+// non-ASCII on Windows, as elsewhere, converting wide strings depends on the
+// locale
+Plan MakePlan() {
+#ifdef _WIN32
+  const std::filesystem::path folder {L"C:\\Users\\Zo\u00eb\\\u65e5\u672c"};
+#else
+  const std::filesystem::path folder {L"/home/zoe"};
+#endif
+  const std::filesystem::path sources[] {folder / "Logs", folder / "Settings"};
+
+  Plan::Builder builder;
+  builder.AddStep(
+    "Backup",
+    Plan::Action::Backup,
+    {PlannedOperation::BackupPaths(folder / "backup.okbackup", sources)});
+  builder.AddStep(
+    "Logs",
+    Plan::Action::Remove,
+    {PlannedOperation::RemovePath(
+      folder / "Logs",
+      {
+        .mBytes = std::numeric_limits<std::uint64_t>::max(),
+        .mFiles = 1234,
+      })});
+  builder.AddStep(
+    "HKLM OpenXR API layers",
+    Plan::Action::Repair,
+    {
+      PlannedOperation::DeleteRegistryValue(
+        RegistryHive::LocalMachine,
+        RegistryView::Bits64,
+        L"SOFTWARE\\Khronos\\OpenXR\\1\\ApiLayers\\Implicit",
+        (folder / "layer.json").wstring()),
+      PlannedOperation::SetRegistryDWORD(
+        RegistryHive::CurrentUser,
+        RegistryView::Bits32,
+        L"SOFTWARE\\Khronos\\OpenXR\\1\\ApiLayers\\Implicit",
+        L"B",
+        std::numeric_limits<std::uint32_t>::max()),
+    });
+  builder.AddStep(
+    "MSI installation",
+    Plan::Action::Repair,
+    {
+      PlannedOperation::UninstallMSIProduct(L"{0000-1111}"),
+      PlannedOperation::RepairMSIProduct(L"{2222-3333}"),
+    });
+  builder.AddStep(
+    "MSIX installation",
+    Plan::Action::Remove,
+    {PlannedOperation::RemoveMSIXPackage(L"OpenKneeboard_1.0_x64__abc")});
+  // No operations
+  builder.AddStep("Empty", Plan::Action::Remove, {});
+  return std::move(builder).Build();
+}
+
+// Returns true if deserializing threw `std::runtime_error`; anything else,
+// including a different exception, is a failure
+bool Rejects(const std::span<const std::byte> data) {
+  try {
+    (void)Plan::Deserialize(data);
+  } catch (const std::runtime_error&) {
+    return true;
+  } catch (const std::exception& e) {
+    std::cerr << std::format("Unexpected exception: {}\n", e.what());
+    return false;
+  }
+  return false;
+}
+
+void TestRoundTrip() {
+  const auto plan = MakePlan();
+  const auto data = plan.Serialize();
+  try {
+    Check(Plan::Deserialize(data) == plan, "Plan changed");
+  } catch (const std::exception& e) {
+    Check(false, std::format("Round trip threw: {}", e.what()));
+  }
+  Check(
+    Plan::Deserialize(Plan {}.Serialize()) == Plan {},
+    "Empty plan changed");
+}
+
+void TestTruncation() {
+  const auto data = MakePlan().Serialize();
+  for (std::size_t size = 0; size < data.size(); ++size) {
+    if (!Rejects(std::span {data}.first(size))) {
+      Check(
+        false,
+        std::format(
+          "Plan truncated to {} of {} bytes was accepted", size, data.size()));
+      return;
+    }
+  }
+}
+
+void TestTrailingData() {
+  auto data = MakePlan().Serialize();
+  data.push_back(std::byte {0});
+  Check(Rejects(data), "Trailing byte accepted");
+}
+
+void TestHeader() {
+  const auto data = MakePlan().Serialize();
+
+  auto badMagic = data;
+  badMagic.front() = std::byte {'X'};
+  Check(Rejects(badMagic), "Bad magic accepted");
+
+  // The version follows the 8-byte magic, and is a single-byte varint
+  auto badVersion = data;
+  badVersion.at(8) = std::byte {2};
+  Check(Rejects(badVersion), "Future version accepted");
+  badVersion.at(8) = std::byte {0};
+  Check(Rejects(badVersion), "Version 0 accepted");
+}
+
+// Each byte offset is for a plan with a single step titled "S", with one
+// `SetRegistryDWORD` operation with subkey "K"
+void TestOutOfRangeEnums() {
+  Plan::Builder builder;
+  builder.AddStep(
+    "S",
+    Plan::Action::Repair,
+    {PlannedOperation::SetRegistryDWORD(
+      RegistryHive::LocalMachine, RegistryView::Default, L"K", L"V", 1)});
+  const auto data = std::move(builder).Build().Serialize();
+
+  // Magic, version, step count, title size, title
+  constexpr std::size_t ActionOffset = 8 + 1 + 1 + 1 + 1;
+  // Action, operation count
+  constexpr std::size_t KindOffset = ActionOffset + 2;
+  // Kind, subkey size, subkey
+  constexpr std::size_t HiveOffset = KindOffset + 3;
+  constexpr std::size_t ViewOffset = HiveOffset + 1;
+
+  const auto at = [&data](const std::size_t offset) {
+    return std::to_integer<int>(data.at(offset));
+  };
+  // Check that the offsets are right, so that the test can't pass by
+  // corrupting something else
+  Check(
+    at(ActionOffset) == std::to_underlying(Plan::Action::Repair)
+      && at(KindOffset)
+        == std::to_underlying(PlannedOperation::Kind::SetRegistryDWORD)
+      && at(HiveOffset) == std::to_underlying(RegistryHive::LocalMachine)
+      && at(ViewOffset) == std::to_underlying(RegistryView::Default),
+    "Unexpected plan layout");
+
+  const auto rejectsValue = [&data](const std::size_t offset, const int value) {
+    auto corrupt = data;
+    corrupt.at(offset) = static_cast<std::byte>(value);
+    return Rejects(corrupt);
+  };
+  Check(rejectsValue(ActionOffset, 3), "Out-of-range action accepted");
+  Check(rejectsValue(KindOffset, 7), "Out-of-range operation kind accepted");
+  Check(rejectsValue(HiveOffset, 2), "Out-of-range registry hive accepted");
+  Check(rejectsValue(ViewOffset, 3), "Out-of-range registry view accepted");
+  // The largest single-byte varint
+  Check(rejectsValue(ActionOffset, 0x7f), "Large action accepted");
+}
+}// namespace
+
+int main() {
+  TestRoundTrip();
+  TestTruncation();
+  TestTrailingData();
+  TestHeader();
+  TestOutOfRangeEnums();
+  return gFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
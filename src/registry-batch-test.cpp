@@ -0,0 +1,170 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+// Checks that registry steps are applied all-or-nothing, using
+// `FakeRegistry`, and that large OpenXR layer lists are applied quickly.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <source_location>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "Plan.hpp"
+#include "PlanApplier.hpp"
+#include "Progress.hpp"
+#include "Registry.hpp"
+#include "Task.hpp"
+
+namespace {
+constexpr auto LayersKey
+  = L"SOFTWARE\\Khronos\\OpenXR\\1\\ApiLayers\\Implicit";
+constexpr std::size_t LayerCount = 5000;
+// Generous, as this also runs in debug and sanitizer builds
+constexpr std::chrono::seconds MaxApplyTime {2};
+
+bool gFailed = false;
+
+void Check(
+  const bool condition,
+  const std::string_view what,
+  const std::source_location& caller = std::source_location::current()) {
+  if (condition) {
+    return;
+  }
+  std::cerr << std::format(
+    "{}:{}: {}\n", caller.file_name(), caller.line(), what);
+  gFailed = true;
+}
+
+std::wstring GetLayerPath(const std::size_t index) {
+  return std::format(L"C:\\Layers\\{}\\layer.json", index);
+}
+
+RegistryValueLocation GetLayerValue(const std::size_t index) {
+  return {
+    .mHive = RegistryHive::LocalMachine,
+    .mSubKey = LayersKey,
+    .mValueName = GetLayerPath(index),
+  };
+}
+
+// Every layer, enabled
+void Populate(FakeRegistry& registry) {
+  for (std::size_t i = 0; i < LayerCount; ++i) {
+    registry.SetDWORD(GetLayerValue(i), 0);
+  }
+}
+
+using Snapshot = std::map<std::size_t, std::optional<std::uint32_t>>;
+
+Snapshot TakeSnapshot(const FakeRegistry& registry) {
+  Snapshot ret;
+  for (std::size_t i = 0; i < LayerCount; ++i) {
+    ret.emplace(i, registry.GetDWORD(GetLayerValue(i)));
+  }
+  return ret;
+}
+
+// Disables every odd layer, and removes every even one, then adds `extra` if
+// provided
+Plan MakePlan(std::optional<PlannedOperation> extra = std::nullopt) {
+  std::vector<PlannedOperation> operations;
+  for (std::size_t i = 0; i < LayerCount; ++i) {
+    if (i % 2) {
+      operations.push_back(PlannedOperation::SetRegistryDWORD(
+        RegistryHive::LocalMachine,
+        RegistryView::Default,
+        LayersKey,
+        GetLayerPath(i),
+        1));
+    } else {
+      operations.push_back(PlannedOperation::DeleteRegistryValue(
+        RegistryHive::LocalMachine,
+        RegistryView::Default,
+        LayersKey,
+        GetLayerPath(i)));
+    }
+  }
+  if (extra) {
+    operations.push_back(*extra);
+  }
+  Plan::Builder builder;
+  builder.AddStep("OpenXR layers", Plan::Action::Repair, std::move(operations));
+  return std::move(builder).Build();
+}
+
+// Returns true if the step threw
+bool Apply(const Plan& plan, FakeRegistry& registry) {
+  Progress progress;
+  try {
+    SyncWait(ApplyStep(plan, plan.GetSteps().front(), progress, {}, registry));
+  } catch (const std::system_error&) {
+    return true;
+  }
+  return false;
+}
+
+void TestInjectedFailureRollsBack() {
+  FakeRegistry registry;
+  Populate(registry);
+  const auto before = TakeSnapshot(registry);
+
+  const auto plan = MakePlan();
+  registry.mFailAtEdit = LayerCount - 1;
+  Check(Apply(plan, registry), "Injected failure was not reported");
+  Check(
+    TakeSnapshot(registry) == before, "Injected failure was not rolled back");
+  Check(registry.GetValueCount() == LayerCount, "Value count changed");
+}
+
+void TestMissingKeyRollsBack() {
+  FakeRegistry registry;
+  Populate(registry);
+  const auto before = TakeSnapshot(registry);
+
+  const auto plan = MakePlan(PlannedOperation::SetRegistryDWORD(
+    RegistryHive::LocalMachine,
+    RegistryView::Default,
+    L"SOFTWARE\\DoesNotExist",
+    L"Value",
+    1));
+  Check(Apply(plan, registry), "Missing key was not reported");
+  Check(TakeSnapshot(registry) == before, "Missing key was not rolled back");
+  Check(registry.GetValueCount() == LayerCount, "Value count changed");
+}
+
+void TestLargeBatchIsQuick() {
+  FakeRegistry registry;
+  Populate(registry);
+
+  const auto plan = MakePlan();
+  const auto start = std::chrono::steady_clock::now();
+  Check(!Apply(plan, registry), "Applying failed");
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - start);
+
+  Check(FindUnappliedOperations(plan, registry).empty(), "Edits not applied");
+  Check(registry.GetValueCount() == LayerCount / 2, "Wrong value count");
+  Check(
+    elapsed < MaxApplyTime,
+    std::format(
+      "Applying {} edits took {}us", LayerCount, elapsed.count()));
+  std::cout << std::format(
+    "Applied {} edits in {}us\n", LayerCount, elapsed.count());
+}
+}// namespace
+
+int main() {
+  TestInjectedFailureRollsBack();
+  TestMissingKeyRollsBack();
+  TestLargeBatchIsQuick();
+  return gFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
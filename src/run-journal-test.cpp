@@ -0,0 +1,244 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+// Checks that `RunJournal` recovers what it can from damaged journals, and
+// that resuming a started step only repeats what isn't already done; uses
+// `FakeRegistry`.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <source_location>
+#include <string_view>
+#include <vector>
+
+#include "Plan.hpp"
+#include "Registry.hpp"
+#include "RunJournal.hpp"
+
+namespace {
+using StepState = RunJournal::StepState;
+
+constexpr auto LayersKey
+  = L"SOFTWARE\\Khronos\\OpenXR\\1\\ApiLayers\\Implicit";
+
+bool gFailed = false;
+
+void Check(
+  const bool condition,
+  const std::string_view what,
+  const std::source_location& caller = std::source_location::current()) {
+  if (condition) {
+    return;
+  }
+  std::cerr << std::format(
+    "{}:{}: {}\n", caller.file_name(), caller.line(), what);
+  gFailed = true;
+}
+
+RegistryValueLocation GetLayerValue(const std::wstring_view name) {
+  return {
+    .mHive = RegistryHive::LocalMachine,
+    .mSubKey = LayersKey,
+    .mValueName = std::wstring {name},
+  };
+}
+
+PlannedOperation DeleteLayer(const std::wstring_view name) {
+  return PlannedOperation::DeleteRegistryValue(
+    RegistryHive::LocalMachine,
+    RegistryView::Default,
+    LayersKey,
+    std::wstring {name});
+}
+
+PlannedOperation DisableLayer(const std::wstring_view name) {
+  return PlannedOperation::SetRegistryDWORD(
+    RegistryHive::LocalMachine,
+    RegistryView::Default,
+    LayersKey,
+    std::wstring {name},
+    1);
+}
+
+// Paths in `folder` that are never created, so removing them is already
+// done
+Plan MakePlan(const std::filesystem::path& folder) {
+  Plan::Builder builder;
+  builder.AddStep(
+    "Logs",
+    Plan::Action::Remove,
+    {PlannedOperation::RemovePath(folder / "Logs")});
+  builder.AddStep(
+    "OpenXR layers",
+    Plan::Action::Repair,
+    {DeleteLayer(L"A"), DisableLayer(L"B"), DeleteLayer(L"C")});
+  builder.AddStep(
+    "Settings",
+    Plan::Action::Remove,
+    {PlannedOperation::RemovePath(folder / "Settings")});
+  return std::move(builder).Build();
+}
+
+// Writes a journal where the first step succeeded, and the second started;
+// returns the file size after each record, starting with the plan
+std::vector<std::uintmax_t> WriteJournal(
+  const std::filesystem::path& path,
+  const Plan& plan) {
+  std::vector<std::uintmax_t> ret;
+  RunJournal journal {path, plan};
+  ret.push_back(std::filesystem::file_size(path));
+  journal.MarkStarted(0);
+  ret.push_back(std::filesystem::file_size(path));
+  journal.MarkSucceeded(0);
+  ret.push_back(std::filesystem::file_size(path));
+  journal.MarkStarted(1);
+  ret.push_back(std::filesystem::file_size(path));
+  return ret;
+}
+
+// Flips the lowest bit, so that the data still parses, e.g. a step index of
+// 0 becomes 1; only the CRC can catch it
+void FlipBit(const std::filesystem::path& path, const std::uintmax_t offset) {
+  std::fstream file {path, std::ios::binary | std::ios::in | std::ios::out};
+  file.seekg(static_cast<std::streamoff>(offset));
+  const auto byte = static_cast<char>(file.get() ^ 0x01);
+  file.seekp(static_cast<std::streamoff>(offset));
+  file.put(byte);
+}
+
+void TestIntactJournal(const std::filesystem::path& folder) {
+  const auto path = folder / "intact.journal";
+  const auto plan = MakePlan(folder);
+  WriteJournal(path, plan);
+
+  const auto recovery = RunJournal::Recover(path);
+  Check(recovery.has_value(), "Intact journal not recovered");
+  if (!recovery) {
+    return;
+  }
+  Check(recovery->mPlan == plan, "Plan changed");
+  Check(
+    recovery->mStates
+      == std::vector {
+        StepState::Succeeded, StepState::Started, StepState::Pending},
+    "Wrong step states");
+}
+
+void TestTornFinalRecord(const std::filesystem::path& folder) {
+  const auto path = folder / "torn.journal";
+  const auto plan = MakePlan(folder);
+  const auto sizes = WriteJournal(path, plan);
+  // Part of the header and payload of the last record
+  std::filesystem::resize_file(path, sizes.back() - 3);
+
+  const auto recovery = RunJournal::Recover(path);
+  Check(recovery.has_value(), "Torn journal not recovered");
+  if (!recovery) {
+    return;
+  }
+  Check(recovery->mPlan == plan, "Plan changed");
+  Check(
+    recovery->mStates
+      == std::vector {
+        StepState::Succeeded, StepState::Pending, StepState::Pending},
+    "Torn record was used, or earlier records were lost");
+
+  // Only the header of the last record
+  std::filesystem::resize_file(path, sizes.at(2) + 4);
+  const auto headerOnly = RunJournal::Recover(path);
+  Check(
+    headerOnly && headerOnly->mStates.front() == StepState::Succeeded,
+    "Partial header hid earlier records");
+}
+
+void TestBadCRC(const std::filesystem::path& folder) {
+  const auto path = folder / "crc.journal";
+  const auto plan = MakePlan(folder);
+  const auto sizes = WriteJournal(path, plan);
+  // The step index in `MarkSucceeded(0)`; everything after it is ignored
+  // too, as it can't be trusted
+  FlipBit(path, sizes.at(2) - 1);
+
+  const auto recovery = RunJournal::Recover(path);
+  Check(recovery.has_value(), "Journal with bad CRC not recovered");
+  if (!recovery) {
+    return;
+  }
+  Check(
+    recovery->mStates
+      == std::vector {
+        StepState::Started, StepState::Pending, StepState::Pending},
+    "Record with bad CRC, or a later one, was used");
+}
+
+void TestCorruptPlan(const std::filesystem::path& folder) {
+  const auto path = folder / "plan.journal";
+  const auto sizes = WriteJournal(path, MakePlan(folder));
+  FlipBit(path, sizes.front() - 1);
+  Check(!RunJournal::Recover(path), "Corrupt plan was used");
+
+  Check(
+    !RunJournal::Recover(folder / "missing.journal"),
+    "Missing journal was recovered");
+}
+
+void TestResumeStartedStep(const std::filesystem::path& folder) {
+  const auto path = folder / "resume.journal";
+  const auto plan = MakePlan(folder);
+  WriteJournal(path, plan);
+  const auto recovery = RunJournal::Recover(path);
+  Check(recovery.has_value(), "Journal not recovered");
+  if (!recovery) {
+    return;
+  }
+
+  // The interrupted step had deleted A and disabled B, but not deleted C
+  FakeRegistry registry;
+  registry.SetDWORD(GetLayerValue(L"B"), 1);
+  registry.SetDWORD(GetLayerValue(L"C"), 0);
+
+  Plan::Builder expected;
+  expected.AddStep("OpenXR layers", Plan::Action::Repair, {DeleteLayer(L"C")});
+  expected.AddStep(
+    "Settings",
+    Plan::Action::Remove,
+    {PlannedOperation::RemovePath(folder / "Settings")});
+  Check(
+    recovery->GetRemainingPlan(registry) == std::move(expected).Build(),
+    "Wrong remaining plan for a started step");
+
+  // Nothing left to do in the started step, so it's dropped
+  FakeRegistry done;
+  done.SetDWORD(GetLayerValue(L"B"), 1);
+  const auto remaining = recovery->GetRemainingPlan(done);
+  Check(
+    remaining.GetSteps().size() == 1
+      && remaining.GetSteps().front().mTitle == "Settings",
+    "Finished started step was not dropped");
+}
+}// namespace
+
+int main() {
+  const auto folder = std::filesystem::temp_directory_path()
+    / std::format("run-journal-test-{}",
+                  std::chrono::steady_clock::now().time_since_epoch().count());
+  std::filesystem::create_directories(folder);
+
+  TestIntactJournal(folder);
+  TestTornFinalRecord(folder);
+  TestBadCRC(folder);
+  TestCorruptPlan(folder);
+  TestResumeStartedStep(folder);
+
+  std::error_code ec;
+  std::filesystem::remove_all(folder, ec);
+  return gFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
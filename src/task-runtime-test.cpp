@@ -0,0 +1,352 @@
+// Copyright 2025 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+// Checks `Task` and `ThreadPool`: nesting, exceptions, and cancellation via
+// `ActionScheduler`; then times many actions that wait on a timer, and a few
+// that block shared pool threads.
+//
+// Most useful when built with ThreadSanitizer, e.g. with
+// `-DCMAKE_CXX_FLAGS=-fsanitize=thread`.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <semaphore>
+#include <source_location>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "ActionScheduler.hpp"
+#include "Task.hpp"
+#include "ThreadPool.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+using Outcome = ActionScheduler::Outcome;
+
+// Symmetric transfer is only a tail call in optimized builds, so
+// unoptimized builds use some stack for each level
+#ifdef NDEBUG
+constexpr std::size_t NestingDepth = 10'000;
+#else
+constexpr std::size_t NestingDepth = 1'000;
+#endif
+constexpr std::size_t StressRuns = 200;
+constexpr std::size_t TimerActionCount = 1000;
+constexpr std::size_t BlockingActionCount = 16;
+constexpr std::chrono::milliseconds ActionDuration {50};
+
+bool gFailed = false;
+
+void Check(
+  const bool condition,
+  const std::string_view what,
+  const std::source_location& caller = std::source_location::current()) {
+  if (condition) {
+    return;
+  }
+  std::cerr << std::format(
+    "{}:{}: {}\n", caller.file_name(), caller.line(), what);
+  gFailed = true;
+}
+
+// One thread resuming coroutines at their deadlines, like a native
+// asynchronous operation completing; nothing else waits
+class Timer {
+ public:
+  Timer() : mThread(std::bind_front(&Timer::Run, this)) {}
+
+  [[nodiscard]] auto Sleep(const std::chrono::milliseconds duration) {
+    struct Awaiter {
+      bool await_ready() noexcept {
+        return false;
+      }
+      void await_suspend(std::coroutine_handle<> handle) {
+        mTimer->Enqueue(mDeadline, handle);
+      }
+      void await_resume() noexcept {}
+
+      Timer* mTimer {nullptr};
+      Clock::time_point mDeadline;
+    };
+    return Awaiter {this, Clock::now() + duration};
+  }
+
+ private:
+  std::mutex mMutex;
+  std::condition_variable_any mChanged;
+  std::multimap<Clock::time_point, std::coroutine_handle<>> mQueue;
+  std::jthread mThread;
+
+  void Enqueue(
+    const Clock::time_point deadline,
+    const std::coroutine_handle<> handle) {
+    {
+      std::unique_lock lock(mMutex);
+      mQueue.emplace(deadline, handle);
+    }
+    mChanged.notify_one();
+  }
+
+  void Run(std::stop_token stopToken) {
+    std::unique_lock lock(mMutex);
+    while (!stopToken.stop_requested()) {
+      if (mQueue.empty()) {
+        mChanged.wait(lock, stopToken, [this] { return !mQueue.empty(); });
+        continue;
+      }
+      const auto it = mQueue.begin();
+      if (it->first > Clock::now()) {
+        const auto deadline = it->first;
+        mChanged.wait_until(lock, stopToken, deadline, [this, deadline] {
+          return mQueue.begin()->first < deadline;
+        });
+        continue;
+      }
+      const auto handle = it->second;
+      mQueue.erase(it);
+      lock.unlock();
+      handle.resume();
+      lock.lock();
+    }
+  }
+};
+
+// Synchronous, so each level resumes the one above it via symmetric
+// transfer, rather than growing the stack
+Task<std::size_t> Nest(const std::size_t depth) {
+  if (depth == 0) {
+    co_return 0;
+  }
+  co_return 1 + co_await Nest(depth - 1);
+}
+
+// Each level moves to a different pool thread
+Task<std::size_t> NestOnPool(const std::size_t depth) {
+  co_await ThreadPool::GetShared().Schedule();
+  if (depth == 0) {
+    co_return 0;
+  }
+  co_return 1 + co_await NestOnPool(depth - 1);
+}
+
+void TestNesting() {
+  Check(SyncWait(Nest(NestingDepth)) == NestingDepth, "Wrong nested result");
+  Check(SyncWait(NestOnPool(100)) == 100, "Wrong nested pool result");
+}
+
+Task<int> Throw(const bool onPool) {
+  if (onPool) {
+    co_await ThreadPool::GetShared().Schedule();
+  }
+  throw std::runtime_error("Expected");
+  co_return 0;
+}
+
+// Catches the exception from `Throw()`, then throws a different one
+Task<> Rethrow(const bool onPool) {
+  try {
+    co_await Throw(onPool);
+  } catch (const std::runtime_error&) {
+    throw std::logic_error("Rethrown");
+  }
+}
+
+void TestExceptions() {
+  for (const auto onPool: {false, true}) {
+    try {
+      SyncWait(Rethrow(onPool));
+      Check(false, "Exception was swallowed");
+    } catch (const std::logic_error&) {
+    } catch (...) {
+      Check(false, "Wrong exception");
+    }
+
+    std::exception_ptr error;
+    std::binary_semaphore done {0};
+    StartTask(Rethrow(onPool), [&](const std::exception_ptr it) {
+      error = it;
+      done.release();
+    });
+    done.acquire();
+    Check(error != nullptr, "StartTask() did not report the exception");
+  }
+}
+
+Task<> WaitForStop(
+  Timer& timer,
+  const std::stop_token token,
+  std::atomic<std::size_t>& started,
+  std::atomic<std::size_t>& stopped) {
+  ++started;
+  while (!token.stop_requested()) {
+    co_await timer.Sleep(std::chrono::milliseconds {1});
+  }
+  ++stopped;
+}
+
+// Only one action can run at a time, and it waits until stopped; the others
+// should never start
+void TestCancellation(Timer& timer) {
+  std::atomic<std::size_t> started {0};
+  std::atomic<std::size_t> stopped {0};
+  const auto run = [&](const std::stop_token token) {
+    return WaitForStop(timer, token, started, stopped);
+  };
+  constexpr ExecutionResource Resources[] {
+    ExecutionResource::WindowsInstaller};
+  std::vector<ActionScheduler::Action> actions;
+  for (std::size_t i = 0; i < 4; ++i) {
+    actions.push_back({
+      .mName = "Cancellable",
+      .mRun = run,
+      .mResources = ActionScheduler::MakeResourceSet(Resources),
+    });
+  }
+
+  std::stop_source stopSource;
+  std::jthread canceller {[&stopSource] {
+    std::this_thread::sleep_for(ActionDuration);
+    stopSource.request_stop();
+  }};
+  ActionScheduler scheduler {std::move(actions)};
+  const auto results = scheduler.Run({}, stopSource.get_token());
+  Check(
+    std::ranges::all_of(
+      results,
+      [](const auto& it) { return it.mOutcome == Outcome::Cancelled; }),
+    "Action not cancelled");
+  Check(started == 1, "Pending actions were started after cancellation");
+
+  // The running action is abandoned rather than awaited, but does see the
+  // stop request
+  const auto deadline = Clock::now() + std::chrono::seconds {5};
+  while (stopped == 0 && Clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds {1});
+  }
+  Check(stopped == 1, "Running action did not see the stop request");
+}
+
+// Alternates between resuming on the timer thread and on the pool
+Task<> StressAction(Timer& timer, const std::size_t index) {
+  if (index % 2) {
+    co_await ThreadPool::GetShared().Schedule();
+  } else {
+    co_await timer.Sleep(std::chrono::milliseconds {0});
+  }
+}
+
+// Many short runs, to give ThreadSanitizer more chances to spot a race
+void TestStress(Timer& timer) {
+  constexpr std::size_t ActionCount = 8;
+  for (std::size_t run = 0; run < StressRuns; ++run) {
+    std::vector<ActionScheduler::Action> actions;
+    for (std::size_t i = 0; i < ActionCount; ++i) {
+      actions.push_back({
+        .mName = "Stress",
+        .mRun = [&timer, i](std::stop_token) { return StressAction(timer, i); },
+      });
+      // The second half each wait for one in the first half
+      if (i >= ActionCount / 2) {
+        actions.back().mDependencies = {i - (ActionCount / 2)};
+      }
+    }
+    ActionScheduler scheduler {std::move(actions)};
+    const auto results = scheduler.Run();
+    if (!std::ranges::all_of(results, [](const auto& it) {
+          return it.mOutcome == Outcome::Succeeded;
+        })) {
+      Check(false, std::format("Stress run {} failed", run));
+      return;
+    }
+  }
+}
+
+std::chrono::microseconds TimeActions(
+  const std::size_t count,
+  const std::function<Task<>(std::stop_token)>& run) {
+  std::vector<ActionScheduler::Action> actions;
+  for (std::size_t i = 0; i < count; ++i) {
+    actions.push_back({.mName = "Benchmark", .mRun = run});
+  }
+  ActionScheduler scheduler {std::move(actions)};
+  const auto start = Clock::now();
+  const auto results = scheduler.Run();
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+    Clock::now() - start);
+  Check(
+    std::ranges::all_of(
+      results,
+      [](const auto& it) { return it.mOutcome == Outcome::Succeeded; }),
+    "Benchmark action failed");
+  return elapsed;
+}
+
+Task<> WaitForTimer(Timer& timer) {
+  co_await timer.Sleep(ActionDuration);
+}
+
+Task<> BlockPoolThread() {
+  co_await ThreadPool::GetShared().Schedule();
+  std::this_thread::sleep_for(ActionDuration);
+}
+
+// Waiting actions don't hold threads, so they all wait at once
+void BenchmarkTimerActions(Timer& timer) {
+  const auto elapsed = TimeActions(
+    TimerActionCount,
+    [&timer](std::stop_token) { return WaitForTimer(timer); });
+  // One at a time, these would take 50s; generous for sanitizer builds
+  Check(
+    elapsed < ActionDuration * 20,
+    std::format("Timer-driven actions took {}us", elapsed.count()));
+  std::cout << std::format(
+    "{} timer-driven actions of {}ms: {}us\n",
+    TimerActionCount,
+    ActionDuration.count(),
+    elapsed.count());
+}
+
+// Blocking actions are limited by the number of pool threads
+void BenchmarkBlockingActions() {
+  const auto threadCount = ThreadPool::GetShared().GetThreadCount();
+  const auto elapsed = TimeActions(
+    BlockingActionCount, [](std::stop_token) { return BlockPoolThread(); });
+  const auto batches = (BlockingActionCount + threadCount - 1) / threadCount;
+  Check(
+    elapsed < ActionDuration * (batches + 2),
+    std::format("Blocking actions took {}us", elapsed.count()));
+  std::cout << std::format(
+    "{} blocking actions of {}ms on {} pool threads: {}us\n",
+    BlockingActionCount,
+    ActionDuration.count(),
+    threadCount,
+    elapsed.count());
+}
+}// namespace
+
+int main() {
+  Timer timer;
+  TestNesting();
+  TestExceptions();
+  TestCancellation(timer);
+  TestStress(timer);
+  BenchmarkTimerActions(timer);
+  BenchmarkBlockingActions();
+  return gFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}